@@ -0,0 +1,45 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <mygl/PlaneGenerator.hpp>
+#include <mygl/MeshOptimizer.hpp>
+
+using namespace mygl;
+
+void printStatistics(const std::string & label, const VertexCacheStatistics & statistics)
+{
+    std::cout << label << ": ACMR " << statistics.acmr << ", ATVR " << statistics.atvr
+        << " (" << statistics.vertices_transformed << " transformed vertices)" << std::endl;
+}
+
+/**
+ * Reports the vertex cache efficiency of a tessellated plane before and after the mesh optimization.
+ * The triangles are shuffled first to resemble the unordered output of an exporter.
+ * 
+ * usage: meshopt [tesselation]
+ */
+int main(int argc, char ** argv)
+{
+    unsigned int tesselation = argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 255;
+
+    PlaneGenerator generator;
+    auto data = generator.create(glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(1.f, 0.f, 0.f), 10.f, tesselation, 1.f);
+
+    std::vector<GLuint> & indices = data->indices.value();
+    std::vector<size_t> triangles(indices.size() / 3);
+    for (size_t t = 0; t < triangles.size(); t++) triangles[t] = t;
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(42));
+    std::vector<GLuint> shuffled;
+    shuffled.reserve(indices.size());
+    for (size_t t : triangles) shuffled.insert(shuffled.end(), indices.begin() + t * 3, indices.begin() + t * 3 + 3);
+    indices = std::move(shuffled);
+
+    std::cout << data->vertices.size() << " vertices, " << indices.size() / 3 << " triangles" << std::endl;
+    MeshOptimizationReport report = optimizeMesh(*data);
+    printStatistics("before", report.before);
+    printStatistics("after ", report.after);
+
+    return 0;
+}
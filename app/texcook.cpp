@@ -0,0 +1,101 @@
+#include <array>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <mygl/ChannelPacking.hpp>
+#include <mygl/TextureCompression.hpp>
+
+using namespace mygl;
+
+/**
+ * Cooks an image file into a block compressed texture file with a precomputed mipmap chain,
+ * which Texture uploads without decoding and without generating mipmaps. The mipmaps are box filtered unless
+ * 'kaiser' is given, which keeps the smaller levels sharper.
+ * 
+ * usage: texcook <input> <output.mygt> [bc1|bc3|bc4|bc5|bc7] [color|linear|normal] [srgb] [kaiser]
+ * 
+ * The pack mode combines the scalar maps of a material into one texture file with the channels ao, roughness, metallic
+ * and height (e.g. 'tiles_marble_orm.mygt'), '-' uses the default value of a channel.
+ * 
+ * usage: texcook pack <ao|-> <roughness|-> <metallic|-> <height|-> <output.mygt> [bc3|bc7]
+ */
+int main(int argc, char ** argv)
+{
+    static const std::map<std::string, TextureBlockFormat> formats = {
+        { "bc1", TextureBlockFormat::BC1 }, { "bc3", TextureBlockFormat::BC3 }, { "bc4", TextureBlockFormat::BC4 },
+        { "bc5", TextureBlockFormat::BC5 }, { "bc7", TextureBlockFormat::BC7 }
+    };
+    static const std::map<std::string, TextureContent> contents = {
+        { "color", TextureContent::Color }, { "linear", TextureContent::Linear }, { "normal", TextureContent::Normal }
+    };
+
+    if (argc > 1 && std::string(argv[1]) == "pack") {
+        if (argc < 7) {
+            std::cout << "usage: texcook pack <ao|-> <roughness|-> <metallic|-> <height|-> <output" << TEXTURE_FILE_EXTENSION << "> [bc3|bc7]" << std::endl;
+            return 1;
+        }
+        std::array<std::string, 4> inputs;
+        for (size_t c = 0; c < 4; c++) inputs[c] = std::string(argv[2 + c]) == "-" ? "" : argv[2 + c];
+
+        // the height needs the alpha channel
+        TextureCookOptions options;
+        options.content = TextureContent::Linear;
+        if (argc > 7) {
+            auto format = formats.find(argv[7]);
+            if (format == formats.end() || (format->second != TextureBlockFormat::BC3 && format->second != TextureBlockFormat::BC7)) {
+                std::cout << "unsupported format " << argv[7] << std::endl;
+                return 1;
+            }
+            options.format = format->second;
+        }
+
+        try {
+            packChannelFiles(inputs, argv[6], options);
+        } catch (const std::runtime_error &) {
+            return 1;
+        }
+        std::cout << "packed into " << argv[6] << std::endl;
+        return 0;
+    }
+
+    if (argc < 3) {
+        std::cout << "usage: texcook <input> <output" << TEXTURE_FILE_EXTENSION << "> [bc1|bc3|bc4|bc5|bc7] [color|linear|normal] [srgb] [kaiser]" << std::endl;
+        return 1;
+    }
+
+    TextureCookOptions options;
+    if (argc > 3) {
+        auto format = formats.find(argv[3]);
+        if (format == formats.end()) {
+            std::cout << "unknown format " << argv[3] << std::endl;
+            return 1;
+        }
+        options.format = format->second;
+    }
+    if (argc > 4) {
+        auto content = contents.find(argv[4]);
+        if (content == contents.end()) {
+            std::cout << "unknown content " << argv[4] << std::endl;
+            return 1;
+        }
+        options.content = content->second;
+    }
+    for (int a = 5; a < argc; a++) {
+        const std::string flag = argv[a];
+        if (flag == "srgb") options.srgb = true;
+        else if (flag == "kaiser") options.mip_filter = MipFilter::Kaiser;
+        else {
+            std::cout << "unknown flag " << flag << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        cookTextureFile(argv[1], argv[2], options);
+    } catch (const std::runtime_error &) {
+        return 1;
+    }
+    std::cout << "cooked " << argv[1] << " into " << argv[2] << std::endl;
+    return 0;
+}
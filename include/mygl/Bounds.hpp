@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace mygl {
+	struct Bounds;
+}
+
+/**
+ * @brief An axis aligned bounding box together with a bounding sphere around its center.
+ *
+ */
+struct mygl::Bounds {
+	glm::vec3 min = glm::vec3(0.f);
+	glm::vec3 max = glm::vec3(0.f);
+	glm::vec3 center = glm::vec3(0.f);
+	float radius = 0.f;
+};
+
+namespace mygl {
+
+/**
+ * @brief Calculates the bounding box and bounding sphere of a point set on multiple threads.
+ *
+ * @param positions the points
+ * @return Bounds the bounds (all zero for an empty point set)
+ */
+Bounds calculateBounds(const std::vector<glm::vec3> & positions);
+
+}
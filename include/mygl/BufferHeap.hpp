@@ -0,0 +1,213 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <typeindex>
+#include <vector>
+#include <glad/gl.h>
+
+namespace mygl {
+	struct BufferAllocation;
+	struct BufferHeapStatistics;
+	class BufferHeap;
+}
+
+/**
+ * @brief A range of a buffer page that was handed out by a BufferHeap.
+ *
+ */
+struct mygl::BufferAllocation {
+	/**
+	 * @brief The index of the page and the OpenGL buffer that contains the range.
+	 * Both can change during defragmentation, so they have to be looked up before every use.
+	 */
+	uint32_t page = 0;
+	GLuint buffer = 0;
+
+	size_t offset = 0;
+	size_t size = 0;
+	size_t alignment = 1;
+	bool live = false;
+};
+
+/**
+ * @brief The usage of a BufferHeap.
+ *
+ */
+struct mygl::BufferHeapStatistics {
+	size_t page_count = 0;
+	size_t reserved_bytes = 0;
+	size_t used_bytes = 0;
+	size_t allocation_count = 0;
+	size_t free_block_count = 0;
+	size_t largest_free_block = 0;
+
+	/**
+	 * @brief The share of free memory that is not part of the largest free block of its page, between 0 and 1.
+	 *
+	 */
+	float fragmentation = 0.f;
+
+	size_t defragmentation_count = 0;
+	size_t moved_bytes = 0;
+};
+
+/**
+ * @brief Carves a few large OpenGL buffers (pages) up into allocations for vertices and indices.
+ *
+ * Thousands of small meshes share a handful of buffer objects and vertex arrays instead of owning three GL objects
+ * each. Every page keeps its free blocks ordered by offset for coalescing and indexed by size for best fit lookups.
+ * Allocations are addressed by handles, so that defragmentation can move them without invalidating their owners.
+ * All methods require a current OpenGL context. The destructor deletes no OpenGL objects, since the shared heap is
+ * destroyed after the context; call 'release' while the context still exists.
+ */
+class mygl::BufferHeap {
+public:
+	typedef uint32_t Handle;
+	static const Handle INVALID_HANDLE = std::numeric_limits<Handle>::max();
+
+	/**
+	 * @brief Construct a new BufferHeap object.
+	 *
+	 * @param page_size the size of a page in bytes, larger allocations get a page of their own
+	 */
+	BufferHeap(size_t page_size = DEFAULT_PAGE_SIZE);
+	~BufferHeap() {}
+
+	BufferHeap(const BufferHeap &) = delete;
+	BufferHeap & operator = (const BufferHeap &) = delete;
+
+	/**
+	 * @brief Returns the heap that is shared by all SceneMesh objects.
+	 *
+	 * @return BufferHeap& the shared heap
+	 */
+	static BufferHeap & getInstance();
+
+	/**
+	 * @brief Allocates a range of memory.
+	 *
+	 * @param size the size in bytes
+	 * @param alignment the alignment of the offset in bytes, does not have to be a power of two (e.g. a vertex stride)
+	 * @return Handle the handle of the allocation
+	 */
+	Handle allocate(size_t size, size_t alignment = 4);
+
+	/**
+	 * @brief Returns an allocation to its page. INVALID_HANDLE is ignored.
+	 *
+	 * Pages without allocations are released, except for the last one, so that a single mesh that is created and
+	 * destroyed repeatedly does not create a new page every time.
+	 *
+	 * @param handle the handle of the allocation
+	 */
+	void free(Handle handle);
+
+	/**
+	 * @brief Deletes all pages and their vertex arrays, e.g. before the OpenGL context is destroyed.
+	 *
+	 * All handles become invalid, freeing them afterwards is ignored.
+	 */
+	void release();
+
+	/**
+	 * @brief Returns the current location of an allocation.
+	 *
+	 * @param handle the handle of a live allocation
+	 * @return const BufferAllocation& the allocation
+	 */
+	const BufferAllocation & get(Handle handle) const;
+
+	/**
+	 * @brief Copies data into an allocation.
+	 *
+	 * @param handle the handle of the allocation
+	 * @param offset the byte offset inside of the allocation
+	 * @param source the data
+	 * @param size the number of bytes
+	 */
+	void upload(Handle handle, size_t offset, const void * source, size_t size);
+
+	/**
+	 * @brief Copies data from an allocation back into memory. Waits until the GPU has written the range.
+	 *
+	 * @param handle the handle of the allocation
+	 * @param offset the byte offset inside of the allocation
+	 * @param target receives the data
+	 * @param size the number of bytes
+	 */
+	void download(Handle handle, size_t offset, void * target, size_t size) const;
+
+	/**
+	 * @brief Maps an allocation for writing. The previous content becomes undefined.
+	 *
+	 * @param handle the handle of the allocation
+	 * @return void* the mapped memory or nullptr, has to be released with 'unmap'
+	 */
+	void * map(Handle handle);
+	void unmap(Handle handle);
+
+	/**
+	 * @brief Compacts fragmented pages and releases empty ones.
+	 *
+	 * A page is compacted by copying its allocations, tightly packed, into a new buffer on the GPU. Buffers and vertex
+	 * arrays of the compacted pages change, the handles stay valid.
+	 *
+	 * @param max_moved_bytes the maximum number of bytes that are copied, pages that exceed the budget are skipped
+	 * @return size_t the number of bytes that were copied
+	 */
+	size_t defragment(size_t max_moved_bytes = std::numeric_limits<size_t>::max());
+
+	/**
+	 * @brief Returns the vertex array of a page for the vertex format T.
+	 *
+	 * The vertex array sources its vertices and indices from the page buffer, meshes select their range with the base
+	 * vertex and the index offset. It is created on first use and recreated after the page was compacted.
+	 *
+	 * @param page the index of the page
+	 * @return GLuint the vertex array
+	 */
+	template <typename T>
+	GLuint getVertexArray(uint32_t page)
+	{
+		GLuint & vertex_array = this->pages[page].vertex_arrays[std::type_index(typeid(T))];
+		if (vertex_array == 0) {
+			glGenVertexArrays(1, &vertex_array);
+			glBindVertexArray(vertex_array);
+			glBindBuffer(GL_ARRAY_BUFFER, this->pages[page].buffer);
+			T::registerFormat();
+			glVertexArrayElementBuffer(vertex_array, this->pages[page].buffer);
+			glBindVertexArray(0);
+		}
+		return vertex_array;
+	}
+
+	BufferHeapStatistics getStatistics() const;
+
+	static const size_t DEFAULT_PAGE_SIZE = 32 << 20;
+
+private:
+	struct Page {
+		GLuint buffer = 0;
+		size_t size = 0;
+		size_t used = 0;
+		size_t allocation_count = 0;
+		std::map<size_t, size_t> free_by_offset;
+		std::multimap<size_t, size_t> free_by_size;
+		std::map<std::type_index, GLuint> vertex_arrays;
+	};
+
+	size_t page_size;
+	std::vector<Page> pages;
+	std::vector<BufferAllocation> allocations;
+	std::vector<Handle> free_handles;
+	size_t defragmentation_count = 0;
+	size_t moved_bytes = 0;
+
+	uint32_t createPage(size_t size);
+	void releasePage(Page & page);
+	bool allocateFromPage(uint32_t page_index, size_t size, size_t alignment, size_t & offset);
+	void insertFreeBlock(Page & page, size_t offset, size_t size);
+	void eraseFreeBlock(Page & page, std::map<size_t, size_t>::iterator block);
+};
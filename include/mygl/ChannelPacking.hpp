@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <mygl/Material.hpp>
+#include <mygl/TextureCompression.hpp>
+
+namespace mygl {
+	/**
+	 * @brief The channels of a packed texture, which is the occlusion-roughness-metallic layout of glTF with the height
+	 * in alpha. The shader reads the channel of every scalar property from 'material.<property>.channel'.
+	 *
+	 */
+	static const uint32_t PACKED_AO_CHANNEL = 0;
+	static const uint32_t PACKED_ROUGHNESS_CHANNEL = 1;
+	static const uint32_t PACKED_METALLIC_CHANNEL = 2;
+	static const uint32_t PACKED_HEIGHT_CHANNEL = 3;
+
+	/**
+	 * @brief The property name of packed textures on disk, e.g. 'tiles_marble_orm.mygt' (see Material::loadTextures).
+	 *
+	 */
+	static const std::string PACKED_PROPERTY_NAME = "orm";
+
+	struct ChannelSource;
+}
+
+/**
+ * @brief A single channel of an image that is packed into a channel of another image.
+ *
+ */
+struct mygl::ChannelSource {
+	const unsigned char * rgba = nullptr;
+	int width = 0;
+	int height = 0;
+	uint32_t channel = 0;
+};
+
+namespace mygl {
+
+/**
+ * @brief Combines single channels of up to four images into one image.
+ *
+ * Sources of another size are resampled bilinearly.
+ *
+ * @param sources the source of every channel of the result, channels without rgba data get their default value
+ * @param width the width of the result
+ * @param height the height of the result
+ * @param defaults the values of the channels without source
+ * @return std::vector<unsigned char> the image with 4 bytes per texel
+ */
+std::vector<unsigned char> packChannels(const std::array<ChannelSource, 4> & sources, int width, int height, const glm::vec4 & defaults);
+
+/**
+ * @brief Packs the textures of the ao, roughness, metallic and height properties of a material into one texture,
+ * and the opacity texture into the alpha channel of a copy of the albedo texture.
+ *
+ * Every texture is read back from video memory, so all textures must be loaded completely; streamed textures are not
+ * packed. Properties without texture keep their default value. The material then binds and samples one texture instead
+ * of up to four, which also occupies a quarter of their memory.
+ *
+ * @param material the material
+ * @return size_t the number of textures that the material no longer binds
+ */
+size_t packMaterialChannels(Material & material);
+
+/**
+ * @brief Packs the scalar maps of a material offline into a block compressed texture file with the packed channel
+ * layout, which Material::loadTextures prefers over the separate files.
+ *
+ * @param inputs the image files of ao, roughness, metallic and height, empty paths use the default value
+ * @param output the path of the texture file
+ * @param options the compression, the content should be TextureContent::Linear and the format needs alpha for the height
+ * @param defaults the values of the channels without image, the defaults of Material
+ */
+void packChannelFiles(const std::array<std::string, 4> & inputs, const std::string & output, const TextureCookOptions & options,
+	const glm::vec4 & defaults = glm::vec4(1.f, 0.3f, 0.f, 1.f));
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <glad/gl.h>
+#include <array>
 #include <stdexcept>
 #include <optional>
 #include <iostream>
@@ -39,16 +40,37 @@ class mygl::FrameBuffer
 {
 public:
     FrameBuffer(FrameBufferConfiguration & config, ScreenResolution & screen_res);
+
+    /**
+     * @brief Creates a framebuffer that renders into existing textures, which it does not delete (e.g. the aliased
+     * targets of a RenderGraph).
+     * 
+     * @param color_textures the textures of the color attachments in attachment order
+     * @param depth_texture a texture with a depth format, if any
+     * @param depth_attachment GL_DEPTH_ATTACHMENT or GL_DEPTH_STENCIL_ATTACHMENT for the depth texture
+     */
+    FrameBuffer(const std::vector<GLuint> & color_textures, std::optional<GLuint> depth_texture = std::nullopt,
+        GLenum depth_attachment = GL_DEPTH_ATTACHMENT);
     ~FrameBuffer();
 
     void use();
     GLuint getID();
     GLuint getColorBufferID(size_t idx);
+
+    /**
+     * @brief Binds a color attachment with a linear, clamping sampler to an OpenGL texture unit.
+     * 
+     * @param idx the index of the color attachment
+     * @param textureUnit the texture unit to bind the attachment to
+     */
+    void bindColorBuffer(size_t idx, GLenum textureUnit);
+
     void setDebugName(const std::string name);
     std::string getDebugName();
 private:
     GLuint ID;
     std::vector<GLuint> texture_color_buffer_IDs;
     std::optional<GLuint> RBO = std::nullopt;
+    bool owns_attachments = true;
     std::string debug_name;
 };
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glad/gl.h>
+
+namespace mygl {
+	struct IndexChunk;
+
+	/**
+	 * @brief The index that restarts a strip or fan inside of 32 bit index data (see GL_PRIMITIVE_RESTART_FIXED_INDEX).
+	 *
+	 */
+	static const GLuint RESTART_INDEX = 0xFFFFFFFF;
+
+	/**
+	 * @brief The largest number of vertices that can be addressed by 16 bit indices.
+	 * The largest value (0xFFFF) is reserved as restart index.
+	 */
+	static const size_t MAX_VERTICES_16BIT = 0xFFFF;
+}
+
+/**
+ * @brief A range of an index buffer that is drawn with a single draw call.
+ *
+ */
+struct mygl::IndexChunk {
+	/**
+	 * @brief The first index of the chunk inside of the index buffer.
+	 *
+	 */
+	size_t index_offset = 0;
+
+	/**
+	 * @brief The number of indices of the chunk.
+	 *
+	 */
+	size_t index_count = 0;
+
+	/**
+	 * @brief The value that is added to every index of the chunk (see glDrawElementsBaseVertex).
+	 *
+	 */
+	GLint base_vertex = 0;
+};
+
+namespace mygl {
+
+/**
+ * @brief Returns the smallest index type that can address the given number of vertices.
+ *
+ * @param vertex_count the number of vertices
+ * @return GLenum GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+ */
+GLenum chooseIndexType(size_t vertex_count);
+
+/**
+ * @brief Returns the size of a single index in bytes.
+ *
+ * @param index_type GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+ * @return size_t the size in bytes
+ */
+size_t getIndexSize(GLenum index_type);
+
+/**
+ * @brief Converts 32 bit indices into 16 bit indices. Restart indices are converted as well.
+ *
+ * @param indices the indices, which all have to be smaller than MAX_VERTICES_16BIT or equal to RESTART_INDEX
+ * @return std::vector<GLushort> the converted indices
+ */
+std::vector<GLushort> packIndices16(const std::vector<GLuint> & indices);
+
+/**
+ * @brief Splits a triangle list into chunks that can each be addressed with 16 bit indices.
+ *
+ * Every chunk gets its own, contiguous range of vertices, so vertices that are used by several chunks are duplicated.
+ *
+ * @param indices the indices of the triangles (always a multiple of 3)
+ * @param out_vertex_order receives the original vertex index for every vertex of the chunked vertex buffer
+ * @param out_indices receives the chunk-relative 16 bit indices
+ * @return std::vector<IndexChunk> the chunks, whose base vertex points to the first vertex of the chunk
+ */
+std::vector<IndexChunk> splitIndices16(const std::vector<GLuint> & indices, std::vector<GLuint> & out_vertex_order, std::vector<GLushort> & out_indices);
+
+/**
+ * @brief Returns whether a primitive type is drawn as connected strips or fans that may use restart indices.
+ *
+ * @param geometry_type the OpenGL primitive type
+ * @return true for strips, loops and fans
+ * @return false else
+ */
+bool isStripGeometry(GLenum geometry_type);
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mygl {
+	class JsonValue;
+}
+
+/**
+ * @brief A value of a JSON document, e.g. the description of a glTF asset.
+ *
+ * Only the parsing direction is supported. Missing members and out of range elements return a null value, so lookups
+ * can be chained without checks.
+ */
+class mygl::JsonValue {
+public:
+	enum class Type { Null, Bool, Number, String, Array, Object };
+
+	JsonValue();
+
+	/**
+	 * @brief Parses a JSON document.
+	 *
+	 * @param text the UTF-8 encoded document
+	 * @param length the length of the document in bytes
+	 * @return JsonValue the root value
+	 */
+	static JsonValue parse(const char * text, size_t length);
+	static JsonValue parse(const std::string & text);
+
+	Type getType() const;
+	bool isNull() const;
+	bool isNumber() const;
+	bool isString() const;
+	bool isArray() const;
+	bool isObject() const;
+
+	/**
+	 * @brief Returns whether an object has the given member.
+	 *
+	 * @param key the name of the member
+	 * @return true if the member exists
+	 * @return false else
+	 */
+	bool has(const std::string & key) const;
+
+	/**
+	 * @brief Returns a member of an object.
+	 *
+	 * @param key the name of the member
+	 * @return const JsonValue& the member or a null value
+	 */
+	const JsonValue & operator [] (const std::string & key) const;
+
+	/**
+	 * @brief Returns an element of an array.
+	 *
+	 * @param index the position of the element
+	 * @return const JsonValue& the element or a null value
+	 */
+	const JsonValue & operator [] (size_t index) const;
+
+	/**
+	 * @brief Returns the number of elements of an array or members of an object.
+	 *
+	 * @return size_t the size (0 for other types)
+	 */
+	size_t size() const;
+
+	double asNumber(double fallback = 0.0) const;
+	int asInt(int fallback = 0) const;
+	bool asBool(bool fallback = false) const;
+	std::string asString(const std::string & fallback = "") const;
+	const std::map<std::string, JsonValue> & getMembers() const;
+
+private:
+	Type type = Type::Null;
+	bool boolean = false;
+	double number = 0.0;
+	std::string string;
+	std::vector<JsonValue> array;
+	std::map<std::string, JsonValue> object;
+
+	friend class JsonParser;
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <iterator>
 #include <map>
@@ -7,6 +9,8 @@
 #include <memory>
 
 #include <mygl/Texture.hpp>
+#include <mygl/TextureLoader.hpp>
+#include <mygl/TextureStreamer.hpp>
 
 namespace mygl {
 	template <typename T> class MaterialProperty;
@@ -35,6 +39,13 @@ public:
 	 */
 	std::optional<std::shared_ptr<Texture>> texture;
 
+	/**
+	 * @brief The channel of the texture that stores a scalar property, so that several properties can share one packed
+	 * texture (see packMaterialChannels). The red channel (0) by default.
+	 * 
+	 */
+	uint32_t channel;
+
 	/**
 	 * @brief Construct a new MaterialProperty object.
 	 * 
@@ -72,6 +83,34 @@ public:
 	 * The specified example would evaluate to the image at the path '${DEFAULT_LIB_PATH}/tiles_marble_albedo.png'
 	 */
 	void loadTexture(std::string texture_name, std::string separator, std::string property_name, std::string fileType);
+
+	/**
+	 * @brief Schedules the loading of a texture that will be used for this property and assigns it immediately.
+	 * A missing file is not assigned, so that the property keeps its default value.
+	 * 
+	 * @param loader the loader that decodes and uploads the texture in the background
+	 * @param library the path, where the texture is stored (relative to the executable) e.g. '../textures/')
+	 * @param texture_name the name of the used image (e.g. 'tiles_marble')
+	 * @param separator separates the properties from the name of the image (e.g. '_')
+	 * @param property_name the name of the property (e.g. 'albedo')
+	 * @param fileType the type (e.g. '.png') of the file
+	 * @param placeholder the color that is shown until the texture is uploaded or if it cannot be loaded
+	 */
+	void loadTexture(TextureLoader & loader, std::string library, std::string texture_name, std::string separator, std::string property_name,
+		std::string fileType, const glm::vec4 & placeholder);
+
+	/**
+	 * @brief Loads a streamed texture that will be used for this property (see TextureStreamer).
+	 * 
+	 * @param streamer the streamer that keeps the demanded levels of the texture resident
+	 * @param library the path, where the texture is stored (relative to the executable) e.g. '../textures/')
+	 * @param texture_name the name of the used image (e.g. 'tiles_marble')
+	 * @param separator separates the properties from the name of the image (e.g. '_')
+	 * @param property_name the name of the property (e.g. 'albedo')
+	 * @param fileType the type (e.g. 'mygt') of the file
+	 */
+	void loadTexture(TextureStreamer & streamer, std::string library, std::string texture_name, std::string separator, std::string property_name,
+		std::string fileType);
 private:
 	static const char period = '.';
 };
@@ -96,6 +135,13 @@ public:
 	 */
 	float height_scale;
 
+	/**
+	 * @brief Maps the texture coordinates onto the region of the material inside of an atlas page:
+	 * uv * uv_transform.xy + uv_transform.zw. The identity (1, 1, 0, 0) unless the material was packed.
+	 * 
+	 */
+	glm::vec4 uv_transform;
+
 	/**
 	 * @brief Construct a new Material object.
 	 * 
@@ -106,6 +152,9 @@ public:
 	/**
 	 * @brief Loads all textures into memory that will be used for this material.
 	 * 
+	 * A packed texture (e.g. 'tiles_marble_orm.png', see packChannelFiles) replaces the textures of ao, roughness,
+	 * metallic and height, if it exists.
+	 * 
 	 * @param library the path, where the texture is stored (relative to the executable) e.g. '../textures/')
 	 * @param texture_name the name of the used image (e.g. 'tiles_marble')
 	 * @param separator separates the properties from the name of the image (e.g. '_')
@@ -127,9 +176,50 @@ public:
 	 * The specified example would evaluate to the image at the path '${DEFAULT_LIB_PATH}/tiles_marble_albedo.png'
 	 */
 	void loadTextures(std::string name, std::string separator, std::string fileType);
+
+	/**
+	 * @brief Schedules the loading of all textures of this material in the background.
+	 * 
+	 * Every property shows its default value until its texture is uploaded, which is also what a missing texture looks
+	 * like with the synchronous loading.
+	 * 
+	 * @param loader the loader that decodes and uploads the textures
+	 * @param library the path, where the texture is stored (relative to the executable) e.g. '../textures/')
+	 * @param texture_name the name of the used image (e.g. 'tiles_marble')
+	 * @param separator separates the properties from the name of the image (e.g. '_')
+	 * @param fileType the type (e.g. '.png') of the file
+	 */
+	void loadTextures(TextureLoader & loader, std::string library, std::string name, std::string separator, std::string fileType);
+
+	/**
+	 * @brief Loads all textures of this material as streamed textures, which start with their coarse levels.
+	 * 
+	 * @param streamer the streamer that keeps the demanded levels of the textures resident
+	 * @param library the path, where the texture is stored (relative to the executable) e.g. '../textures/')
+	 * @param texture_name the name of the used image (e.g. 'tiles_marble')
+	 * @param separator separates the properties from the name of the image (e.g. '_')
+	 * @param fileType the type (e.g. 'mygt') of the file
+	 */
+	void loadTextures(TextureStreamer & streamer, std::string library, std::string name, std::string separator, std::string fileType);
 	
 	/**
-	 * @brief Binds all textures to OpenGL texture units.
+	 * @brief Uses a texture with the packed channel layout (see PACKED_AO_CHANNEL) for ao, roughness, metallic and height.
+	 * 
+	 * @param texture the packed texture
+	 */
+	void setPackedTexture(std::shared_ptr<Texture> texture);
+
+	/**
+	 * @brief Returns the texture units of the properties in the order albedo, normal, roughness, metallic, ao, height,
+	 * opacity. Properties that share a texture share the unit of the first of them.
+	 * 
+	 * @param textureUnitsBegin the first texture unit that is currently free
+	 * @return std::array<GLuint, 7> the texture unit of every property
+	 */
+	std::array<GLuint, 7> getTextureUnits(GLuint textureUnitsBegin) const;
+
+	/**
+	 * @brief Binds all textures to OpenGL texture units (see getTextureUnits), every texture only once.
 	 * 
 	 * @param textureUnitsBegin the first texture unit that is currently free
 	 */
@@ -0,0 +1,118 @@
+#pragma once
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/Bounds.hpp>
+#include <mygl/SceneObject.hpp>
+#include <mygl/Parallel.hpp>
+
+namespace mygl {
+	struct AttributeOptions;
+	struct MeshAttributes;
+}
+
+/**
+ * @brief Selects which attributes are generated.
+ *
+ */
+struct mygl::AttributeOptions {
+	bool normals = true;
+	bool tangents = true;
+
+	/**
+	 * @brief Whether the face normals are weighted by the corner angle in addition to the face area.
+	 * Angle weighting keeps the normals of finely tessellated regions from dominating their neighbors.
+	 */
+	bool angle_weighted = true;
+};
+
+/**
+ * @brief The generated per-vertex attributes of a mesh.
+ *
+ */
+struct mygl::MeshAttributes {
+	/**
+	 * @brief The smooth normal of every vertex (empty if not requested).
+	 *
+	 */
+	std::vector<glm::vec3> normals;
+
+	/**
+	 * @brief The tangent of every vertex, orthogonal to the normal, w is the handedness (+1 or -1) of the bitangent.
+	 * The bitangent is cross(normal, tangent.xyz) * tangent.w. Empty if not requested.
+	 */
+	std::vector<glm::vec4> tangents;
+
+	Bounds bounds;
+};
+
+namespace mygl {
+
+/**
+ * @brief Generates smooth normals, tangents and bounds for an indexed triangle list.
+ *
+ * The face data is computed into flat arrays in a first pass, afterwards every vertex gathers the contributions of
+ * its adjacent triangles. Both passes run on multiple threads and never write to shared memory, so the result does not
+ * depend on the number of threads. Normals are weighted by face area (and corner angle, see AttributeOptions), tangents
+ * are accumulated, orthogonalized against the normal (Gram-Schmidt) and receive the handedness of the uv mapping.
+ *
+ * @param indices the indices of the triangles (always a multiple of 3)
+ * @param positions the position of every vertex
+ * @param uvs the uv-coordinate of every vertex (only needed for tangents)
+ * @param options the attributes to generate
+ * @param existing_normals the normals that tangents are orthogonalized against if normals are not generated (optional)
+ * @return MeshAttributes the generated attributes
+ */
+MeshAttributes generateAttributes(const std::vector<GLuint> & indices, const std::vector<glm::vec3> & positions,
+	const std::vector<glm::vec2> & uvs, const AttributeOptions & options = AttributeOptions(),
+	const std::vector<glm::vec3> * existing_normals = nullptr);
+
+/**
+ * @brief Generates smooth normals and tangents for the vertices of a triangle mesh and returns its bounds.
+ *
+ * Meshes without indices are treated as triangle soups and receive flat attributes per triangle. T needs the members
+ * position, normal, uv and tangent. If the tangent of T has no fourth component the handedness is dropped, use
+ * generateAttributes directly to obtain it.
+ *
+ * @param data the mesh data that will be modified
+ * @param options the attributes to generate
+ * @return Bounds the bounds of the mesh
+ */
+template <typename T>
+Bounds generateNormalsAndTangents(MeshData<T> & data, const AttributeOptions & options = AttributeOptions())
+{
+	const size_t vertex_count = data.vertices.size();
+	std::vector<glm::vec3> positions(vertex_count);
+	std::vector<glm::vec2> uvs(options.tangents ? vertex_count : 0);
+	std::vector<glm::vec3> normals(!options.normals && options.tangents ? vertex_count : 0);
+	parallelFor(0, vertex_count, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; v++) {
+			const T & vertex = data.vertices[v];
+			positions[v] = vertex.position;
+			if (!uvs.empty()) uvs[v] = vertex.uv;
+			if (!normals.empty()) normals[v] = vertex.normal;
+		}
+	});
+
+	MeshAttributes attributes;
+	if (data.indices.has_value()) {
+		attributes = generateAttributes(data.indices.value(), positions, uvs, options, normals.empty() ? nullptr : &normals);
+	}
+	else {
+		std::vector<GLuint> indices(vertex_count - vertex_count % 3);
+		for (size_t i = 0; i < indices.size(); i++) indices[i] = static_cast<GLuint>(i);
+		attributes = generateAttributes(indices, positions, uvs, options, normals.empty() ? nullptr : &normals);
+	}
+
+	parallelFor(0, vertex_count, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; v++) {
+			T & vertex = data.vertices[v];
+			if (!attributes.normals.empty()) vertex.normal = attributes.normals[v];
+			if (!attributes.tangents.empty()) vertex.tangent = decltype(vertex.tangent)(attributes.tangents[v]);
+		}
+	});
+	return attributes.bounds;
+}
+
+}
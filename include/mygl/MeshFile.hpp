@@ -0,0 +1,388 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/VertexFormat.hpp>
+#include <mygl/IndexFormat.hpp>
+#include <mygl/SceneObject.hpp>
+#include <mygl/Meshlet.hpp>
+#include <mygl/MeshAttributes.hpp>
+#include <mygl/MeshOptimizer.hpp>
+
+namespace mygl {
+	struct MeshFileSection;
+	struct MeshFileHeader;
+	struct MeshFileAttribute;
+	struct MeshFileLod;
+	struct MeshFileMeshlet;
+	struct MeshFileLodData;
+	struct MeshFileSource;
+	class MeshFile;
+
+	/**
+	 * @brief The first bytes of every mesh file.
+	 *
+	 */
+	static const char MESH_FILE_MAGIC[4] = { 'M', 'Y', 'G', 'M' };
+
+	/**
+	 * @brief The version of the mesh file layout, files with another version are rejected.
+	 *
+	 */
+	static const uint32_t MESH_FILE_VERSION = 1;
+
+	/**
+	 * @brief The alignment of every section inside of a mesh file in bytes.
+	 *
+	 */
+	static const uint64_t MESH_FILE_ALIGNMENT = 64;
+}
+
+/**
+ * @brief The position and size of a blob inside of a mesh file.
+ *
+ */
+struct mygl::MeshFileSection {
+	uint64_t offset = 0;
+	uint64_t size = 0;
+};
+
+/**
+ * @brief The header at the beginning of a mesh file.
+ *
+ * All members have a fixed size and all values are stored little-endian, so the header and every section can be used
+ * in place after the file was mapped into memory.
+ */
+struct mygl::MeshFileHeader {
+	char magic[4] = { 'M', 'Y', 'G', 'M' };
+	uint32_t version = MESH_FILE_VERSION;
+	uint32_t header_size = sizeof(MeshFileHeader);
+	uint32_t vertex_stride = 0;
+	uint64_t vertex_count = 0;
+
+	/**
+	 * @brief The number of indices of all levels of detail together.
+	 *
+	 */
+	uint64_t index_count = 0;
+
+	/**
+	 * @brief GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, 0 if the mesh has no indices.
+	 *
+	 */
+	uint32_t index_type = 0;
+	uint32_t geometry_type = GL_TRIANGLES;
+
+	/**
+	 * @brief Combination of the MeshFileHeader::FLAG_* values.
+	 *
+	 */
+	uint32_t flags = 0;
+	uint32_t attribute_count = 0;
+	uint32_t lod_count = 0;
+	uint32_t meshlet_count = 0;
+
+	float bounds_min[3] = { 0.f, 0.f, 0.f };
+	float bounds_max[3] = { 0.f, 0.f, 0.f };
+	float bounds_center[3] = { 0.f, 0.f, 0.f };
+	float bounds_radius = 0.f;
+
+	MeshFileSection attributes;
+	MeshFileSection vertices;
+	MeshFileSection indices;
+	MeshFileSection lods;
+	MeshFileSection meshlets;
+	MeshFileSection meshlet_vertices;
+	MeshFileSection meshlet_triangles;
+
+	static const uint32_t FLAG_PRIMITIVE_RESTART = 1;
+};
+
+/**
+ * @brief The description of a vertex attribute inside of a mesh file (see VertexAttribute).
+ *
+ */
+struct mygl::MeshFileAttribute {
+	uint32_t location = 0;
+	uint32_t component_count = 0;
+	uint32_t component_type = GL_FLOAT;
+	uint32_t normalized = 0;
+	uint32_t offset = 0;
+	uint32_t reserved = 0;
+};
+
+/**
+ * @brief A level of detail, which is a range of the index section that addresses the shared vertices.
+ *
+ */
+struct mygl::MeshFileLod {
+	uint64_t index_offset = 0;
+	uint64_t index_count = 0;
+	float error = 0.f;
+	uint32_t reserved = 0;
+};
+
+/**
+ * @brief A meshlet inside of a mesh file (see Meshlet).
+ *
+ */
+struct mygl::MeshFileMeshlet {
+	uint32_t vertex_offset = 0;
+	uint32_t vertex_count = 0;
+	uint32_t triangle_offset = 0;
+	uint32_t triangle_count = 0;
+	float center[3] = { 0.f, 0.f, 0.f };
+	float radius = 0.f;
+	float cone_axis[3] = { 0.f, 0.f, 1.f };
+	float cone_cutoff = 1.f;
+};
+
+/**
+ * @brief The indices of a level of detail that will be written into a mesh file.
+ *
+ */
+struct mygl::MeshFileLodData {
+	std::vector<GLuint> indices;
+	float error = 0.f;
+};
+
+/**
+ * @brief Everything that is written into a mesh file, see writeMeshFile.
+ *
+ */
+struct mygl::MeshFileSource {
+	std::vector<VertexAttribute> layout;
+	size_t vertex_stride = 0;
+	const void * vertices = nullptr;
+	size_t vertex_count = 0;
+
+	/**
+	 * @brief The indices of the full mesh (nullptr for non-indexed meshes).
+	 *
+	 */
+	const std::vector<GLuint> * indices = nullptr;
+	bool primitive_restart = false;
+	GLenum geometry_type = GL_TRIANGLES;
+
+	/**
+	 * @brief Additional, coarser levels of detail that use the same vertices.
+	 *
+	 */
+	const std::vector<MeshFileLodData> * lods = nullptr;
+	const MeshletData * meshlets = nullptr;
+	Bounds bounds;
+};
+
+static_assert(sizeof(mygl::MeshFileHeader) == 208, "unexpected padding in MeshFileHeader");
+static_assert(sizeof(mygl::MeshFileSection) == 16, "unexpected padding in MeshFileSection");
+static_assert(sizeof(mygl::MeshFileAttribute) == 24, "unexpected padding in MeshFileAttribute");
+static_assert(sizeof(mygl::MeshFileLod) == 24, "unexpected padding in MeshFileLod");
+static_assert(sizeof(mygl::MeshFileMeshlet) == 48, "unexpected padding in MeshFileMeshlet");
+
+/**
+ * @brief A mesh file that is mapped into memory.
+ *
+ * Opening validates the header and the section table only, the vertex and index sections are handed to OpenGL as
+ * they are. The mapping stays valid as long as the object exists.
+ */
+class mygl::MeshFile {
+public:
+	/**
+	 * @brief Maps a mesh file into memory.
+	 *
+	 * @param path the path of the file
+	 */
+	MeshFile(const std::string & path);
+	~MeshFile();
+
+	MeshFile(const MeshFile &) = delete;
+	MeshFile & operator = (const MeshFile &) = delete;
+
+	const MeshFileHeader & getHeader() const;
+
+	/**
+	 * @brief Returns the vertex layout that the file was written with.
+	 *
+	 * @return std::vector<VertexAttribute> the attributes
+	 */
+	std::vector<VertexAttribute> getLayout() const;
+
+	const void * getVertices() const;
+
+	/**
+	 * @brief Returns the indices of all levels of detail, with the size given by the index type of the header.
+	 *
+	 * @return const void* the indices or nullptr for non-indexed meshes
+	 */
+	const void * getIndices() const;
+
+	const MeshFileLod * getLods() const;
+
+	/**
+	 * @brief Returns the bounds that were stored with the mesh.
+	 *
+	 * @return Bounds the bounds
+	 */
+	Bounds getBounds() const;
+
+	/**
+	 * @brief Copies the meshlets of the file.
+	 *
+	 * @return MeshletData the meshlets (empty if the file contains none)
+	 */
+	MeshletData getMeshlets() const;
+
+	/**
+	 * @brief Returns whether the vertices of the file have the layout of T.
+	 *
+	 * @return true if the vertices can be used as T
+	 * @return false else
+	 */
+	template <typename T>
+	bool matchesLayout() const
+	{
+		std::vector<VertexAttribute> expected = T::getLayout();
+		std::vector<VertexAttribute> actual = getLayout();
+		if (getHeader().vertex_stride != sizeof(T) || expected.size() != actual.size()) return false;
+		for (size_t a = 0; a < expected.size(); a++) {
+			if (expected[a].location != actual[a].location || expected[a].component_count != actual[a].component_count
+				|| expected[a].component_type != actual[a].component_type || expected[a].normalized != actual[a].normalized
+				|| expected[a].offset != actual[a].offset) return false;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Copies a level of detail into mesh data, for meshes that have to be processed on the CPU.
+	 *
+	 * @param lod the level of detail (0 is the full mesh)
+	 * @return std::shared_ptr<MeshData<T>> the mesh data
+	 */
+	template <typename T>
+	std::shared_ptr<MeshData<T>> toMeshData(unsigned int lod = 0) const
+	{
+		requireLayout<T>();
+		const MeshFileHeader & header = getHeader();
+		std::shared_ptr<MeshData<T>> data(new MeshData<T>());
+		const T * vertices = static_cast<const T*>(getVertices());
+		data->vertices.assign(vertices, vertices + header.vertex_count);
+		data->primitive_restart = (header.flags & MeshFileHeader::FLAG_PRIMITIVE_RESTART) != 0;
+		if (header.index_type == 0) return data;
+
+		const MeshFileLod & range = getLod(lod);
+		std::vector<GLuint> indices(range.index_count);
+		if (header.index_type == GL_UNSIGNED_SHORT) {
+			const GLushort * source = static_cast<const GLushort*>(getIndices()) + range.index_offset;
+			for (size_t i = 0; i < indices.size(); i++) indices[i] = source[i] == 0xFFFF ? RESTART_INDEX : source[i];
+		}
+		else {
+			const GLuint * source = static_cast<const GLuint*>(getIndices()) + range.index_offset;
+			std::memcpy(indices.data(), source, sizeof(GLuint) * indices.size());
+		}
+		data->indices = std::move(indices);
+		return data;
+	}
+
+	/**
+	 * @brief Uploads a level of detail straight from the mapped file into a new static mesh with the bounds of the file.
+	 *
+	 * @param lod the level of detail (0 is the full mesh)
+	 * @param material the material of the mesh
+	 * @return std::shared_ptr<SceneMesh<T>> the mesh
+	 */
+	template <typename T>
+	std::shared_ptr<SceneMesh<T>> createSceneMesh(unsigned int lod = 0,
+		std::shared_ptr<Material> material = std::shared_ptr<Material>(new Material())) const
+	{
+		requireLayout<T>();
+		const MeshFileHeader & header = getHeader();
+		const T * vertices = static_cast<const T*>(getVertices());
+		const bool primitive_restart = (header.flags & MeshFileHeader::FLAG_PRIMITIVE_RESTART) != 0;
+		std::shared_ptr<SceneMesh<T>> mesh;
+		if (header.index_type == 0) {
+			mesh = std::shared_ptr<SceneMesh<T>>(new SceneMesh<T>(vertices, header.vertex_count, nullptr, 0, GL_UNSIGNED_INT,
+				header.geometry_type, material));
+		}
+		else {
+			const MeshFileLod & range = getLod(lod);
+			const unsigned char * indices = static_cast<const unsigned char*>(getIndices()) + range.index_offset * getIndexSize(header.index_type);
+			mesh = std::shared_ptr<SceneMesh<T>>(new SceneMesh<T>(vertices, header.vertex_count, indices, range.index_count,
+				header.index_type, header.geometry_type, material, primitive_restart));
+		}
+		// the mesh keeps no CPU data, the bounds of the file cover all levels of detail
+		mesh->setBounds(getBounds());
+		return mesh;
+	}
+
+private:
+	const unsigned char * mapped = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	void * file_handle = nullptr;
+	void * mapping_handle = nullptr;
+#else
+	int file_descriptor = -1;
+#endif
+
+	void validate(const std::string & path) const;
+	void unmap();
+	const MeshFileLod & getLod(unsigned int lod) const;
+
+	template <typename T>
+	void requireLayout() const
+	{
+		if (!matchesLayout<T>()) {
+			throw std::runtime_error("the vertex layout of the mesh file does not match the vertex format");
+		}
+	}
+};
+
+namespace mygl {
+
+/**
+ * @brief Writes a mesh file.
+ *
+ * Indices are stored with 16 bit whenever the vertex count allows it. Every section starts at a multiple of
+ * MESH_FILE_ALIGNMENT, so that it can be used in place after mapping the file.
+ *
+ * @param path the path of the file
+ * @param source the content of the file
+ */
+void writeMeshFile(const std::string & path, const MeshFileSource & source);
+
+/**
+ * @brief Writes mesh data into a mesh file.
+ *
+ * T has to provide its attributes with a static getLayout function (see VertexFormat).
+ *
+ * @param path the path of the file
+ * @param data the mesh data
+ * @param geometry_type the OpenGL primitive type of the mesh
+ * @param lods additional levels of detail that use the vertices of data (e.g. created with simplifyIndices)
+ * @param meshlets the meshlets of the mesh (optional)
+ */
+template <typename T>
+void writeMeshFile(const std::string & path, const MeshData<T> & data, GLenum geometry_type = GL_TRIANGLES,
+	const std::vector<MeshFileLodData> & lods = {}, const MeshletData * meshlets = nullptr)
+{
+	MeshFileSource source;
+	source.layout = T::getLayout();
+	source.vertex_stride = sizeof(T);
+	source.vertices = data.vertices.data();
+	source.vertex_count = data.vertices.size();
+	source.indices = data.indices.has_value() ? &data.indices.value() : nullptr;
+	source.primitive_restart = data.primitive_restart;
+	source.geometry_type = geometry_type;
+	source.lods = &lods;
+	source.meshlets = meshlets;
+	source.bounds = calculateBounds(extractPositions(data));
+	writeMeshFile(path, source);
+}
+
+}
@@ -0,0 +1,255 @@
+#pragma once
+#include <memory>
+#include <span>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/Bounds.hpp>
+#include <mygl/VertexFormat.hpp>
+#include <mygl/SceneObject.hpp>
+#include <mygl/Material.hpp>
+
+namespace mygl {
+	struct GeometryCounts;
+	class MeshGenerator;
+	class PlaneMeshGenerator;
+	class BoxMeshGenerator;
+	class SphereMeshGenerator;
+	class CylinderMeshGenerator;
+	class TorusMeshGenerator;
+	class HeightfieldMeshGenerator;
+}
+
+/**
+ * @brief The exact number of vertices and indices of a generated mesh.
+ *
+ */
+struct mygl::GeometryCounts {
+	size_t vertex_count = 0;
+	size_t index_count = 0;
+};
+
+/**
+ * @brief The base of all procedural generators for indexed triangle meshes.
+ *
+ * A generator knows its exact vertex and index counts up front and writes its geometry on multiple threads into memory
+ * that is provided by the caller, e.g. the mapped allocation of a SceneMesh, so no intermediate copy is needed.
+ */
+class mygl::MeshGenerator {
+public:
+	virtual ~MeshGenerator();
+
+	/**
+	 * @brief Returns the number of vertices and indices that 'generate' writes.
+	 *
+	 * @return GeometryCounts the exact counts
+	 */
+	virtual GeometryCounts getCounts() const = 0;
+
+	/**
+	 * @brief Returns the bounds of the geometry that 'generate' writes, which are known without generating it.
+	 *
+	 * @return Bounds the bounds
+	 */
+	virtual Bounds getBounds() const = 0;
+
+	/**
+	 * @brief Writes the geometry into the given memory.
+	 *
+	 * @param vertices memory for exactly getCounts().vertex_count vertices
+	 * @param indices memory for exactly getCounts().index_count indices, 16 bit indices require at most 65536 vertices
+	 */
+	virtual void generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const = 0;
+	virtual void generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const = 0;
+
+	/**
+	 * @brief Generates the geometry into new mesh data.
+	 *
+	 * @return std::shared_ptr<MeshData<VertexFormat>> the indexed triangle list
+	 */
+	std::shared_ptr<MeshData<VertexFormat>> createMeshData() const;
+
+	/**
+	 * @brief Generates the geometry directly into the buffer allocation of a new static mesh.
+	 *
+	 * The mesh keeps no CPU copy of the geometry (see the raw SceneMesh constructor), its bounds are set from getBounds.
+	 *
+	 * @param material the material that defines the appearance of the mesh
+	 * @return std::shared_ptr<SceneMesh<VertexFormat>> the mesh
+	 */
+	std::shared_ptr<SceneMesh<VertexFormat>> createSceneMesh(std::shared_ptr<Material> material = std::shared_ptr<Material>(new Material())) const;
+
+protected:
+	/**
+	 * @brief Throws if the provided memory does not match the counts of the generator.
+	 *
+	 */
+	void checkSpans(size_t vertex_count, size_t index_count) const;
+};
+
+/**
+ * @brief A square plane that is subdivided into a regular grid.
+ *
+ */
+class mygl::PlaneMeshGenerator : public MeshGenerator {
+public:
+	/**
+	 * @brief Construct a new PlaneMeshGenerator object.
+	 *
+	 * @param center the origin of the plane
+	 * @param normal the surface normal of the plane
+	 * @param direction one axis direction of the plane
+	 * @param side_length the length of all four sides of the plane
+	 * @param tesselation how many subdivisions the plane consists of
+	 * @param uv_scaling a factor for the uv-coordinates
+	 */
+	PlaneMeshGenerator(glm::vec3 center, glm::vec3 normal, glm::vec3 direction, float side_length, unsigned int tesselation, float uv_scaling = 1.f);
+
+	GeometryCounts getCounts() const override;
+	Bounds getBounds() const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const override;
+
+private:
+	glm::vec3 center, normal, direction;
+	float side_length;
+	unsigned int tesselation;
+	float uv_scaling;
+
+	template <typename I> void write(std::span<VertexFormat> vertices, std::span<I> indices) const;
+};
+
+/**
+ * @brief An axis aligned box whose six faces are subdivided into regular grids.
+ *
+ */
+class mygl::BoxMeshGenerator : public MeshGenerator {
+public:
+	/**
+	 * @brief Construct a new BoxMeshGenerator object.
+	 *
+	 * @param center the center of the box
+	 * @param size the edge lengths along the axes
+	 * @param tesselation how many subdivisions every face consists of along each of its sides
+	 */
+	BoxMeshGenerator(glm::vec3 center, glm::vec3 size, unsigned int tesselation = 0);
+
+	GeometryCounts getCounts() const override;
+	Bounds getBounds() const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const override;
+
+private:
+	glm::vec3 center, size;
+	unsigned int tesselation;
+
+	template <typename I> void write(std::span<VertexFormat> vertices, std::span<I> indices) const;
+};
+
+/**
+ * @brief A UV sphere made of rings (latitude) and segments (longitude).
+ *
+ */
+class mygl::SphereMeshGenerator : public MeshGenerator {
+public:
+	SphereMeshGenerator(glm::vec3 center, float radius, unsigned int segments = 32, unsigned int rings = 16);
+
+	GeometryCounts getCounts() const override;
+	Bounds getBounds() const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const override;
+
+private:
+	glm::vec3 center;
+	float radius;
+	unsigned int segments, rings;
+
+	template <typename I> void write(std::span<VertexFormat> vertices, std::span<I> indices) const;
+};
+
+/**
+ * @brief A cylinder along the y-axis, optionally closed by two caps.
+ *
+ */
+class mygl::CylinderMeshGenerator : public MeshGenerator {
+public:
+	CylinderMeshGenerator(glm::vec3 center, float radius, float height, unsigned int segments = 32, unsigned int height_segments = 1, bool caps = true);
+
+	GeometryCounts getCounts() const override;
+	Bounds getBounds() const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const override;
+
+private:
+	glm::vec3 center;
+	float radius, height;
+	unsigned int segments, height_segments;
+	bool caps;
+
+	template <typename I> void write(std::span<VertexFormat> vertices, std::span<I> indices) const;
+};
+
+/**
+ * @brief A torus around the y-axis.
+ *
+ */
+class mygl::TorusMeshGenerator : public MeshGenerator {
+public:
+	/**
+	 * @brief Construct a new TorusMeshGenerator object.
+	 *
+	 * @param center the center of the torus
+	 * @param major_radius the distance from the center to the center of the tube
+	 * @param minor_radius the radius of the tube
+	 * @param major_segments the subdivisions around the y-axis
+	 * @param minor_segments the subdivisions around the tube
+	 */
+	TorusMeshGenerator(glm::vec3 center, float major_radius, float minor_radius, unsigned int major_segments = 48, unsigned int minor_segments = 24);
+
+	GeometryCounts getCounts() const override;
+	Bounds getBounds() const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const override;
+
+private:
+	glm::vec3 center;
+	float major_radius, minor_radius;
+	unsigned int major_segments, minor_segments;
+
+	template <typename I> void write(std::span<VertexFormat> vertices, std::span<I> indices) const;
+};
+
+/**
+ * @brief A grid in the xz-plane whose vertices are displaced along y by height samples.
+ *
+ * Normals and tangents are derived from central differences of the samples.
+ */
+class mygl::HeightfieldMeshGenerator : public MeshGenerator {
+public:
+	/**
+	 * @brief Construct a new HeightfieldMeshGenerator object.
+	 *
+	 * @param heights the samples, row by row along z, each row along x; they must outlive the generator
+	 * @param columns the number of samples along x (at least 2)
+	 * @param rows the number of samples along z (at least 2)
+	 * @param origin the position of the first sample at height 0
+	 * @param spacing the distance between neighboring samples along x and z
+	 * @param height_scale a factor for the samples
+	 */
+	HeightfieldMeshGenerator(std::span<const float> heights, size_t columns, size_t rows, glm::vec3 origin = glm::vec3(0.f),
+		glm::vec2 spacing = glm::vec2(1.f), float height_scale = 1.f);
+
+	GeometryCounts getCounts() const override;
+	Bounds getBounds() const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const override;
+	void generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const override;
+
+private:
+	std::span<const float> heights;
+	size_t columns, rows;
+	glm::vec3 origin;
+	glm::vec2 spacing;
+	float height_scale;
+
+	template <typename I> void write(std::span<VertexFormat> vertices, std::span<I> indices) const;
+};
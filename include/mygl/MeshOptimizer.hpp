@@ -0,0 +1,161 @@
+#pragma once
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/SceneObject.hpp>
+
+namespace mygl {
+	struct VertexCacheStatistics;
+	struct MeshOptimizationReport;
+}
+
+/**
+ * @brief The efficiency of an index buffer for a simulated post-transform vertex cache.
+ *
+ */
+struct mygl::VertexCacheStatistics {
+	/**
+	 * @brief How many vertices had to be transformed by the vertex shader (cache misses).
+	 *
+	 */
+	size_t vertices_transformed = 0;
+
+	/**
+	 * @brief Average cache miss ratio: transformed vertices per triangle (best case ~0.5, worst case 3).
+	 *
+	 */
+	float acmr = 0.f;
+
+	/**
+	 * @brief Average transform to vertex ratio: transformed vertices per unique vertex (best case 1).
+	 *
+	 */
+	float atvr = 0.f;
+};
+
+/**
+ * @brief The vertex cache statistics of a mesh before and after optimization.
+ *
+ */
+struct mygl::MeshOptimizationReport {
+	VertexCacheStatistics before;
+	VertexCacheStatistics after;
+};
+
+namespace mygl {
+
+/**
+ * @brief Simulates a FIFO post-transform vertex cache for an indexed triangle list.
+ *
+ * @param indices the indices of the triangles (always a multiple of 3)
+ * @param vertex_count the number of vertices that are referenced by the indices
+ * @param cache_size the number of entries of the simulated cache
+ * @return VertexCacheStatistics the ACMR and ATVR of the index buffer
+ */
+VertexCacheStatistics analyzeVertexCache(const std::vector<GLuint> & indices, size_t vertex_count, unsigned int cache_size = 16);
+
+/**
+ * @brief Reorders the triangles to maximize the hit rate of the post-transform vertex cache.
+ *
+ * Uses the linear-speed vertex cache optimization by Tom Forsyth.
+ *
+ * @param indices the indices of the triangles (always a multiple of 3), reordered in place
+ * @param vertex_count the number of vertices that are referenced by the indices
+ */
+void optimizeVertexCache(std::vector<GLuint> & indices, size_t vertex_count);
+
+/**
+ * @brief Reorders clusters of triangles to reduce overdraw, while keeping the vertex cache efficiency.
+ *
+ * Should be used after optimizeVertexCache. The triangles are split into clusters, whose ACMR does not exceed
+ * the ACMR of the whole mesh by the given threshold, and the clusters are sorted so that outwards facing
+ * clusters are drawn first (fast triangle reordering by Sander et al.).
+ *
+ * @param indices the indices of the triangles (always a multiple of 3), reordered in place
+ * @param positions the positions of the vertices
+ * @param threshold how much the cache efficiency may degrade (e.g. 1.05 allows 5% more transformed vertices)
+ */
+void optimizeOverdraw(std::vector<GLuint> & indices, const std::vector<glm::vec3> & positions, float threshold = 1.05f);
+
+/**
+ * @brief Renumbers the vertices in the order of their first use, so that the vertex fetch is sequential.
+ *
+ * @param indices the indices of the triangles, rewritten in place to refer to the new vertex order
+ * @param vertex_count the number of vertices that are referenced by the indices
+ * @return std::vector<GLuint> the remap table (old vertex index -> new vertex index, ~0u if the vertex is unused)
+ */
+std::vector<GLuint> optimizeVertexFetchRemap(std::vector<GLuint> & indices, size_t vertex_count);
+
+/**
+ * @brief Collects the positions of all vertices of a mesh.
+ *
+ * @param data the mesh data, the vertex format needs a 'position' member
+ * @return std::vector<glm::vec3> the positions in vertex order
+ */
+template <typename T>
+std::vector<glm::vec3> extractPositions(const MeshData<T> & data)
+{
+	std::vector<glm::vec3> positions;
+	positions.reserve(data.vertices.size());
+	for (const T & vertex : data.vertices) {
+		positions.push_back(vertex.position);
+	}
+	return positions;
+}
+
+/**
+ * @brief Reorders the vertices of a mesh in the order of their first use and drops unused vertices.
+ *
+ * @param data the indexed mesh data that will be modified
+ */
+template <typename T>
+void optimizeVertexFetch(MeshData<T> & data)
+{
+	if (!data.indices.has_value()) return;
+	std::vector<GLuint> remap = optimizeVertexFetchRemap(data.indices.value(), data.vertices.size());
+
+	size_t unique_vertices = 0;
+	for (GLuint r : remap) {
+		if (r != ~0u) unique_vertices++;
+	}
+	std::vector<const T *> order(unique_vertices, nullptr);
+	for (size_t i = 0; i < remap.size(); i++) {
+		if (remap[i] != ~0u) order[remap[i]] = &data.vertices[i];
+	}
+
+	std::vector<T> vertices;
+	vertices.reserve(unique_vertices);
+	for (const T * vertex : order) {
+		vertices.push_back(*vertex);
+	}
+	data.vertices = std::move(vertices);
+}
+
+/**
+ * @brief Runs the full optimization pipeline: vertex cache, overdraw and vertex fetch optimization.
+ *
+ * Only indexed GL_TRIANGLES meshes are supported, other meshes are left untouched.
+ *
+ * @param data the indexed mesh data that will be modified
+ * @param overdraw_threshold how much the cache efficiency may degrade in favor of less overdraw
+ * @return MeshOptimizationReport the vertex cache statistics before and after the optimization
+ */
+template <typename T>
+MeshOptimizationReport optimizeMesh(MeshData<T> & data, float overdraw_threshold = 1.05f)
+{
+	MeshOptimizationReport report;
+	if (!data.indices.has_value() || data.indices.value().size() % 3 != 0) return report;
+
+	std::vector<GLuint> & indices = data.indices.value();
+	report.before = analyzeVertexCache(indices, data.vertices.size());
+
+	optimizeVertexCache(indices, data.vertices.size());
+	optimizeOverdraw(indices, extractPositions(data), overdraw_threshold);
+	optimizeVertexFetch(data);
+
+	report.after = analyzeVertexCache(data.indices.value(), data.vertices.size());
+	return report;
+}
+
+}
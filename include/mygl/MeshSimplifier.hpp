@@ -0,0 +1,132 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/SceneObject.hpp>
+#include <mygl/MeshOptimizer.hpp>
+#include <mygl/Parallel.hpp>
+
+namespace mygl {
+	struct SimplificationOptions;
+}
+
+/**
+ * @brief The options that control how far a mesh is simplified.
+ *
+ * The simplification stops as soon as either the target triangle count is reached
+ * or the next edge collapse would exceed the target error.
+ */
+struct mygl::SimplificationOptions {
+	/**
+	 * @brief The number of triangles that should remain (0 to only use the target error).
+	 *
+	 */
+	size_t target_triangle_count = 0;
+
+	/**
+	 * @brief The maximal deviation from the original surface, relative to the extent of the mesh (e.g. 0.01 for 1%).
+	 *
+	 */
+	float target_error = 0.01f;
+
+	/**
+	 * @brief Whether vertices on open borders of the mesh stay in place.
+	 * If false, border vertices may still collapse along the border.
+	 */
+	bool lock_border = false;
+};
+
+namespace mygl {
+
+/**
+ * @brief Simplifies an indexed triangle list by collapsing edges with the lowest quadric error.
+ *
+ * Vertices are only removed, never moved, so the returned indices still refer to the original vertices.
+ * Vertices that share their position with other vertices (uv or normal seams) are never collapsed,
+ * which keeps attribute discontinuities intact.
+ *
+ * @param indices the indices of the triangles (always a multiple of 3)
+ * @param positions the positions of the vertices
+ * @param options the target triangle count and error
+ * @param result_error optional output for the reached error, relative to the extent of the mesh
+ * @return std::vector<GLuint> the indices of the simplified triangles
+ */
+std::vector<GLuint> simplifyIndices(const std::vector<GLuint> & indices, const std::vector<glm::vec3> & positions,
+	const SimplificationOptions & options, float * result_error = nullptr);
+
+/**
+ * @brief Creates a simplified copy of an indexed triangle mesh.
+ *
+ * @param data the mesh data that will be simplified
+ * @param options the target triangle count and error
+ * @param result_error optional output for the reached error, relative to the extent of the mesh
+ * @return std::shared_ptr<MeshData<T>> the simplified mesh data, containing only the vertices that are still used
+ */
+template <typename T>
+std::shared_ptr<MeshData<T>> simplifyMesh(const MeshData<T> & data, const SimplificationOptions & options, float * result_error = nullptr)
+{
+	std::shared_ptr<MeshData<T>> result = std::shared_ptr<MeshData<T>>(new MeshData<T>());
+	result->vertices = data.vertices;
+	if (!data.indices.has_value()) {
+		if (result_error) *result_error = 0.f;
+		return result;
+	}
+
+	result->indices = simplifyIndices(data.indices.value(), extractPositions(data), options, result_error);
+	optimizeVertexFetch(*result);
+	return result;
+}
+
+/**
+ * @brief Simplifies many meshes in parallel with the same options.
+ *
+ * @param meshes the mesh data that will be simplified
+ * @param options the target triangle count and error (a triangle count applies to each mesh)
+ * @return std::vector<std::shared_ptr<MeshData<T>>> the simplified meshes in the same order
+ */
+template <typename T>
+std::vector<std::shared_ptr<MeshData<T>>> simplifyMeshes(const std::vector<std::shared_ptr<MeshData<T>>> & meshes, const SimplificationOptions & options)
+{
+	std::vector<std::shared_ptr<MeshData<T>>> results(meshes.size());
+	parallelFor(0, meshes.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			results[i] = simplifyMesh(*meshes[i], options);
+		}
+	}, 1);
+	return results;
+}
+
+/**
+ * @brief Builds a chain of levels of detail, where each level has a fraction of the triangles of the previous level.
+ *
+ * @param data the mesh data of the most detailed level
+ * @param lod_count the number of levels that will be created in addition to the original mesh
+ * @param reduction the fraction of triangles that each level keeps (e.g. 0.5)
+ * @param target_error the maximal error of each level, relative to the extent of the mesh
+ * @return std::vector<std::shared_ptr<MeshData<T>>> the levels of detail, from detailed to coarse
+ */
+template <typename T>
+std::vector<std::shared_ptr<MeshData<T>>> generateLodChain(const MeshData<T> & data, unsigned int lod_count, float reduction = 0.5f, float target_error = 0.05f)
+{
+	std::vector<std::shared_ptr<MeshData<T>>> lods;
+	if (!data.indices.has_value()) return lods;
+
+	// every level is simplified from the original mesh to avoid accumulating errors,
+	// which also allows building all levels in parallel
+	lods.resize(lod_count);
+	const size_t triangle_count = data.indices.value().size() / 3;
+	parallelFor(0, lod_count, [&](size_t begin, size_t end) {
+		for (size_t lod = begin; lod < end; lod++) {
+			SimplificationOptions options;
+			options.target_triangle_count = static_cast<size_t>(triangle_count * std::pow(reduction, static_cast<float>(lod + 1)));
+			options.target_error = target_error;
+			lods[lod] = simplifyMesh(data, options);
+		}
+	}, 1);
+	return lods;
+}
+
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+namespace mygl {
+	struct Meshlet;
+	struct MeshletData;
+}
+
+/**
+ * @brief A small cluster of triangles with bounds that allow culling it as a whole.
+ *
+ */
+struct mygl::Meshlet {
+	/**
+	 * @brief The first entry of the meshlet inside of MeshletData::vertices.
+	 *
+	 */
+	size_t vertex_offset = 0;
+
+	/**
+	 * @brief The number of vertices that are used by the meshlet.
+	 *
+	 */
+	unsigned int vertex_count = 0;
+
+	/**
+	 * @brief The first entry of the meshlet inside of MeshletData::triangles (counted in indices, not triangles).
+	 *
+	 */
+	size_t triangle_offset = 0;
+
+	/**
+	 * @brief The number of triangles of the meshlet.
+	 *
+	 */
+	unsigned int triangle_count = 0;
+
+	/**
+	 * @brief The center of the bounding sphere.
+	 *
+	 */
+	glm::vec3 center = glm::vec3(0.f);
+
+	/**
+	 * @brief The radius of the bounding sphere.
+	 *
+	 */
+	float radius = 0.f;
+
+	/**
+	 * @brief The average facing direction of the triangles.
+	 *
+	 */
+	glm::vec3 cone_axis = glm::vec3(0.f, 0.f, 1.f);
+
+	/**
+	 * @brief The sine of the opening angle of the normal cone, 1 if the cluster can never be back-facing as a whole.
+	 *
+	 */
+	float cone_cutoff = 1.f;
+};
+
+/**
+ * @brief The meshlets of a mesh together with their local vertex and index tables.
+ *
+ */
+struct mygl::MeshletData {
+	std::vector<Meshlet> meshlets;
+
+	/**
+	 * @brief The mesh vertex index for every local vertex of every meshlet.
+	 *
+	 */
+	std::vector<GLuint> vertices;
+
+	/**
+	 * @brief Three local vertex indices per triangle.
+	 *
+	 */
+	std::vector<unsigned char> triangles;
+};
+
+namespace mygl {
+
+/**
+ * @brief The default limits of a meshlet, as recommended for mesh shaders.
+ *
+ */
+static const unsigned int MESHLET_MAX_VERTICES = 64;
+static const unsigned int MESHLET_MAX_TRIANGLES = 124;
+
+/**
+ * @brief Splits a triangle list into meshlets and calculates their bounding spheres and normal cones.
+ *
+ * Triangles are assigned greedily in index order, so the meshlets are most compact if the indices were optimized for
+ * the vertex cache before (see optimizeVertexCache). The bounds are calculated on multiple threads.
+ *
+ * @param indices the indices of the triangles (always a multiple of 3)
+ * @param positions the position of every vertex
+ * @param max_vertices the maximal number of vertices per meshlet (at most 255)
+ * @param max_triangles the maximal number of triangles per meshlet
+ * @return MeshletData the meshlets
+ */
+MeshletData buildMeshlets(const std::vector<GLuint> & indices, const std::vector<glm::vec3> & positions,
+	unsigned int max_vertices = MESHLET_MAX_VERTICES, unsigned int max_triangles = MESHLET_MAX_TRIANGLES);
+
+/**
+ * @brief Extracts the six frustum planes (left, right, bottom, top, near, far) from a view projection matrix.
+ *
+ * If the matrix contains the model matrix as well, the planes are in the local coordinate system of the model.
+ *
+ * @param view_projection the combined matrix
+ * @return std::vector<glm::vec4> the normalized planes, pointing inwards (xyz = normal, w = distance)
+ */
+std::vector<glm::vec4> extractFrustumPlanes(const glm::mat4 & view_projection);
+
+/**
+ * @brief Returns whether a meshlet may be visible.
+ *
+ * @param meshlet the meshlet to test
+ * @param planes the frustum planes in the coordinate system of the meshlet (see extractFrustumPlanes)
+ * @param camera_position the camera position in the coordinate system of the meshlet
+ * @return true if the meshlet intersects the frustum and is not entirely back-facing
+ * @return false else
+ */
+bool isMeshletVisible(const Meshlet & meshlet, const std::vector<glm::vec4> & planes, const glm::vec3 & camera_position);
+
+/**
+ * @brief Culls the meshlets and writes the indices of the remaining triangles.
+ *
+ * Visibility is tested on multiple threads, afterwards the indices of the visible meshlets are written in parallel.
+ *
+ * @param data the meshlets of the mesh
+ * @param model_view_projection the matrix that transforms the mesh into clip space
+ * @param camera_position the camera position in the coordinate system of the mesh
+ * @param out_indices receives the mesh vertex indices of the visible triangles, has to hold all triangles of the mesh
+ * @param out_visible_meshlets receives the number of visible meshlets (optional)
+ * @return size_t the number of written indices
+ */
+size_t cullMeshlets(const MeshletData & data, const glm::mat4 & model_view_projection, const glm::vec3 & camera_position,
+	GLuint * out_indices, size_t * out_visible_meshlets = nullptr);
+
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <numeric>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/SceneObject.hpp>
+#include <mygl/StreamBuffer.hpp>
+#include <mygl/Meshlet.hpp>
+#include <mygl/MeshOptimizer.hpp>
+
+namespace mygl {
+	template <typename T> class MeshletMesh;
+}
+
+/**
+ * @brief A static triangle mesh that is split into meshlets, which are culled on the CPU before every draw call.
+ *
+ * Only the triangles of meshlets that intersect the view frustum and are not entirely back-facing are drawn. The
+ * indices of these triangles are written into a persistently mapped ring once per view, the vertices stay untouched.
+ * Drawing the same view again (e.g. a depth prepass followed by the main pass) reuses the culled indices; the ring has
+ * three regions per view that is culled per frame, so that drawing a mesh for several views (shadow, depth and main
+ * passes) does not wait for the GPU.
+ *
+ * The scene configuration has to contain the matrices "projection" and "view" and the vector "camera_position",
+ * the object configuration the matrix "model". The back-face test assumes a uniform scale in the model matrix.
+ */
+template <typename T>
+class mygl::MeshletMesh : public SceneMesh<T> {
+public:
+	using SceneMesh<T>::update;
+
+	/**
+	 * @brief Construct a new MeshletMesh object.
+	 *
+	 * @param data the triangles of the mesh, triangle soups without indices are supported as well
+	 * @param material the material that defines the appearance of the mesh
+	 * @param max_vertices the maximal number of vertices per meshlet
+	 * @param max_triangles the maximal number of triangles per meshlet
+	 * @param views_per_frame the number of different views the mesh is drawn for per frame
+	 */
+	MeshletMesh(std::shared_ptr<MeshData<T>> data, std::shared_ptr<Material> material = std::shared_ptr<Material>(new Material()),
+		unsigned int max_vertices = MESHLET_MAX_VERTICES, unsigned int max_triangles = MESHLET_MAX_TRIANGLES, unsigned int views_per_frame = 3)
+		: SceneMesh<T>(data, GL_STATIC_DRAW, GL_TRIANGLES, material, false)
+	{
+		this->max_vertices = max_vertices;
+		this->max_triangles = max_triangles;
+		this->views_per_frame = std::max(views_per_frame, 1u);
+		buildClusters(*data);
+	}
+
+	/**
+	 * @brief Replaces the geometry of the mesh and splits it into meshlets again. The mesh stays a static triangle list.
+	 *
+	 * @param data the new triangles
+	 * @param draw_type ignored, the mesh is always static
+	 * @param geometry_type ignored, the mesh always consists of triangles
+	 */
+	void update(std::shared_ptr<MeshData<T>> data, GLenum draw_type, GLenum geometry_type) override
+	{
+		SceneMesh<T>::update(data, GL_STATIC_DRAW, GL_TRIANGLES);
+		buildClusters(*data);
+	}
+
+	/**
+	 * @brief Culls the meshlets against the current camera and draws the visible ones with the current shader.
+	 *
+	 */
+	void draw(ShaderConfiguration* scene_configuration, ShaderConfiguration* object_configuration) override
+	{
+		const GLuint vertex_array = this->getVertexArray();
+		if (vertex_array == 0) return;
+
+		object_configuration->setMaterial("material", this->getMaterial());
+		this->configureShader(scene_configuration, object_configuration);
+
+		const glm::mat4 model = object_configuration->getMat4("model");
+		const glm::mat4 model_view_projection = scene_configuration->getMat4("projection") * scene_configuration->getMat4("view") * model;
+		const glm::vec3 camera_position = glm::vec3(glm::inverse(model) * glm::vec4(scene_configuration->getVec3("camera_position"), 1.f));
+
+		// the indices of the current region are still valid for the view they were culled for
+		if (!this->culled || model_view_projection != this->culled_model_view_projection || camera_position != this->culled_camera_position) {
+			GLuint * region = static_cast<GLuint*>(this->index_stream->beginWrite());
+			this->culled_index_count = cullMeshlets(this->meshlets, model_view_projection, camera_position, region, &this->visible_meshlets);
+			this->culled_model_view_projection = model_view_projection;
+			this->culled_camera_position = camera_position;
+			this->culled = true;
+		}
+
+		// the vertex array may be shared with other meshes, so its index buffer is restored afterwards
+		glBindVertexArray(vertex_array);
+		glVertexArrayElementBuffer(vertex_array, this->index_stream->getID());
+		if (this->culled_index_count > 0) {
+			glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(this->culled_index_count), GL_UNSIGNED_INT,
+				reinterpret_cast<void*>(this->index_stream->getCurrentOffset()), this->getBaseVertex());
+		}
+		this->index_stream->fenceCurrentRegion();
+		glVertexArrayElementBuffer(vertex_array, this->getIndexBuffer());
+		glBindVertexArray(0);
+	}
+
+	/**
+	 * @brief Returns the meshlets of the mesh.
+	 *
+	 * @return const MeshletData& the meshlets with their bounds
+	 */
+	const MeshletData & getMeshletData() { return this->meshlets; }
+
+	/**
+	 * @brief Returns how many meshlets passed the culling during the last draw call.
+	 *
+	 * @return size_t the number of visible meshlets
+	 */
+	size_t getVisibleMeshletCount() { return this->visible_meshlets; }
+
+private:
+	MeshletData meshlets;
+	std::unique_ptr<StreamBuffer> index_stream;
+	size_t visible_meshlets = 0;
+	unsigned int max_vertices = MESHLET_MAX_VERTICES;
+	unsigned int max_triangles = MESHLET_MAX_TRIANGLES;
+	unsigned int views_per_frame = 3;
+
+	bool culled = false;
+	size_t culled_index_count = 0;
+	glm::mat4 culled_model_view_projection = glm::mat4(1.f);
+	glm::vec3 culled_camera_position = glm::vec3(0.f);
+
+	void buildClusters(const MeshData<T> & data)
+	{
+		if (data.indices.has_value()) {
+			this->meshlets = buildMeshlets(data.indices.value(), extractPositions(data), this->max_vertices, this->max_triangles);
+		}
+		else {
+			std::vector<GLuint> indices(data.vertices.size() - data.vertices.size() % 3);
+			std::iota(indices.begin(), indices.end(), 0);
+			this->meshlets = buildMeshlets(indices, extractPositions(data), this->max_vertices, this->max_triangles);
+		}
+		const size_t index_total = std::max<size_t>(this->meshlets.triangles.size(), 1);
+		this->index_stream.reset(new StreamBuffer(sizeof(GLuint) * index_total, 3 * this->views_per_frame));
+		this->culled = false;
+	}
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mygl {
+	/**
+	 * @brief Describes what the channels of an image store, which decides how its mipmaps are filtered.
+	 *
+	 */
+	enum class TextureContent {
+		Color,	// sRGB encoded colors, filtered in linear light and weighted by their alpha
+		Linear,	// linear data like roughness, metallic or height
+		Normal	// tangent space normals encoded as n * 0.5 + 0.5, renormalized after filtering
+	};
+
+	/**
+	 * @brief The filter that computes a texel of a smaller mipmap level from the texels of the larger one.
+	 *
+	 */
+	enum class MipFilter {
+		Box,	// the average of the covered texels, partially covered texels of odd extents are weighted by their coverage
+		Kaiser	// a Kaiser windowed sinc, which keeps smaller levels sharper and aliases less than the box
+	};
+
+	struct MipLevel;
+}
+
+/**
+ * @brief A mipmap level with 4 bytes per texel.
+ *
+ */
+struct mygl::MipLevel {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<unsigned char> rgba;
+};
+
+namespace mygl {
+
+/**
+ * @brief Decodes sRGB encoded texels into linear values, the alpha channel is only normalized.
+ *
+ * @param srgb the texels with 4 bytes each
+ * @param linear receives the texels with 4 floats each
+ * @param texel_count the number of texels
+ */
+void convertSrgbToLinear(const unsigned char * srgb, float * linear, size_t texel_count);
+
+/**
+ * @brief Encodes linear texels as sRGB, the alpha channel is only quantized. Values are clamped to [0, 1].
+ *
+ * @param linear the texels with 4 floats each
+ * @param srgb receives the texels with 4 bytes each
+ * @param texel_count the number of texels
+ */
+void convertLinearToSrgb(const float * linear, unsigned char * srgb, size_t texel_count);
+
+/**
+ * @brief Multiplies the color channels of texels by their alpha, so that transparent texels do not bleed into their
+ * neighbours when filtered.
+ *
+ * @param rgba the texels with 4 floats each
+ * @param texel_count the number of texels
+ */
+void premultiplyAlpha(float * rgba, size_t texel_count);
+
+/**
+ * @brief Divides the color channels of texels by their alpha, fully transparent texels become black.
+ *
+ * @param rgba the texels with 4 floats each
+ * @param texel_count the number of texels
+ */
+void unpremultiplyAlpha(float * rgba, size_t texel_count);
+
+/**
+ * @brief Resamples an image with 4 floats per texel to a smaller size. The edges are clamped.
+ *
+ * @param source the image
+ * @param width the width of the image
+ * @param height the height of the image
+ * @param target receives the resampled image
+ * @param target_width the width of the target, at most the width of the image
+ * @param target_height the height of the target, at most the height of the image
+ * @param filter the filter
+ */
+void downsample(const float * source, uint32_t width, uint32_t height, float * target, uint32_t target_width, uint32_t target_height, MipFilter filter);
+
+/**
+ * @brief Computes the complete mipmap chain of an image on the calling thread.
+ *
+ * Colors are filtered in linear light and premultiplied by alpha, normals are renormalized on every level, which
+ * glGenerateMipmap does neither.
+ *
+ * @param rgba the image with 4 bytes per texel
+ * @param width the width in texels
+ * @param height the height in texels
+ * @param content how the channels are filtered
+ * @param filter the downsampling filter
+ * @return std::vector<MipLevel> the levels from the image itself down to 1 x 1
+ */
+std::vector<MipLevel> generateMipLevels(const unsigned char * rgba, uint32_t width, uint32_t height, TextureContent content, MipFilter filter = MipFilter::Box);
+
+}
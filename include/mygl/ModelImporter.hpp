@@ -0,0 +1,110 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/VertexFormat.hpp>
+#include <mygl/SceneObject.hpp>
+#include <mygl/Material.hpp>
+
+namespace mygl {
+	struct ImportedMesh;
+	struct ImportedModel;
+	struct ImportOptions;
+}
+
+/**
+ * @brief A mesh of an imported model together with its material and placement.
+ *
+ */
+struct mygl::ImportedMesh {
+	std::string name;
+	std::shared_ptr<MeshData<VertexFormat>> data;
+	std::shared_ptr<Material> material;
+
+	/**
+	 * @brief The OpenGL primitive type of the mesh.
+	 *
+	 */
+	GLenum geometry_type = GL_TRIANGLES;
+
+	/**
+	 * @brief The transformation into the coordinate system of the model (the model matrix of a SceneNode).
+	 *
+	 */
+	glm::mat4 transform = glm::mat4(1.f);
+};
+
+/**
+ * @brief The meshes and materials of an imported model.
+ *
+ * Meshes that are placed several times (glTF nodes that share a mesh) share their MeshData.
+ */
+struct mygl::ImportedModel {
+	std::vector<ImportedMesh> meshes;
+	std::vector<std::shared_ptr<Material>> materials;
+};
+
+/**
+ * @brief Controls how models are imported.
+ *
+ */
+struct mygl::ImportOptions {
+	/**
+	 * @brief Whether textures that are referenced by materials are loaded.
+	 * Loading textures requires a current OpenGL context.
+	 */
+	bool load_textures = true;
+
+	/**
+	 * @brief Loads the textures in the background if set. They show a neutral placeholder until they are uploaded by
+	 * TextureLoader::update.
+	 */
+	TextureLoader * texture_loader = nullptr;
+
+	/**
+	 * @brief Whether missing normals and all tangents are generated (see generateNormalsAndTangents).
+	 *
+	 */
+	bool generate_attributes = true;
+};
+
+namespace mygl {
+
+/**
+ * @brief Imports a Wavefront OBJ file with its MTL materials.
+ *
+ * The file is split into chunks at line boundaries. A first parallel pass counts the elements of every chunk, so that
+ * the positions, normals, uv-coordinates and face corners are written by a second parallel pass directly into
+ * preallocated arrays. Polygons are triangulated as fans, every material becomes its own mesh.
+ *
+ * @param path the path of the file
+ * @param options the import options
+ * @return ImportedModel the imported meshes
+ */
+ImportedModel importObj(const std::string & path, const ImportOptions & options = ImportOptions());
+
+/**
+ * @brief Imports a glTF 2.0 asset, either as .gltf with external or embedded (data URI) buffers or as binary .glb.
+ *
+ * Accessors are decoded on multiple threads directly into preallocated vertex and index arrays. The metallic-roughness
+ * materials are mapped onto the albedo, normal, roughness, metallic, ao and opacity properties of Material.
+ *
+ * @param path the path of the file
+ * @param options the import options
+ * @return ImportedModel the imported meshes, placed by the node hierarchy of the default scene
+ */
+ImportedModel importGltf(const std::string & path, const ImportOptions & options = ImportOptions());
+
+/**
+ * @brief Imports a model and chooses the importer by the file extension (.obj, .gltf, .glb).
+ *
+ * @param path the path of the file
+ * @param options the import options
+ * @return ImportedModel the imported meshes
+ */
+ImportedModel importModel(const std::string & path, const ImportOptions & options = ImportOptions());
+
+}
@@ -0,0 +1,251 @@
+#pragma once
+#include <memory>
+#include <span>
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/VertexFormat.hpp>
+#include <mygl/SceneObject.hpp>
+#include <mygl/MeshAttributes.hpp>
+
+namespace mygl {
+	struct NurbsCurve;
+	struct NurbsSurface;
+	struct BasisBatch;
+	struct NurbsTessellationOptions;
+}
+
+/**
+ * @brief A NURBS curve with homogeneous control points.
+ *
+ */
+struct mygl::NurbsCurve {
+	int degree = 0;
+
+	/**
+	 * @brief The knot vector with control_points.size() + degree + 1 non-decreasing values.
+	 *
+	 */
+	std::vector<double> knots;
+
+	/**
+	 * @brief The weighted control points (w * x, w * y, w * z, w).
+	 *
+	 */
+	std::vector<glm::dvec4> control_points;
+};
+
+/**
+ * @brief A tensor product NURBS surface with homogeneous control points.
+ *
+ */
+struct mygl::NurbsSurface {
+	int degree_u = 0;
+	int degree_v = 0;
+	std::vector<double> knots_u;
+	std::vector<double> knots_v;
+
+	/**
+	 * @brief The number of control points along u and v.
+	 *
+	 */
+	size_t count_u = 0;
+	size_t count_v = 0;
+
+	/**
+	 * @brief The weighted control points (w * x, w * y, w * z, w), stored as control_points[i * count_v + j].
+	 *
+	 */
+	std::vector<glm::dvec4> control_points;
+};
+
+/**
+ * @brief The non-zero B-spline basis functions and their first derivatives for many parameters.
+ *
+ * The degree + 1 values of parameter k are stored at [k * (degree + 1), (k + 1) * (degree + 1)) and belong to the
+ * control points spans[k] - degree to spans[k].
+ */
+struct mygl::BasisBatch {
+	int degree = 0;
+	std::vector<size_t> spans;
+	std::vector<double> values;
+	std::vector<double> derivatives;
+};
+
+/**
+ * @brief Controls the adaptive tessellation of NURBS curves and surfaces.
+ *
+ */
+struct mygl::NurbsTessellationOptions {
+	/**
+	 * @brief The maximal distance between the tessellation and the exact geometry (chord error) in model units.
+	 *
+	 */
+	double tolerance = 1e-3;
+
+	/**
+	 * @brief How often a knot span is halved at most.
+	 *
+	 */
+	unsigned int max_depth = 10;
+};
+
+namespace mygl {
+
+/**
+ * @brief Finds the knot span that contains a parameter.
+ *
+ * @param degree the degree of the basis
+ * @param knots the knot vector
+ * @param control_point_count the number of control points
+ * @param t the parameter, clamped to the domain
+ * @return size_t the index i with knots[i] <= t < knots[i + 1]
+ */
+size_t findKnotSpan(int degree, const std::vector<double> & knots, size_t control_point_count, double t);
+
+/**
+ * @brief Evaluates the basis functions and their first derivatives for many parameters on multiple threads.
+ *
+ * Ascending parameters reuse the span of their predecessor instead of searching it.
+ *
+ * @param degree the degree of the basis
+ * @param knots the knot vector
+ * @param control_point_count the number of control points
+ * @param parameters the parameters
+ * @return BasisBatch the basis functions of all parameters
+ */
+BasisBatch evaluateBasisBatch(int degree, const std::vector<double> & knots, size_t control_point_count, std::span<const double> parameters);
+
+/**
+ * @brief Evaluates a curve at many parameters.
+ *
+ * @param curve the curve
+ * @param parameters the parameters
+ * @return std::vector<glm::dvec3> the points
+ */
+std::vector<glm::dvec3> evaluateCurve(const NurbsCurve & curve, std::span<const double> parameters);
+
+/**
+ * @brief Evaluates a surface at a single parameter pair.
+ *
+ * @param surface the surface
+ * @param u the parameter along u
+ * @param v the parameter along v
+ * @return glm::dvec3 the point
+ */
+glm::dvec3 evaluateSurface(const NurbsSurface & surface, double u, double v);
+
+/**
+ * @brief Evaluates a surface on the grid us x vs on multiple threads.
+ *
+ * The basis functions of both directions are evaluated once per parameter, the tensor product is contracted along u
+ * first, so every grid point only costs (degree_v + 1) operations.
+ *
+ * @param surface the surface
+ * @param us the parameters along u (grid rows)
+ * @param vs the parameters along v (grid columns)
+ * @param positions receives the points, positions[i * vs.size() + j]
+ * @param normals receives the unit normals (cross product of the partial derivatives along u and v), may be nullptr
+ * @param tangents receives the unit partial derivatives along u, may be nullptr
+ */
+void evaluateSurfaceGrid(const NurbsSurface & surface, std::span<const double> us, std::span<const double> vs,
+	std::vector<glm::dvec3> & positions, std::vector<glm::dvec3> * normals, std::vector<glm::dvec3> * tangents);
+
+/**
+ * @brief Chooses the parameters of a curve, so that the polyline through them keeps the chord error.
+ *
+ * Every knot span is halved until the midpoint of each segment is closer than the tolerance to its chord.
+ *
+ * @param curve the curve
+ * @param options the tolerance
+ * @return std::vector<double> the ascending parameters including both ends of the domain
+ */
+std::vector<double> refineCurveParameters(const NurbsCurve & curve, const NurbsTessellationOptions & options);
+
+/**
+ * @brief Tessellates a curve into a line strip (draw the result with GL_LINE_STRIP).
+ *
+ * @param curve the curve
+ * @param options the tolerance
+ * @return std::shared_ptr<MeshData<VertexFormat>> the vertices of the strip, uv.x is the normalized parameter
+ */
+std::shared_ptr<MeshData<VertexFormat>> tessellateCurve(const NurbsCurve & curve, const NurbsTessellationOptions & options = NurbsTessellationOptions());
+
+/**
+ * @brief Tessellates a surface into an indexed triangle list with normals, tangents and normalized uv-coordinates.
+ *
+ * The parameters along u and v are refined independently by their chord error along iso curves of the other
+ * direction. The surface is then evaluated on the resulting non-uniform grid, which needs no crack fixing.
+ *
+ * @param surface the surface
+ * @param options the tolerance
+ * @return std::shared_ptr<MeshData<VertexFormat>> the triangles
+ */
+std::shared_ptr<MeshData<VertexFormat>> tessellateSurface(const NurbsSurface & surface, const NurbsTessellationOptions & options = NurbsTessellationOptions());
+
+/**
+ * @brief Returns the bounds of the control points, which contain the surface.
+ *
+ * @param surface the surface
+ * @return Bounds the bounds
+ */
+Bounds calculateControlBounds(const NurbsSurface & surface);
+
+/**
+ * @brief Converts an error in pixels into a tolerance in model units for an object at a distance from the camera.
+ *
+ * @param bounds the bounds of the object in model units
+ * @param camera_position the camera position in model units
+ * @param fov_y the vertical field of view in radians
+ * @param viewport_height the height of the viewport in pixels
+ * @param pixel_error the allowed error in pixels
+ * @return double the tolerance for the tessellation
+ */
+double calculateScreenTolerance(const Bounds & bounds, const glm::vec3 & camera_position, float fov_y, float viewport_height, float pixel_error = 1.f);
+
+/**
+ * @brief Converts a curve of LNLib (LN_NurbsCurve) or of any type with the same members.
+ *
+ * @param curve a curve with Degree, KnotVector and ControlPoints, whose points provide GetWX, GetWY, GetWZ and GetW
+ * @return NurbsCurve the curve
+ */
+template <typename C>
+NurbsCurve convertNurbsCurve(const C & curve)
+{
+	NurbsCurve result;
+	result.degree = curve.Degree;
+	result.knots.assign(curve.KnotVector.begin(), curve.KnotVector.end());
+	result.control_points.reserve(curve.ControlPoints.size());
+	for (const auto & point : curve.ControlPoints) {
+		result.control_points.push_back(glm::dvec4(point.GetWX(), point.GetWY(), point.GetWZ(), point.GetW()));
+	}
+	return result;
+}
+
+/**
+ * @brief Converts a surface of LNLib (LN_NurbsSurface) or of any type with the same members.
+ *
+ * @param surface a surface with DegreeU, DegreeV, KnotVectorU, KnotVectorV and the control points as rows along u
+ * @return NurbsSurface the surface
+ */
+template <typename S>
+NurbsSurface convertNurbsSurface(const S & surface)
+{
+	NurbsSurface result;
+	result.degree_u = surface.DegreeU;
+	result.degree_v = surface.DegreeV;
+	result.knots_u.assign(surface.KnotVectorU.begin(), surface.KnotVectorU.end());
+	result.knots_v.assign(surface.KnotVectorV.begin(), surface.KnotVectorV.end());
+	result.count_u = surface.ControlPoints.size();
+	result.count_v = result.count_u > 0 ? surface.ControlPoints[0].size() : 0;
+	result.control_points.reserve(result.count_u * result.count_v);
+	for (const auto & row : surface.ControlPoints) {
+		for (const auto & point : row) {
+			result.control_points.push_back(glm::dvec4(point.GetWX(), point.GetWY(), point.GetWZ(), point.GetW()));
+		}
+	}
+	return result;
+}
+
+}
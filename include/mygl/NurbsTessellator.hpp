@@ -0,0 +1,108 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+
+#include <mygl/Nurbs.hpp>
+
+namespace mygl {
+	class NurbsTessellator;
+}
+
+/**
+ * @brief Caches tessellations of NURBS surfaces per tolerance and creates missing ones on a background thread.
+ *
+ * Tolerances are quantized into steps of half an octave, so a camera that moves slowly reuses the cached tessellation
+ * until the required tolerance changes noticeably. While a tessellation is pending, the cached tessellation of the
+ * same surface with the nearest tolerance is returned. The cache keeps the surfaces alive, they must not be modified
+ * afterwards. The resulting MeshData can be uploaded with SceneMesh::update on the thread of the OpenGL context.
+ */
+class mygl::NurbsTessellator {
+public:
+	/**
+	 * @brief Construct a new NurbsTessellator object and starts its worker thread.
+	 *
+	 * @param max_cached_tessellations how many tessellations are kept before the least recently used ones are evicted
+	 */
+	NurbsTessellator(size_t max_cached_tessellations = 256);
+	~NurbsTessellator();
+
+	NurbsTessellator(const NurbsTessellator &) = delete;
+	NurbsTessellator & operator = (const NurbsTessellator &) = delete;
+
+	/**
+	 * @brief Returns the best available tessellation and schedules the tessellation for the tolerance if it is missing.
+	 *
+	 * @param surface the surface
+	 * @param tolerance the required chord error, e.g. from calculateScreenTolerance
+	 * @return std::shared_ptr<MeshData<VertexFormat>> the tessellation for the tolerance, the one with the nearest
+	 * tolerance while it is pending, or nullptr if the surface was never tessellated
+	 */
+	std::shared_ptr<MeshData<VertexFormat>> request(std::shared_ptr<const NurbsSurface> surface, double tolerance);
+
+	/**
+	 * @brief Returns the tessellation for the tolerance and creates it on the calling thread if it is missing.
+	 *
+	 * @param surface the surface
+	 * @param tolerance the required chord error
+	 * @return std::shared_ptr<MeshData<VertexFormat>> the tessellation
+	 */
+	std::shared_ptr<MeshData<VertexFormat>> tessellate(std::shared_ptr<const NurbsSurface> surface, double tolerance);
+
+	/**
+	 * @brief Removes all cached tessellations of a surface. Pending tessellations are still finished.
+	 *
+	 * @param surface the surface
+	 */
+	void evict(const NurbsSurface * surface);
+
+	/**
+	 * @brief Returns how many tessellations are queued or in progress.
+	 *
+	 * @return size_t the number of pending tessellations
+	 */
+	size_t getPendingCount();
+
+	/**
+	 * @brief Rounds a tolerance down to its step of half an octave.
+	 *
+	 * @param tolerance the tolerance
+	 * @return int the step, the tolerance of step s is 2^(s / 2)
+	 */
+	static int quantizeTolerance(double tolerance);
+	static double getStepTolerance(int step);
+
+private:
+	typedef std::pair<const NurbsSurface *, int> Key;
+
+	struct Entry {
+		std::shared_ptr<const NurbsSurface> surface;
+		std::shared_ptr<MeshData<VertexFormat>> mesh;
+		uint64_t last_use = 0;
+	};
+
+	struct Job {
+		Key key;
+		std::shared_ptr<const NurbsSurface> surface;
+	};
+
+	size_t max_cached_tessellations;
+	std::map<Key, Entry> cache;
+	std::deque<Job> jobs;
+	std::set<Key> pending;
+	uint64_t use_counter = 0;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopping = false;
+	std::thread worker;
+
+	void run();
+	void insert(const Key & key, std::shared_ptr<const NurbsSurface> surface, std::shared_ptr<MeshData<VertexFormat>> mesh);
+};
@@ -0,0 +1,208 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mygl {
+	class ThreadPool;
+
+	/**
+	 * @brief Returns how many worker threads should be used for parallel work.
+	 *
+	 * @return unsigned int the number of hardware threads (at least 1)
+	 */
+	inline unsigned int getWorkerCount()
+	{
+		unsigned int count = std::thread::hardware_concurrency();
+		return count == 0 ? 1 : count;
+	}
+}
+
+/**
+ * @brief The threads that process the chunks of parallelFor. They are started on first use and kept until the program
+ * exits, so that short parallel loops do not pay for creating threads.
+ *
+ * A thread that waits for its tasks runs queued tasks in the meantime, so nested parallel loops cannot run out of threads.
+ */
+class mygl::ThreadPool {
+public:
+	static ThreadPool & getInstance()
+	{
+		static ThreadPool instance;
+		return instance;
+	}
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool & operator = (const ThreadPool &) = delete;
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->stopping = true;
+		}
+		this->condition.notify_all();
+		for (std::thread & worker : this->workers) worker.join();
+	}
+
+	/**
+	 * @brief Runs the tasks on the workers and on the calling thread and returns when all of them are done.
+	 *
+	 * @param tasks the tasks, which must not throw
+	 */
+	void run(std::vector<std::function<void()>> & tasks)
+	{
+		if (tasks.empty()) return;
+		size_t remaining = tasks.size();
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			for (size_t t = 1; t < tasks.size(); t++) this->queue.push_back({ &tasks[t], &remaining });
+		}
+		this->condition.notify_all();
+
+		std::unique_lock<std::mutex> lock(this->mutex, std::defer_lock);
+		execute({ &tasks[0], &remaining }, lock);
+		while (remaining > 0) {
+			if (!this->queue.empty()) {
+				Task task = this->queue.front();
+				this->queue.pop_front();
+				execute(task, lock);
+			}
+			else {
+				this->condition.wait(lock);
+			}
+		}
+	}
+
+private:
+	struct Task {
+		std::function<void()> * func;
+		size_t * remaining;
+	};
+
+	std::deque<Task> queue;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopping = false;
+	std::vector<std::thread> workers;
+
+	ThreadPool()
+	{
+		for (unsigned int w = 1; w < getWorkerCount(); w++) this->workers.emplace_back(&ThreadPool::work, this);
+	}
+
+	// runs a task with the lock released and returns with the lock held
+	void execute(Task task, std::unique_lock<std::mutex> & lock)
+	{
+		if (lock.owns_lock()) lock.unlock();
+		(*task.func)();
+		lock.lock();
+		if (--*task.remaining == 0) this->condition.notify_all();
+	}
+
+	void work()
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		while (true) {
+			this->condition.wait(lock, [this]() { return this->stopping || !this->queue.empty(); });
+			if (this->queue.empty()) return;
+			Task task = this->queue.front();
+			this->queue.pop_front();
+			execute(task, lock);
+		}
+	}
+};
+
+namespace mygl {
+
+/**
+ * @brief Splits the range [begin, end) into contiguous chunks and processes them on multiple threads.
+ *
+ * Small ranges are processed on the calling thread, the other chunks by the threads of the ThreadPool. An exception
+ * thrown by a chunk is rethrown on the calling thread.
+ *
+ * @param begin the first index of the range
+ * @param end the index after the last index of the range
+ * @param func the function that processes one chunk, called as func(chunk_begin, chunk_end)
+ * @param min_chunk_size the minimal number of elements per chunk
+ */
+template <typename F>
+void parallelFor(size_t begin, size_t end, F func, size_t min_chunk_size = 1024)
+{
+	if (end <= begin) return;
+	const size_t count = end - begin;
+	const size_t max_chunks = (count + min_chunk_size - 1) / std::max<size_t>(min_chunk_size, 1);
+	const size_t chunk_count = std::min<size_t>(getWorkerCount(), std::max<size_t>(max_chunks, 1));
+	if (chunk_count <= 1) {
+		func(begin, end);
+		return;
+	}
+
+	const size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+	std::vector<std::function<void()>> tasks;
+	std::vector<std::exception_ptr> errors(chunk_count);
+	tasks.reserve(chunk_count);
+	for (size_t c = 0; c < chunk_count; c++) {
+		size_t chunk_begin = begin + c * chunk_size;
+		size_t chunk_end = std::min(end, chunk_begin + chunk_size);
+		if (chunk_begin >= chunk_end) break;
+		tasks.emplace_back([&func, &errors, c, chunk_begin, chunk_end]() {
+			try {
+				func(chunk_begin, chunk_end);
+			} catch (...) {
+				errors[c] = std::current_exception();
+			}
+		});
+	}
+	ThreadPool::getInstance().run(tasks);
+	for (std::exception_ptr & error : errors) {
+		if (error) std::rethrow_exception(error);
+	}
+}
+
+/**
+ * @brief Sorts a random access range by sorting chunks on multiple threads and merging them afterwards.
+ *
+ * @param first the beginning of the range
+ * @param last the end of the range
+ * @param comp the comparison function (as for std::sort)
+ * @param min_chunk_size the minimal number of elements per chunk
+ */
+template <typename It, typename Compare>
+void parallelSort(It first, It last, Compare comp, size_t min_chunk_size = 1 << 16)
+{
+	const size_t count = static_cast<size_t>(last - first);
+	const size_t chunk_count = std::min<size_t>(getWorkerCount(), std::max<size_t>(count / std::max<size_t>(min_chunk_size, 1), 1));
+	if (chunk_count <= 1) {
+		std::sort(first, last, comp);
+		return;
+	}
+
+	std::vector<size_t> bounds(chunk_count + 1);
+	for (size_t c = 0; c <= chunk_count; c++) bounds[c] = count * c / chunk_count;
+
+	parallelFor(0, chunk_count, [&](size_t begin, size_t end) {
+		for (size_t c = begin; c < end; c++) std::sort(first + bounds[c], first + bounds[c + 1], comp);
+	}, 1);
+
+	// merge neighboring chunks pairwise until a single sorted range remains
+	while (bounds.size() > 2) {
+		const size_t pairs = (bounds.size() - 1) / 2;
+		parallelFor(0, pairs, [&](size_t begin, size_t end) {
+			for (size_t p = begin; p < end; p++) {
+				std::inplace_merge(first + bounds[p * 2], first + bounds[p * 2 + 1], first + bounds[p * 2 + 2], comp);
+			}
+		}, 1);
+		std::vector<size_t> merged;
+		for (size_t b = 0; b < bounds.size(); b += 2) merged.push_back(bounds[b]);
+		if (merged.back() != bounds.back()) merged.push_back(bounds.back());
+		bounds = std::move(merged);
+	}
+}
+
+}
@@ -0,0 +1,227 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/Camera.hpp>
+#include <mygl/SceneObject.hpp>
+#include <mygl/StreamBuffer.hpp>
+#include <mygl/Parallel.hpp>
+
+namespace mygl {
+	enum class PatchDomain {
+		Triangles,	// 3 control points, barycentric
+		Quads		// 4 control points in cyclic order or a square grid of n * n control points
+	};
+	struct PatchTessellationFactors;
+	struct PatchTessellationOptions;
+	class PatchTessellator;
+
+	/**
+	 * @brief The shader storage binding point the built-in tessellation control shader reads the factors from.
+	 *
+	 */
+	constexpr GLuint PATCH_TESSELLATION_BINDING = 7;
+}
+
+/**
+ * @brief The tessellation levels of a single patch, laid out as the std430 struct of the built-in shaders.
+ *
+ * Triangles use outer.xyz and inner.x, quads use all of them. Outer levels of 0 discard the patch.
+ */
+struct mygl::PatchTessellationFactors {
+	glm::vec4 outer = glm::vec4(1.f);
+	glm::vec2 inner = glm::vec2(1.f);
+	glm::vec2 padding = glm::vec2(0.f);
+};
+
+/**
+ * @brief Controls how the projected size of a patch edge is converted into its tessellation level.
+ *
+ */
+struct mygl::PatchTessellationOptions {
+	/**
+	 * @brief The length in pixels a single segment of an edge should have on screen.
+	 *
+	 */
+	float pixels_per_segment = 8.f;
+
+	float min_level = 1.f;
+
+	/**
+	 * @brief The highest level, 64 is the minimum of GL_MAX_TESS_GEN_LEVEL that every implementation supports.
+	 *
+	 */
+	float max_level = 64.f;
+
+	/**
+	 * @brief Whether patches whose control points lie completely outside of one clip plane are discarded.
+	 * Has to be disabled if the evaluation shader moves the surface beyond the hull of its control points.
+	 */
+	bool cull = true;
+};
+
+namespace mygl {
+
+/**
+ * @brief Returns the number of patches that are drawn from a mesh.
+ *
+ * @param vertex_count the number of vertices
+ * @param index_count the number of indices, 0 if the mesh is not indexed
+ * @param patch_vertices the number of control points per patch
+ * @return size_t the number of complete patches
+ */
+size_t getPatchCount(size_t vertex_count, size_t index_count, GLint patch_vertices);
+
+/**
+ * @brief Calculates the tessellation levels of every patch from the projected length of its edges on multiple threads.
+ *
+ * The level of an edge only depends on its two corner points, so neighboring patches share the level of their common
+ * edge and the tessellation has no cracks. The edge is measured as the screen-space diameter of the sphere around it,
+ * which stays finite for edges that cross the camera plane.
+ *
+ * @param positions the positions of the control points in model space
+ * @param indices the control points of the patches, empty if consecutive positions form the patches
+ * @param patch_vertices the number of control points per patch (3 for triangles, 4 or n * n for quads)
+ * @param domain the domain of the patches
+ * @param model the model matrix
+ * @param view the view matrix
+ * @param projection the projection matrix
+ * @param viewport the size of the viewport in pixels
+ * @param options the conversion into levels
+ * @param factors receives the levels of every patch, must hold getPatchCount patches
+ * @return size_t the number of culled patches
+ */
+size_t calculatePatchTessellationFactors(std::span<const glm::vec3> positions, std::span<const GLuint> indices,
+	GLint patch_vertices, PatchDomain domain, const glm::mat4 & model, const glm::mat4 & view, const glm::mat4 & projection,
+	const glm::vec2 & viewport, const PatchTessellationOptions & options, std::span<PatchTessellationFactors> factors);
+
+}
+
+/**
+ * @brief Calculates the tessellation levels of a GL_PATCHES mesh for the active camera every frame and streams them
+ * into a shader storage buffer for the built-in tessellation shaders.
+ *
+ * Usage per frame: update, bind, draw the mesh with a shader created by createShader, fence.
+ * The built-in shaders read the levels of factors[gl_PrimitiveID], so the mesh has to be drawn with a single draw call.
+ */
+class mygl::PatchTessellator {
+public:
+	/**
+	 * @brief Construct a new PatchTessellator object.
+	 *
+	 * @param patch_capacity the number of patches the buffer is created for, it grows on demand
+	 * @param options the conversion of edge lengths into levels
+	 */
+	PatchTessellator(size_t patch_capacity = 4096, const PatchTessellationOptions & options = PatchTessellationOptions());
+
+	PatchTessellator(const PatchTessellator &) = delete;
+	PatchTessellator & operator = (const PatchTessellator &) = delete;
+
+	/**
+	 * @brief Calculates the levels of all patches of a mesh and writes them into the next region of the buffer.
+	 *
+	 * @param data the mesh, whose vertices provide a position
+	 * @param patch_vertices the number of control points per patch
+	 * @param domain the domain of the patches
+	 * @param model the model matrix of the mesh
+	 * @param camera the active camera
+	 * @param projection the projection matrix
+	 * @param viewport the size of the viewport in pixels
+	 */
+	template <typename T>
+	void update(const MeshData<T> & data, GLint patch_vertices, PatchDomain domain, const glm::mat4 & model,
+		Camera & camera, const glm::mat4 & projection, const glm::vec2 & viewport)
+	{
+		const std::vector<T> & vertices = data.vertices;
+		this->positions.resize(vertices.size());
+		parallelFor(0, vertices.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) this->positions[i] = vertices[i].position;
+		}, 1 << 14);
+
+		std::span<const GLuint> indices;
+		if (data.indices.has_value()) indices = data.indices.value();
+		update(this->positions, indices, patch_vertices, domain, model, camera.getViewMatrix(), projection, viewport);
+	}
+
+	/**
+	 * @brief Calculates the levels of all patches and writes them into the next region of the buffer.
+	 *
+	 * @see calculatePatchTessellationFactors
+	 */
+	void update(std::span<const glm::vec3> positions, std::span<const GLuint> indices, GLint patch_vertices,
+		PatchDomain domain, const glm::mat4 & model, const glm::mat4 & view, const glm::mat4 & projection, const glm::vec2 & viewport);
+
+	/**
+	 * @brief Binds the levels written by the last update to a shader storage binding point.
+	 *
+	 * @param binding the binding point, PATCH_TESSELLATION_BINDING for the built-in shaders
+	 */
+	void bind(GLuint binding = PATCH_TESSELLATION_BINDING);
+
+	/**
+	 * @brief Places a fence after the draw call that read the levels of the last update.
+	 *
+	 */
+	void fence();
+
+	size_t getPatchCount();
+	size_t getCulledCount();
+
+	void setOptions(const PatchTessellationOptions & options);
+	PatchTessellationOptions getOptions();
+
+	/**
+	 * @brief Returns the built-in vertex shader, which passes the attributes of VertexFormat in world space.
+	 *
+	 * @return std::string the GLSL source code
+	 */
+	static std::string getVertexShaderSource();
+
+	/**
+	 * @brief Returns the built-in tessellation control shader, which reads the levels of its patch from the buffer.
+	 *
+	 * @param patch_vertices the number of control points per patch
+	 * @param binding the shader storage binding point of the levels
+	 * @return std::string the GLSL source code
+	 */
+	static std::string getControlShaderSource(GLint patch_vertices, GLuint binding = PATCH_TESSELLATION_BINDING);
+
+	/**
+	 * @brief Returns the built-in tessellation evaluation shader.
+	 *
+	 * Triangles are interpolated barycentric, quads with 4 control points bilinear and quads with n * n control points
+	 * are evaluated as tensor product Bezier patches. The outputs position, normal, uv and tangent are in world space.
+	 *
+	 * @param patch_vertices the number of control points per patch
+	 * @param domain the domain of the patches
+	 * @return std::string the GLSL source code
+	 */
+	static std::string getEvaluationShaderSource(GLint patch_vertices, PatchDomain domain);
+
+	/**
+	 * @brief Creates a shader from the built-in vertex and tessellation shaders and a fragment shader.
+	 *
+	 * @param fragment_source the GLSL source code of the fragment shader, reading position, normal, uv and tangent
+	 * @param patch_vertices the number of control points per patch
+	 * @param domain the domain of the patches
+	 * @param mode the built-in parameters the fragment shader expects
+	 * @return std::shared_ptr<Shader> the shader
+	 */
+	static std::shared_ptr<Shader> createShader(const std::string & fragment_source, GLint patch_vertices, PatchDomain domain,
+		eBuildinTargetShaderMode mode = eBuildinTargetShaderMode::None);
+
+private:
+	PatchTessellationOptions options;
+	std::unique_ptr<StreamBuffer> buffer;
+	size_t patch_capacity;
+	size_t patch_count = 0;
+	size_t culled_count = 0;
+	std::vector<glm::vec3> positions;
+
+	static void checkPatchVertices(GLint patch_vertices, PatchDomain domain);
+};
@@ -13,6 +13,7 @@ namespace mygl {
 /**
  * @brief A generator for 3d planes as in flat surfaces.
  * 
+ * See PlaneMeshGenerator for writing the plane directly into GPU memory.
  */
 class mygl::PlaneGenerator {
 public:
@@ -0,0 +1,218 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <glad/gl.h>
+
+#include <mygl/FrameBuffer.hpp>
+
+namespace mygl {
+	struct RenderTargetDescription;
+	class RenderPassContext;
+	class RenderGraph;
+}
+
+/**
+ * @brief The size and format of a render target. Targets with equal descriptions can share a texture.
+ *
+ */
+struct mygl::RenderTargetDescription {
+	GLsizei width = 800;
+	GLsizei height = 600;
+	GLenum internal_format = GL_RGBA8;
+
+	RenderTargetDescription() {}
+	RenderTargetDescription(GLsizei width, GLsizei height, GLenum internal_format = GL_RGBA8)
+		: width(width), height(height), internal_format(internal_format) {}
+	RenderTargetDescription(const ScreenResolution & resolution, GLenum internal_format = GL_RGBA8)
+		: width(static_cast<GLsizei>(resolution.width)), height(static_cast<GLsizei>(resolution.height)), internal_format(internal_format) {}
+
+	bool isDepth() const;
+	bool operator < (const RenderTargetDescription & other) const;
+	bool operator == (const RenderTargetDescription & other) const;
+};
+
+/**
+ * @brief Gives the execute function of a pass access to the textures of the graph.
+ *
+ */
+class mygl::RenderPassContext {
+public:
+	/**
+	 * @brief Returns the texture that backs a resource during this pass.
+	 *
+	 * @param resource a resource of the graph
+	 * @return GLuint the texture
+	 */
+	GLuint getTexture(size_t resource) const;
+
+	/**
+	 * @brief Binds the texture of a resource with a linear, clamping sampler to an OpenGL texture unit.
+	 *
+	 * @param resource a resource that the pass reads
+	 * @param textureUnit the texture unit to bind the texture to
+	 */
+	void bindTexture(size_t resource, GLenum textureUnit) const;
+
+	/**
+	 * @brief Returns the framebuffer of the written attachments, which is already bound.
+	 *
+	 * @return FrameBuffer * the framebuffer, nullptr if the pass renders into the default framebuffer
+	 */
+	FrameBuffer * getFrameBuffer() const;
+
+private:
+	friend class RenderGraph;
+	RenderPassContext(const RenderGraph & graph, FrameBuffer * frame_buffer) : graph(graph), frame_buffer(frame_buffer) {}
+
+	const RenderGraph & graph;
+	FrameBuffer * frame_buffer;
+};
+
+/**
+ * @brief Schedules the render passes of a frame and allocates their intermediate targets.
+ *
+ * Passes declare the resources they read and write. Every resource is written by exactly one pass, a chain of effects
+ * therefore writes a new resource per step instead of updating one in place. 'compile' culls the passes whose results
+ * are never used, orders the remaining ones after the passes they read from and assigns textures to the transient
+ * resources: resources with equal descriptions whose lifetimes do not overlap share one texture, so a chain of
+ * full resolution effects only needs as many targets as are alive at the same time.
+ *
+ * Imported textures and resources marked as output are kept after the frame, so their passes are never culled and
+ * their textures are never shared. Passes that write nothing render into the default framebuffer and have to be
+ * added as side effects, otherwise they are culled.
+ *
+ * The textures and framebuffers are kept between compilations and reused if the graph is rebuilt with the same
+ * descriptions, e.g. every frame after 'reset'.
+ */
+class mygl::RenderGraph {
+public:
+	typedef std::function<void(RenderPassContext &)> execute_t;
+
+	RenderGraph() {}
+	~RenderGraph();
+
+	RenderGraph(const RenderGraph &) = delete;
+	RenderGraph & operator = (const RenderGraph &) = delete;
+
+	/**
+	 * @brief Declares a target that only lives during the frame and is allocated by the graph.
+	 *
+	 * @param name the name that is used in messages
+	 * @param description the size and format of the target
+	 * @return size_t the resource
+	 */
+	size_t createTexture(const std::string & name, const RenderTargetDescription & description);
+
+	/**
+	 * @brief Declares a texture that is owned by the application, e.g. a shadow map that is sampled in later frames.
+	 *
+	 * @param name the name that is used in messages
+	 * @param texture the texture with a single level
+	 * @param description the size and format of the texture
+	 * @return size_t the resource
+	 */
+	size_t importTexture(const std::string & name, GLuint texture, const RenderTargetDescription & description);
+
+	/**
+	 * @brief Keeps a transient resource after the frame, so that it can be read with getTexture.
+	 *
+	 * @param resource the resource
+	 */
+	void markOutput(size_t resource);
+
+	/**
+	 * @brief Adds a pass to the graph.
+	 *
+	 * @param name the name that is used in messages
+	 * @param reads the resources that the pass samples
+	 * @param writes the resources that the pass renders into, at most one with a depth format
+	 * @param execute renders the pass into the bound framebuffer
+	 * @param side_effect keeps the pass even if nothing reads its results, e.g. for rendering to the screen
+	 * @return size_t the pass
+	 */
+	size_t addPass(const std::string & name, const std::vector<size_t> & reads, const std::vector<size_t> & writes, execute_t execute,
+		bool side_effect = false);
+
+	/**
+	 * @brief Culls and orders the passes and assigns textures and framebuffers to them.
+	 *
+	 * Throws if a transient resource is read but never written or if the passes depend on each other in a cycle.
+	 */
+	void compile();
+
+	/**
+	 * @brief Executes the compiled passes in order, binding the framebuffer and viewport of each pass first.
+	 *
+	 * Passes that render into the default framebuffer get a viewport of the size of the screen.
+	 *
+	 * @param screen_res the size of the default framebuffer
+	 */
+	void execute(const ScreenResolution & screen_res);
+
+	/**
+	 * @brief Removes all passes and resources, but keeps the textures and framebuffers for the next compilation.
+	 *
+	 */
+	void reset();
+
+	/**
+	 * @brief Returns the texture that backs a resource after compiling.
+	 *
+	 * @param resource the resource
+	 * @return GLuint the texture, 0 if the resource is culled
+	 */
+	GLuint getTexture(size_t resource) const;
+
+	bool isCulled(size_t pass) const;
+	const std::vector<size_t> & getPassOrder() const;
+	size_t getTransientCount() const;
+	size_t getAllocatedTextureCount() const;
+
+private:
+	static const size_t NONE = static_cast<size_t>(-1);
+
+	struct Resource {
+		std::string name;
+		RenderTargetDescription description;
+		std::optional<GLuint> imported;
+		bool output = false;
+		size_t writer = NONE;
+		std::vector<size_t> readers;
+		size_t allocation = NONE;
+	};
+
+	struct Pass {
+		std::string name;
+		std::vector<size_t> reads;
+		std::vector<size_t> writes;
+		execute_t execute;
+		bool side_effect = false;
+		bool culled = false;
+		FrameBuffer * frame_buffer = nullptr;
+		RenderTargetDescription viewport;
+	};
+
+	struct Allocation {
+		RenderTargetDescription description;
+		GLuint texture = 0;
+		size_t last_use = NONE;
+	};
+
+	std::vector<Resource> resources;
+	std::vector<Pass> passes;
+	std::vector<size_t> order;
+	std::vector<Allocation> allocations;
+	std::map<std::vector<GLuint>, std::unique_ptr<FrameBuffer>> frame_buffers;
+	bool compiled = false;
+
+	void cull();
+	void sort();
+	void allocate();
+	void createFrameBuffers();
+	void checkResource(size_t resource) const;
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <glad/gl.h>
+
+namespace mygl {
+	struct SamplerDescription;
+	class SamplerCache;
+}
+
+/**
+ * @brief The sampling state of a texture, which is kept in a sampler object instead of the texture itself.
+ *
+ */
+struct mygl::SamplerDescription {
+	GLenum min_filter = GL_LINEAR_MIPMAP_LINEAR;
+	GLenum mag_filter = GL_LINEAR;
+	GLenum wrap_s = GL_REPEAT;
+	GLenum wrap_t = GL_REPEAT;
+
+	/**
+	 * @brief The maximum degree of anisotropic filtering, 0 follows the default of the cache
+	 * (see SamplerCache::setDefaultAnisotropy).
+	 *
+	 */
+	float max_anisotropy = 0.f;
+
+	bool operator < (const SamplerDescription & other) const;
+};
+
+/**
+ * @brief Creates one sampler object per distinct sampling state, which all textures with that state share.
+ *
+ * Since the samplers are shared, changing the default anisotropy changes the filtering of all textures at once.
+ * The cache outlives the OpenGL context, so its samplers have to be deleted with 'release' before the context is.
+ */
+class mygl::SamplerCache {
+public:
+	static SamplerCache & getInstance() {
+		static SamplerCache instance;
+		return instance;
+	}
+
+	SamplerCache(const SamplerCache &) = delete;
+	SamplerCache & operator = (const SamplerCache &) = delete;
+
+	/**
+	 * @brief Returns the sampler object of a sampling state and creates it on first use.
+	 *
+	 * @param description the sampling state
+	 * @return GLuint the sampler object, which is owned by the cache
+	 */
+	GLuint getSampler(const SamplerDescription & description);
+
+	/**
+	 * @brief Sets the anisotropy of all samplers that follow the default, clamped to what the driver supports.
+	 *
+	 * @param anisotropy the maximum degree of anisotropic filtering, 1 disables it
+	 */
+	void setDefaultAnisotropy(float anisotropy);
+	float getDefaultAnisotropy();
+
+	size_t getSamplerCount();
+
+	/**
+	 * @brief Returns how often the samplers were released. Sampler objects that were returned by getSampler before the
+	 * generation changed are deleted and have to be requested again.
+	 *
+	 * @return size_t the generation
+	 */
+	size_t getGeneration();
+
+	/**
+	 * @brief Deletes all sampler objects. Textures that are bound afterwards create their samplers again.
+	 *
+	 */
+	void release();
+
+private:
+	std::map<SamplerDescription, GLuint> samplers;
+	float default_anisotropy = 1.f;
+	size_t generation = 0;
+
+	SamplerCache() {}
+	~SamplerCache() {}
+
+	float getAnisotropy(const SamplerDescription & description);
+};
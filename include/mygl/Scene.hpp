@@ -2,6 +2,8 @@
 #include <vector>
 #include <algorithm>
 #include <memory>
+#include <map>
+#include <tuple>
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
@@ -11,8 +13,10 @@
 #include <mygl/Shader.hpp>
 #include <mygl/Camera.hpp>
 #include <mygl/SceneObject.hpp>
+#include <mygl/StaticBatcher.hpp>
 #include <mygl/SceneLight.hpp>
 #include <mygl/VectorMath.hpp>
+#include <mygl/TextureStreamer.hpp>
 
 namespace mygl {
 	class Scene;
@@ -51,6 +55,65 @@ public:
 		return node;
 	}
 
+	/**
+	 * @brief Merges static meshes that share material, shader and primitive type into a single mesh each.
+	 * 
+	 * Every node that references a SceneMesh<T> with the draw type GL_STATIC_DRAW is a candidate. The vertices of a group
+	 * are transformed into world space, so the merged mesh is added with an identity transformation and the original
+	 * nodes are removed from the scene. Nodes must not be moved afterwards, as the batch no longer refers to them.
+	 * 
+	 * @param min_batch_size the minimal number of nodes that are merged, smaller groups are kept as they are
+	 * @return size_t the number of nodes that were replaced by batches
+	 */
+	template <typename T>
+	size_t batchStaticMeshes(size_t min_batch_size = 2) {
+		typedef std::tuple<Material*, GLuint, GLenum> batch_key_t;
+		std::map<batch_key_t, std::vector<size_t>> groups;
+		std::vector<std::shared_ptr<SceneMesh<T>>> meshes(this->objectNodes.size());
+		for (size_t i = 0; i < this->objectNodes.size(); i++) {
+			meshes[i] = std::dynamic_pointer_cast<SceneMesh<T>>(this->objectNodes[i]->getObject());
+			if (!meshes[i] || !isStaticBatchable(*meshes[i])) continue;
+			groups[batch_key_t(meshes[i]->getMaterial().get(), meshes[i]->getShaderID(), meshes[i]->getGeometryType())].push_back(i);
+		}
+
+		std::vector<bool> replaced(this->objectNodes.size(), false);
+		std::vector<std::shared_ptr<SceneNode<SceneObject>>> batch_nodes;
+		size_t replaced_count = 0;
+		for (const auto & group : groups) {
+			const std::vector<size_t> & members = group.second;
+			if (members.size() < std::max<size_t>(min_batch_size, 1)) continue;
+
+			std::vector<StaticBatchInstance<T>> instances(members.size());
+			for (size_t m = 0; m < members.size(); m++) {
+				instances[m].mesh = meshes[members[m]];
+				instances[m].model = this->objectNodes[members[m]]->calculateModelMatrix();
+				replaced[members[m]] = true;
+			}
+
+			// a batch of meshes that released their data releases its own data as well
+			const std::shared_ptr<SceneMesh<T>> & first = meshes[members.front()];
+			const bool gpu_only = std::all_of(instances.begin(), instances.end(), [](const StaticBatchInstance<T> & instance) {
+				return instance.mesh->getResidency() == MeshResidency::GpuOnly;
+			});
+			std::shared_ptr<SceneMesh<T>> batch(new SceneMesh<T>(mergeStaticMeshes(instances), GL_STATIC_DRAW,
+				first->getGeometryType(), first->getMaterial(), gpu_only ? MeshResidency::GpuOnly : MeshResidency::CpuAndGpu));
+			batch->setShaderID(first->getShaderID());
+			batch->setDebugName("static_batch(" + first->getDebugName() + ")");
+			batch_nodes.push_back(std::shared_ptr<SceneNode<SceneObject>>(new SceneNode<SceneObject>(batch)));
+			replaced_count += members.size();
+		}
+		if (replaced_count == 0) return 0;
+
+		std::vector<std::shared_ptr<SceneNode<SceneObject>>> remaining;
+		remaining.reserve(this->objectNodes.size() - replaced_count + batch_nodes.size());
+		for (size_t i = 0; i < this->objectNodes.size(); i++) {
+			if (!replaced[i]) remaining.push_back(this->objectNodes[i]);
+		}
+		remaining.insert(remaining.end(), batch_nodes.begin(), batch_nodes.end());
+		this->objectNodes = std::move(remaining);
+		return replaced_count;
+	}
+
 	/**
 	 * @brief Adds a point lightsource to the scene.
 	 * 
@@ -88,6 +151,19 @@ public:
 	 */
 	void draw(ShaderConfiguration * configuration, std::map<GLuint, FrameBuffer*> & map_shader_fbs);
 
+	/**
+	 * @brief Requests the texture levels that the materials of all visible objects need for the active camera.
+	 * 
+	 * The screen extent of an object is estimated from its bounding sphere at the distance of its closest point.
+	 * Objects outside of the view frustum request nothing, objects without bounds request their finest levels.
+	 * Call TextureStreamer::update afterwards.
+	 * 
+	 * @param streamer the streamer that receives the requests
+	 * @param projection the projection matrix of the frame
+	 * @param viewport the size of the viewport in pixels
+	 */
+	void requestTextures(TextureStreamer & streamer, const glm::mat4 & projection, const glm::vec2 & viewport);
+
 	/**
 	 * @brief Processes keyboard inputs for the scene.
 	 * 
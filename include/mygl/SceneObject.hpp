@@ -2,6 +2,9 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <functional>
+#include <numeric>
+#include <optional>
 #include <stdexcept>
 
 #include <glad/gl.h>
@@ -10,11 +13,19 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <mygl/VertexFormat.hpp>
+#include <mygl/IndexFormat.hpp>
+#include <mygl/StreamBuffer.hpp>
+#include <mygl/BufferHeap.hpp>
+#include <mygl/Bounds.hpp>
 #include <mygl/Material.hpp>
 #include <mygl/IdManager.hpp>
 #include <mygl/Shader.hpp>
 
 namespace mygl {
+	enum class MeshResidency {
+		CpuAndGpu,	// the mesh data stays in memory after the upload
+		GpuOnly		// the mesh data is released after the upload, only counts and bounds are kept
+	};
 	template <typename T> class MeshData;
 	class SceneObject;
 	template <typename T> class SceneMesh;
@@ -29,38 +40,48 @@ public:
 		
 	}
 
-	~MeshData()
-	{
-		this->vertices.clear();
-		this->vertices.shrink_to_fit();
-		if (this->indices.has_value())
-		{
-			auto indices_vector = this->indices.value();
-			indices_vector.clear();
-			indices_vector.shrink_to_fit();
-		}
-	}
-
 	std::vector<T> vertices;
 	std::optional<std::vector<GLuint>> indices = std::nullopt;
-	void unionize(MeshData<T>& other) {
-		size_t current_vertices_size = this->vertices.size();
-		size_t current_indices_size = this->indices.value().size();
-		size_t other_vertices_size = other.vertices.size();
-		size_t other_indices_size = other.indices.value().size();
-
-		bool this_has_indices = this->indices.has_value();
-		bool other_has_indices = other.indices.has_value();
-
-		if (this_has_indices == other_has_indices) {
-			this->vertices.reserve(current_vertices_size + other_vertices_size);
-			std::copy(other.vertices.begin(), other.vertices.end(), std::back_inserter(this->vertices));
-
-			if (this_has_indices && other_has_indices) {
-				this->indices.value().reserve(current_indices_size + other_indices_size);
-				std::transform(other.indices.value().begin(), other.indices.value().end(), std::back_inserter(this->indices.value()),
-					[current_vertices_size](GLuint x) -> GLuint { return x + current_vertices_size; });
-			}
+
+	/**
+	 * @brief Whether the indices contain RESTART_INDEX to separate strips or fans.
+	 *
+	 */
+	bool primitive_restart = false;
+
+	/**
+	 * @brief Appends the vertices and indices of another mesh to this mesh.
+	 * 
+	 * If only one of the meshes is indexed, the other one receives sequential indices, so that the result stays valid.
+	 * 
+	 * @param other the mesh that will be appended
+	 */
+	void unionize(const MeshData<T>& other) {
+		const size_t current_vertices_size = this->vertices.size();
+		const bool this_has_indices = this->indices.has_value();
+		const bool other_has_indices = other.indices.has_value();
+
+		if (!this_has_indices && other_has_indices) {
+			this->indices = std::vector<GLuint>(current_vertices_size);
+			std::iota(this->indices.value().begin(), this->indices.value().end(), 0);
+		}
+
+		this->vertices.insert(this->vertices.end(), other.vertices.begin(), other.vertices.end());
+		if (!this->indices.has_value()) return;
+
+		std::vector<GLuint> & this_indices = this->indices.value();
+		const GLuint offset = static_cast<GLuint>(current_vertices_size);
+		if (other_has_indices) {
+			const std::vector<GLuint> & other_indices = other.indices.value();
+			const size_t first = this_indices.size();
+			this_indices.resize(first + other_indices.size());
+			std::transform(other_indices.begin(), other_indices.end(), this_indices.begin() + first,
+				[offset](GLuint x) -> GLuint { return x == RESTART_INDEX ? x : x + offset; });
+		}
+		else {
+			const size_t first = this_indices.size();
+			this_indices.resize(first + other.vertices.size());
+			std::iota(this_indices.begin() + first, this_indices.end(), offset);
 		}
 	}
 private:
@@ -124,6 +145,13 @@ public:
 	 */
 	virtual void setMaterial(std::shared_ptr<Material> material) { this->material = material; }
 
+	/**
+	 * @brief Returns the bounds of the object in model space.
+	 * 
+	 * @return Bounds the bounds, a radius of 0 if they are unknown
+	 */
+	virtual Bounds getBounds() { return Bounds(); }
+
 private:
 	std::shared_ptr<Material> material;
 	GLuint ID = 0;
@@ -144,68 +172,131 @@ public:
 	/**
 	 * @brief Construct a new SceneMesh object.
 	 * 
+	 * The vertices and indices are stored in a single allocation of the shared BufferHeap and are drawn with the vertex
+	 * array of its page, so a mesh owns no buffer objects of its own.
+	 * Meshes with the draw type GL_STREAM_DRAW keep their vertices in a persistently mapped, triple-buffered ring,
+	 * so that they can be updated every frame without stalling or reallocating.
+	 * 
 	 * @param vertices the vertices that define the structure of the mesh
 	 * @param drawType the OpenGL draw type that specifies how the mesh will be rendered - e.g. GL_STATIC_DRAW
 	 * @param material the material that defines the appearance of the mesh
+	 * @param residency whether the mesh keeps its data in memory after the upload
 	 */
 	SceneMesh(std::shared_ptr<MeshData<T>> data, GLenum draw_type, GLenum geometry_type = GL_TRIANGLES,
-		std::shared_ptr<Material> material = std::shared_ptr<Material>(new Material()))
+		std::shared_ptr<Material> material = std::shared_ptr<Material>(new Material()),
+		MeshResidency residency = MeshResidency::CpuAndGpu)
+		: SceneMesh(data, draw_type, geometry_type, material, true)
 	{
-		glGenVertexArrays(1, &VAO);
-		glGenBuffers(1, &VBO);
-		glGenBuffers(1, &EBO);
+		setResidency(residency);
+	}
 
-		this->draw_type = draw_type;
+	/**
+	 * @brief Construct a new static SceneMesh object directly from vertex and index memory, e.g. a mapped mesh file.
+	 * 
+	 * The memory is uploaded as it is, without conversion or chunking. The mesh keeps no CPU copy, so getData returns
+	 * empty mesh data until 'update' is called.
+	 * 
+	 * @param vertices the vertices in the layout of T
+	 * @param vertex_count the number of vertices
+	 * @param indices the indices (nullptr for non-indexed meshes)
+	 * @param index_count the number of indices
+	 * @param index_type GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	 * @param geometry_type the OpenGL primitive type
+	 * @param material the material that defines the appearance of the mesh
+	 * @param primitive_restart whether the indices contain the fixed restart index of their type
+	 */
+	SceneMesh(const T * vertices, size_t vertex_count, const void * indices, size_t index_count, GLenum index_type,
+		GLenum geometry_type = GL_TRIANGLES, std::shared_ptr<Material> material = std::shared_ptr<Material>(new Material()),
+		bool primitive_restart = false)
+	{
+		this->draw_type = GL_STATIC_DRAW;
 		this->geometry_type = geometry_type;
-		this->data = data;
+		this->data = std::shared_ptr<MeshData<T>>(new MeshData<T>());
+		this->data_released = true;
 		setMaterial(material);
 
-		glBindVertexArray(VAO);
-
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(T) * this->data->vertices.size(), &this->data->vertices[0], draw_type);
-
-		if (this->data->indices.has_value()) {
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * this->data->indices.value().size(), &this->data->indices.value()[0], draw_type);
+		this->vertex_count = vertex_count;
+		if (indices && index_count > 0) {
+			this->index_type = index_type;
+			this->index_count = index_count;
+			this->primitive_restart = primitive_restart && isStripGeometry(geometry_type);
+			this->index_chunks.push_back({ 0, index_count, 0 });
 		}
+		reserveAllocation(sizeof(T) * vertex_count, getIndexSize(this->index_type) * this->index_count);
+		if (this->allocation == BufferHeap::INVALID_HANDLE) return;
 
-		vertex_format_t::registerFormat();
+		BufferHeap & heap = BufferHeap::getInstance();
+		heap.upload(this->allocation, 0, vertices, sizeof(T) * vertex_count);
+		heap.upload(this->allocation, this->index_byte_offset, indices, getIndexSize(this->index_type) * this->index_count);
+	}
 
-		glBindVertexArray(0);
+	/**
+	 * @brief Construct a new static SceneMesh object whose geometry is written directly into its mapped allocation.
+	 * 
+	 * Like the raw constructor, the mesh keeps no CPU copy of the geometry.
+	 * 
+	 * @param vertex_count the number of vertices
+	 * @param index_count the number of indices (0 for non-indexed meshes)
+	 * @param geometry_type the OpenGL primitive type
+	 * @param material the material that defines the appearance of the mesh
+	 * @param writer receives the memory for the vertices, the memory for the indices and their type
+	 * (GL_UNSIGNED_SHORT if all vertices can be addressed with 16 bit, GL_UNSIGNED_INT else)
+	 */
+	SceneMesh(size_t vertex_count, size_t index_count, GLenum geometry_type, std::shared_ptr<Material> material,
+		const std::function<void(T*, void*, GLenum)> & writer)
+	{
+		this->draw_type = GL_STATIC_DRAW;
+		this->geometry_type = geometry_type;
+		this->data = std::shared_ptr<MeshData<T>>(new MeshData<T>());
+		this->data_released = true;
+		setMaterial(material);
+
+		this->vertex_count = vertex_count;
+		if (index_count > 0) {
+			this->index_type = chooseIndexType(vertex_count);
+			this->index_count = index_count;
+			this->index_chunks.push_back({ 0, index_count, 0 });
+		}
+		reserveAllocation(sizeof(T) * vertex_count, getIndexSize(this->index_type) * this->index_count);
+		if (this->allocation == BufferHeap::INVALID_HANDLE) return;
+
+		BufferHeap & heap = BufferHeap::getInstance();
+		unsigned char * mapped = static_cast<unsigned char*>(heap.map(this->allocation));
+		if (mapped) {
+			writer(reinterpret_cast<T*>(mapped), mapped + this->index_byte_offset, this->index_type);
+			heap.unmap(this->allocation);
+		}
+		else {
+			std::vector<unsigned char> staging(this->index_byte_offset + getIndexSize(this->index_type) * this->index_count);
+			writer(reinterpret_cast<T*>(staging.data()), staging.data() + this->index_byte_offset, this->index_type);
+			heap.upload(this->allocation, 0, staging.data(), staging.size());
+		}
 	}
 
-	~SceneMesh()
+	virtual ~SceneMesh()
 	{
-		glDeleteVertexArrays(1, &VAO);
-		glDeleteBuffers(1, &VBO);
-		glDeleteBuffers(1, &EBO);
+		BufferHeap::getInstance().free(this->allocation);
+		if (this->stream_vertex_array != 0) glDeleteVertexArrays(1, &this->stream_vertex_array);
 	}
 
 	/**
 	 * @brief Updates the vertex data and the draw type of the mesh.
 	 * 
+	 * The existing allocation is reused if the new data fits into it. With the residency GpuOnly the data is released
+	 * again after the upload.
+	 * 
 	 * @param vertices the new vertices that will replace the old vertices
 	 * @param drawType the new value for the OpenGL draw type
 	 */
-	void update(std::shared_ptr<MeshData<T>> data, GLenum draw_type, GLenum geometry_type)
+	virtual void update(std::shared_ptr<MeshData<T>> data, GLenum draw_type, GLenum geometry_type)
 	{
 		this->data = data;
+		this->data_released = false;
+		this->bounds_valid = false;
 		this->draw_type = draw_type;
 		this->geometry_type = geometry_type;
-
-		glBindVertexArray(VAO);
-
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(T) * this->data->vertices.size(), NULL, draw_type);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(T) * this->data->vertices.size(), this->data->vertices.data(), draw_type);
-
-		bool has_indices = data->indices.has_value();
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, has_indices ? sizeof(GLuint) * this->data->indices.value().size() : 0,
-			has_indices ? &this->data->indices.value()[0] : NULL, draw_type);
-
-		glBindVertexArray(0);
+		upload();
+		if (this->residency == MeshResidency::GpuOnly) releaseData();
 	}
 
 	/**
@@ -215,7 +306,65 @@ public:
 	 */
 	void update(std::shared_ptr<MeshData<T>> data)
 	{
-		SceneMesh::update(data, this->draw_type, this->geometry_type);
+		update(data, this->draw_type, this->geometry_type);
+	}
+
+	/**
+	 * @brief Uploads a range of vertices after they were modified inside of the current mesh data.
+	 * 
+	 * Only the given range is transferred. The number of vertices must not have changed, use 'update' otherwise.
+	 * Released mesh data has to be downloaded with 'downloadData' before it can be modified.
+	 * 
+	 * @param first the index of the first modified vertex
+	 * @param count the number of modified vertices
+	 */
+	void updateVertices(size_t first, size_t count)
+	{
+		const size_t vertex_total = this->data->vertices.size();
+		if (first >= vertex_total) return;
+		count = std::min(count, vertex_total - first);
+		if (count == 0) return;
+		this->bounds_valid = false;
+
+		if (this->chunked) {
+			// the uploaded vertices are rearranged into 16 bit chunks and no longer match the mesh data
+			update(this->data);
+		}
+		else if (this->stream) {
+			writeStreamRange(first, count);
+		}
+		else {
+			BufferHeap::getInstance().upload(this->allocation, sizeof(T) * first, &this->data->vertices[first], sizeof(T) * count);
+		}
+	}
+
+	/**
+	 * @brief Uploads a range of indices after they were modified inside of the current mesh data.
+	 * 
+	 * Only the given range is transferred. The number of indices must not have changed, use 'update' otherwise.
+	 * 
+	 * @param first the position of the first modified index
+	 * @param count the number of modified indices
+	 */
+	void updateIndices(size_t first, size_t count)
+	{
+		if (!this->data->indices.has_value()) return;
+		const std::vector<GLuint> & indices = this->data->indices.value();
+		if (first >= indices.size()) return;
+		count = std::min(count, indices.size() - first);
+		if (count == 0) return;
+
+		if (this->chunked) {
+			update(this->data);
+		}
+		else if (this->index_type == GL_UNSIGNED_SHORT) {
+			std::vector<GLuint> range(indices.begin() + first, indices.begin() + first + count);
+			std::vector<GLushort> packed = packIndices16(range);
+			BufferHeap::getInstance().upload(this->allocation, this->index_byte_offset + sizeof(GLushort) * first, packed.data(), sizeof(GLushort) * count);
+		}
+		else {
+			BufferHeap::getInstance().upload(this->allocation, this->index_byte_offset + sizeof(GLuint) * first, &indices[first], sizeof(GLuint) * count);
+		}
 	}
 
 	/**
@@ -227,7 +376,9 @@ public:
 		object_configuration->setMaterial("material", getMaterial());
 		configureShader(scene_configuration, object_configuration);
 
-		glBindVertexArray(VAO);
+		const GLuint vertex_array = getVertexArray();
+		if (vertex_array == 0) return;
+		glBindVertexArray(vertex_array);
 
 		switch (this->geometry_type)
 		{
@@ -247,21 +398,430 @@ public:
 			break;
 		}
 
-		if (data->indices.has_value()) {
-			glDrawElements(this->geometry_type, static_cast<GLsizei>(data->indices.value().size()), GL_UNSIGNED_INT, 0);
+		const GLint base_vertex = getBaseVertex();
+		if (this->index_count > 0) {
+			// the private vertex array of a streamed mesh reads its indices from the heap page
+			if (this->stream) glVertexArrayElementBuffer(vertex_array, getIndexBuffer());
+			if (this->primitive_restart) glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+			const size_t index_size = getIndexSize(this->index_type);
+			const size_t index_begin = getIndexByteOffset();
+			for (const IndexChunk & chunk : this->index_chunks) {
+				glDrawElementsBaseVertex(this->geometry_type, static_cast<GLsizei>(chunk.index_count), this->index_type,
+					reinterpret_cast<void*>(index_begin + chunk.index_offset * index_size), chunk.base_vertex + base_vertex);
+			}
+			if (this->primitive_restart) glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
 		}
 		else {
-			glDrawArrays(this->geometry_type, 0, static_cast<GLsizei>(data->vertices.size()));
+			glDrawArrays(this->geometry_type, base_vertex, static_cast<GLsizei>(this->vertex_count));
 		}
 
+		if (this->stream) this->stream->fenceCurrentRegion();
+
 		glBindVertexArray(0);
 	}
 
+	/**
+	 * @brief Returns the OpenGL type of the uploaded indices.
+	 * 
+	 * @return GLenum GL_UNSIGNED_SHORT if all vertices can be addressed with 16 bit, GL_UNSIGNED_INT else
+	 */
+	GLenum getIndexType() { return this->index_type; }
+
+	/**
+	 * @brief Returns the mesh data that was uploaded last.
+	 * 
+	 * @return std::shared_ptr<MeshData<T>> the mesh data
+	 */
+	std::shared_ptr<MeshData<T>> getData() { return this->data; }
+
+	/**
+	 * @brief Sets whether the mesh keeps its data in memory after the upload.
+	 * 
+	 * GpuOnly releases the current data immediately and after every 'update'. Streamed meshes rewrite their vertices
+	 * every frame and always keep their data.
+	 * 
+	 * @param residency the new residency
+	 */
+	void setResidency(MeshResidency residency)
+	{
+		this->residency = residency;
+		if (residency == MeshResidency::GpuOnly) releaseData();
+	}
+
+	MeshResidency getResidency() { return this->residency; }
+
+	/**
+	 * @brief Drops the reference to the mesh data, so that its memory is freed unless it is shared with others.
+	 * 
+	 * The counts, the bounds and the uploaded geometry are kept. getData returns empty mesh data afterwards.
+	 */
+	void releaseData()
+	{
+		if (this->data_released || this->stream) return;
+		getBounds();
+		this->data = std::shared_ptr<MeshData<T>>(new MeshData<T>());
+		this->data_released = true;
+	}
+
+	/**
+	 * @brief Returns whether the mesh data is held in memory.
+	 * 
+	 * @return true if getData returns the uploaded geometry
+	 * @return false if the mesh data was released or never existed
+	 */
+	bool isDataResident() { return !this->data_released; }
+
+	/**
+	 * @brief Returns the number of uploaded vertices, which is kept when the data is released.
+	 * 
+	 * @return size_t the vertex count
+	 */
+	size_t getVertexCount() { return this->vertex_count; }
+
+	/**
+	 * @brief Returns the mesh data and reads it back from the GPU if it was released.
+	 * 
+	 * The downloaded data becomes the data of the mesh again, call 'releaseData' once it is no longer needed.
+	 * Meshes that were split into 16 bit chunks are returned in their chunked vertex order with rebased indices.
+	 * 
+	 * @return std::shared_ptr<MeshData<T>> the mesh data
+	 */
+	std::shared_ptr<MeshData<T>> downloadData()
+	{
+		if (!this->data_released) return this->data;
+
+		std::shared_ptr<MeshData<T>> downloaded(new MeshData<T>());
+		downloaded->primitive_restart = this->primitive_restart;
+		if (this->allocation != BufferHeap::INVALID_HANDLE) {
+			BufferHeap & heap = BufferHeap::getInstance();
+			// vertex formats are not default constructible, so the vertices are read into raw memory first
+			std::vector<unsigned char> staging(sizeof(T) * this->vertex_count);
+			heap.download(this->allocation, 0, staging.data(), staging.size());
+			const T * vertices = reinterpret_cast<const T*>(staging.data());
+			downloaded->vertices.assign(vertices, vertices + this->vertex_count);
+
+			if (this->index_count > 0) {
+				std::vector<GLuint> indices(this->index_count);
+				if (this->index_type == GL_UNSIGNED_SHORT) {
+					std::vector<GLushort> packed(this->index_count);
+					heap.download(this->allocation, this->index_byte_offset, packed.data(), sizeof(GLushort) * this->index_count);
+					std::copy(packed.begin(), packed.end(), indices.begin());
+				}
+				else {
+					heap.download(this->allocation, this->index_byte_offset, indices.data(), sizeof(GLuint) * this->index_count);
+				}
+				for (const IndexChunk & chunk : this->index_chunks) {
+					for (size_t i = chunk.index_offset; i < chunk.index_offset + chunk.index_count; i++) {
+						const bool restart = this->primitive_restart && indices[i] == (this->index_type == GL_UNSIGNED_SHORT ? 0xFFFF : RESTART_INDEX);
+						indices[i] = restart ? RESTART_INDEX : indices[i] + static_cast<GLuint>(chunk.base_vertex);
+					}
+				}
+				downloaded->indices = std::move(indices);
+			}
+		}
+
+		this->data = downloaded;
+		this->data_released = false;
+		return downloaded;
+	}
+
+	/**
+	 * @brief Returns the bounds of the vertices in model space.
+	 * 
+	 * The bounds are calculated from the mesh data on first use and kept when the data is released. Meshes that were
+	 * created without mesh data return empty bounds until they are set with 'setBounds'.
+	 * 
+	 * @return Bounds the bounds
+	 */
+	Bounds getBounds()
+	{
+		if (!this->bounds_valid && !this->data_released) {
+			std::vector<glm::vec3> positions(this->data->vertices.size());
+			for (size_t v = 0; v < positions.size(); v++) positions[v] = this->data->vertices[v].position;
+			this->bounds = calculateBounds(positions);
+			this->bounds_valid = true;
+		}
+		return this->bounds;
+	}
+
+	void setBounds(const Bounds & bounds)
+	{
+		this->bounds = bounds;
+		this->bounds_valid = true;
+	}
+
+	/**
+	 * @brief Returns the OpenGL draw type of the mesh.
+	 * 
+	 * @return GLenum the draw type, e.g. GL_STATIC_DRAW
+	 */
+	GLenum getDrawType() { return this->draw_type; }
+
+	/**
+	 * @brief Returns the OpenGL primitive type of the mesh.
+	 * 
+	 * @return GLenum the primitive type, e.g. GL_TRIANGLES
+	 */
+	GLenum getGeometryType() { return this->geometry_type; }
+
+protected:
+	/**
+	 * @brief Construct a new SceneMesh object.
+	 * 
+	 * @param allow_chunking whether large static triangle lists may be rearranged into 16 bit chunks, subclasses that
+	 * address the vertices with their own indices have to disable it
+	 */
+	SceneMesh(std::shared_ptr<MeshData<T>> data, GLenum draw_type, GLenum geometry_type, std::shared_ptr<Material> material,
+		bool allow_chunking)
+	{
+		this->draw_type = draw_type;
+		this->geometry_type = geometry_type;
+		this->data = data;
+		this->allow_chunking = allow_chunking;
+		setMaterial(material);
+		upload();
+	}
+
+	/**
+	 * @brief Returns the vertex array to draw with, the shared one of the heap page or the private one of a stream.
+	 * 
+	 * @return GLuint the vertex array, 0 if the mesh is empty
+	 */
+	GLuint getVertexArray()
+	{
+		if (this->stream) return this->stream_vertex_array;
+		if (this->allocation == BufferHeap::INVALID_HANDLE) return 0;
+		return BufferHeap::getInstance().getVertexArray<vertex_format_t>(BufferHeap::getInstance().get(this->allocation).page);
+	}
+
+	/**
+	 * @brief Returns the base vertex of the first vertex of the mesh inside of the buffer of the vertex array.
+	 * 
+	 * @return GLint the base vertex
+	 */
+	GLint getBaseVertex()
+	{
+		// streamed vertices are read from the region that was written last
+		if (this->stream) return static_cast<GLint>(this->stream->getCurrentRegionIndex() * this->stream_capacity);
+		if (this->allocation == BufferHeap::INVALID_HANDLE) return 0;
+		return static_cast<GLint>(BufferHeap::getInstance().get(this->allocation).offset / sizeof(T));
+	}
+
+	/**
+	 * @brief Returns the buffer that holds the indices of the mesh.
+	 * 
+	 * @return GLuint the buffer of the heap page, 0 if the mesh has no allocation
+	 */
+	GLuint getIndexBuffer()
+	{
+		if (this->allocation == BufferHeap::INVALID_HANDLE) return 0;
+		return BufferHeap::getInstance().get(this->allocation).buffer;
+	}
+
+	/**
+	 * @brief Returns the byte offset of the first index inside of the index buffer.
+	 * 
+	 * @return size_t the byte offset
+	 */
+	size_t getIndexByteOffset()
+	{
+		return BufferHeap::getInstance().get(this->allocation).offset + this->index_byte_offset;
+	}
+
 private:
-	GLuint VBO, VAO, EBO;
 	GLenum draw_type;
 	GLenum geometry_type;
 	std::shared_ptr<MeshData<T>> data;
+	size_t vertex_count = 0;
+	size_t index_count = 0;
+	GLenum index_type = GL_UNSIGNED_INT;
+
+	MeshResidency residency = MeshResidency::CpuAndGpu;
+	bool data_released = false;
+	Bounds bounds;
+	bool bounds_valid = false;
+
+	// vertices followed by the indices, inside of the shared buffer heap
+	BufferHeap::Handle allocation = BufferHeap::INVALID_HANDLE;
+	size_t index_byte_offset = 0;
+	bool primitive_restart = false;
+	bool chunked = false;
+	bool allow_chunking = true;
+	std::vector<IndexChunk> index_chunks;
+
+	// ring of vertex regions for meshes with the draw type GL_STREAM_DRAW
+	std::unique_ptr<StreamBuffer> stream;
+	GLuint stream_vertex_array = 0;
+	size_t stream_capacity = 0;
+	std::vector<std::vector<std::pair<size_t, size_t>>> stream_pending_ranges;
+
+	static const size_t MAX_PENDING_RANGES = 8;
+
+	/**
+	 * @brief Makes sure that the heap allocation holds the vertices followed by the indices.
+	 * 
+	 * The allocation is only replaced if the data does not fit. Its offset is a multiple of the vertex size, so that
+	 * the mesh can be addressed with a base vertex, and of the index size.
+	 */
+	void reserveAllocation(size_t vertex_bytes, size_t index_bytes)
+	{
+		BufferHeap & heap = BufferHeap::getInstance();
+		this->index_byte_offset = (vertex_bytes + sizeof(GLuint) - 1) / sizeof(GLuint) * sizeof(GLuint);
+		const size_t size = this->index_byte_offset + index_bytes;
+		if (size == 0) {
+			heap.free(this->allocation);
+			this->allocation = BufferHeap::INVALID_HANDLE;
+			return;
+		}
+		if (this->allocation != BufferHeap::INVALID_HANDLE && size <= heap.get(this->allocation).size) return;
+
+		heap.free(this->allocation);
+		this->allocation = heap.allocate(size, std::lcm(sizeof(T), sizeof(GLuint)));
+	}
+
+	/**
+	 * @brief Makes sure that the stream ring can hold the given number of vertices per region.
+	 */
+	void reserveStream(size_t vertex_total)
+	{
+		if (this->stream && vertex_total <= this->stream_capacity) return;
+
+		// grow with some headroom, so that slowly growing meshes do not reallocate every frame
+		this->stream_capacity = std::max<size_t>(vertex_total + vertex_total / 2, 64);
+		this->stream.reset(new StreamBuffer(sizeof(T) * this->stream_capacity));
+		this->stream_pending_ranges.assign(this->stream->getRegionCount(), {});
+
+		if (this->stream_vertex_array == 0) glGenVertexArrays(1, &this->stream_vertex_array);
+		glBindVertexArray(this->stream_vertex_array);
+		glBindBuffer(GL_ARRAY_BUFFER, this->stream->getID());
+		vertex_format_t::registerFormat();
+		glBindVertexArray(0);
+	}
+
+	/**
+	 * @brief Writes a range of vertices into the next region of the stream ring.
+	 * 
+	 * The region also receives all ranges that were modified since it was written the last time.
+	 */
+	void writeStreamRange(size_t first, size_t count)
+	{
+		T * region = static_cast<T*>(this->stream->beginWrite());
+		const unsigned int region_index = this->stream->getCurrentRegionIndex();
+		const std::vector<T> & vertices = this->data->vertices;
+
+		auto & pending = this->stream_pending_ranges[region_index];
+		pending.push_back({ first, first + count });
+		for (const auto & range : pending) {
+			std::copy(vertices.begin() + range.first, vertices.begin() + range.second, region + range.first);
+		}
+		pending.clear();
+
+		for (unsigned int r = 0; r < this->stream_pending_ranges.size(); r++) {
+			if (r == region_index) continue;
+			auto & other = this->stream_pending_ranges[r];
+			other.push_back({ first, first + count });
+			if (other.size() > MAX_PENDING_RANGES) {
+				// merge into a single covering range to bound the bookkeeping
+				size_t range_begin = other.front().first, range_end = other.front().second;
+				for (const auto & range : other) {
+					range_begin = std::min(range_begin, range.first);
+					range_end = std::max(range_end, range.second);
+				}
+				other.assign(1, { range_begin, range_end });
+			}
+		}
+	}
+
+	/**
+	 * @brief Uploads the vertices and indices into the heap allocation of the mesh.
+	 * 
+	 * Indices are stored with 16 bit whenever the vertex count allows it. Larger static triangle lists are split into
+	 * chunks of at most MAX_VERTICES_16BIT vertices, that are drawn with a base vertex each.
+	 * The allocation is only replaced if the new data does not fit into it.
+	 */
+	void upload()
+	{
+		const std::vector<T> & vertices = this->data->vertices;
+		const bool has_indices = this->data->indices.has_value() && !this->data->indices.value().empty();
+		const bool use_stream = this->draw_type == GL_STREAM_DRAW;
+		this->primitive_restart = has_indices && this->data->primitive_restart && isStripGeometry(this->geometry_type);
+		this->index_chunks.clear();
+		this->index_count = 0;
+		this->index_type = GL_UNSIGNED_INT;
+		this->vertex_count = vertices.size();
+		this->chunked = false;
+
+		if (!use_stream && this->stream) {
+			// switch back to the shared vertex array of the heap
+			this->stream.reset();
+			this->stream_capacity = 0;
+			glDeleteVertexArrays(1, &this->stream_vertex_array);
+			this->stream_vertex_array = 0;
+		}
+		BufferHeap & heap = BufferHeap::getInstance();
+
+		const bool split_16bit = this->allow_chunking && has_indices && !use_stream && this->geometry_type == GL_TRIANGLES && this->draw_type == GL_STATIC_DRAW
+			&& chooseIndexType(vertices.size()) == GL_UNSIGNED_INT;
+
+		if (split_16bit) {
+			std::vector<GLuint> vertex_order;
+			std::vector<GLushort> packed;
+			this->index_chunks = splitIndices16(this->data->indices.value(), vertex_order, packed);
+			this->index_type = GL_UNSIGNED_SHORT;
+			this->index_count = packed.size();
+			this->vertex_count = vertex_order.size();
+			this->chunked = true;
+
+			// fill the chunked vertices and the indices in place
+			reserveAllocation(sizeof(T) * vertex_order.size(), sizeof(GLushort) * packed.size());
+			if (this->allocation == BufferHeap::INVALID_HANDLE) return;
+			auto write = [&](unsigned char * memory) {
+				T * target = reinterpret_cast<T*>(memory);
+				for (size_t i = 0; i < vertex_order.size(); i++) target[i] = vertices[vertex_order[i]];
+				std::copy(packed.begin(), packed.end(), reinterpret_cast<GLushort*>(memory + this->index_byte_offset));
+			};
+			unsigned char * mapped = static_cast<unsigned char*>(heap.map(this->allocation));
+			if (mapped) {
+				write(mapped);
+				heap.unmap(this->allocation);
+			}
+			else {
+				std::vector<unsigned char> staging(this->index_byte_offset + sizeof(GLushort) * packed.size());
+				write(staging.data());
+				heap.upload(this->allocation, 0, staging.data(), staging.size());
+			}
+			return;
+		}
+
+		// streamed vertices live in the ring, the allocation only holds the indices
+		const size_t vertex_bytes = use_stream ? 0 : sizeof(T) * vertices.size();
+		const bool indices_16bit = has_indices && chooseIndexType(vertices.size()) == GL_UNSIGNED_SHORT;
+		const size_t index_bytes = has_indices ? (indices_16bit ? sizeof(GLushort) : sizeof(GLuint)) * this->data->indices.value().size() : 0;
+		reserveAllocation(vertex_bytes, index_bytes);
+
+		if (use_stream) {
+			reserveStream(vertices.size());
+			if (!vertices.empty()) writeStreamRange(0, vertices.size());
+		}
+		else if (vertex_bytes > 0) {
+			heap.upload(this->allocation, 0, vertices.data(), vertex_bytes);
+		}
+
+		if (!has_indices) return;
+
+		const std::vector<GLuint> & indices = this->data->indices.value();
+		this->index_count = indices.size();
+		if (indices_16bit) {
+			std::vector<GLushort> packed = packIndices16(indices);
+			this->index_type = GL_UNSIGNED_SHORT;
+			heap.upload(this->allocation, this->index_byte_offset, packed.data(), index_bytes);
+		}
+		else {
+			// strips and dynamic meshes keep 32 bit indices, so that ranges can be updated in place
+			heap.upload(this->allocation, this->index_byte_offset, indices.data(), index_bytes);
+		}
+		this->index_chunks.push_back({ 0, indices.size(), 0 });
+	}
 };
 
 /**
@@ -99,6 +99,17 @@ public:
 		const std::string fragment_path,
 		enum eBuildinTargetShaderMode mode = eBuildinTargetShaderMode::None);
 
+	/**
+	 * @brief Construct a new Shader object from GLSL source code instead of files.
+	 * 
+	 * @param sources the source code of every stage, keyed by the shader type (e.g. GL_VERTEX_SHADER)
+	 * @param mode the built-in parameters the shader expects
+	 * 
+	 * Used for the built-in shaders that are generated at runtime, like the ones of the PatchTessellator.
+	 */
+	Shader(const std::map<GLenum, std::string> & sources,
+		enum eBuildinTargetShaderMode mode = eBuildinTargetShaderMode::None);
+
 	/**
 	 * @brief Returns the shader-program identifier.
 	 * 
@@ -195,6 +206,7 @@ private:
 	const std::string value_default = "value_default";
 	const std::string use_texture = "use_texture";
 	const std::string texture = "texture";
+	const std::string channel = "channel";
 	enum eBuildinTargetShaderMode eTargetShaderMode;
 	GLuint ID;
 	std::string debug_name;
@@ -238,7 +250,7 @@ private:
 	 * @param material_property the new material property for the variable
 	 *
 	 * The 1-dimensional property will be copied to a 3-dimensional value and set as 4-dimensional
-	 * with an additional value of 1 at the end.
+	 * with an additional value of 1 at the end. Its texture channel is set as well.
 	 */
 	void setMaterialProperty(const std::string& name, MaterialProperty<float> material_property, GLuint texture_unit);
 
@@ -0,0 +1,143 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <numeric>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/SceneObject.hpp>
+#include <mygl/Parallel.hpp>
+
+namespace mygl {
+	template <typename T> struct StaticBatchInstance;
+}
+
+/**
+ * @brief A static mesh together with the model matrix it is placed with.
+ *
+ */
+template <typename T>
+struct mygl::StaticBatchInstance {
+	std::shared_ptr<SceneMesh<T>> mesh;
+	glm::mat4 model = glm::mat4(1.f);
+};
+
+namespace mygl {
+
+/**
+ * @brief Returns whether a mesh can be merged into a static batch.
+ *
+ * Only static, non-empty meshes are batched. Strips, loops and fans would need restart indices between the parts,
+ * so only independent primitives (points, lines, triangles, patches) are accepted. Meshes without CPU data (GpuOnly
+ * residency, raw or written constructors) qualify as well, mergeStaticMeshes reads their geometry back.
+ *
+ * @param mesh the mesh to check
+ * @return true if the mesh can be batched
+ * @return false else
+ */
+template <typename T>
+bool isStaticBatchable(SceneMesh<T> & mesh)
+{
+	return mesh.getDrawType() == GL_STATIC_DRAW && !isStripGeometry(mesh.getGeometryType()) && mesh.getVertexCount() > 0;
+}
+
+/**
+ * @brief Merges meshes into a single mesh in world space.
+ *
+ * The sizes of all parts are summed up first, so that vertices and indices are allocated exactly once. The vertices
+ * are transformed with T::transform on multiple threads. Parts without indices receive sequential indices if any
+ * other part is indexed. Parts whose data was released are downloaded from the GPU and released again afterwards.
+ * Triangles of parts with a mirroring model matrix (negative determinant) get their winding flipped, so that they keep
+ * facing outwards.
+ *
+ * @param instances the meshes and model matrices that will be merged
+ * @return std::shared_ptr<MeshData<T>> the merged mesh data
+ */
+template <typename T>
+std::shared_ptr<MeshData<T>> mergeStaticMeshes(const std::vector<StaticBatchInstance<T>> & instances)
+{
+	std::shared_ptr<MeshData<T>> merged(new MeshData<T>());
+	const size_t part_count = instances.size();
+	if (part_count == 0) return merged;
+
+	// the data of released parts is kept alive here, their meshes drop it again once the batch is built
+	std::vector<std::shared_ptr<MeshData<T>>> part_data(part_count);
+	std::vector<MeshData<T>*> parts(part_count);
+	std::vector<bool> downloaded(part_count, false);
+	std::vector<size_t> vertex_offsets(part_count + 1, 0);
+	std::vector<size_t> index_offsets(part_count + 1, 0);
+	bool indexed = false;
+	const MeshData<T> * first = nullptr;
+	for (size_t p = 0; p < part_count; p++) {
+		downloaded[p] = !instances[p].mesh->isDataResident();
+		part_data[p] = instances[p].mesh->downloadData();
+		parts[p] = part_data[p].get();
+		indexed = indexed || parts[p]->indices.has_value();
+		if (!first && !parts[p]->vertices.empty()) first = parts[p];
+	}
+	for (size_t p = 0; p < part_count; p++) {
+		if (downloaded[p]) instances[p].mesh->releaseData();
+	}
+	if (!first) return merged;
+	for (size_t p = 0; p < part_count; p++) {
+		const MeshData<T> & part = *parts[p];
+		vertex_offsets[p + 1] = vertex_offsets[p] + part.vertices.size();
+		index_offsets[p + 1] = index_offsets[p] + (part.indices.has_value() ? part.indices.value().size() : part.vertices.size());
+	}
+
+	std::vector<glm::mat4> models(part_count);
+	std::vector<glm::mat3> model_normals(part_count);
+	std::vector<bool> mirrored(part_count);
+	for (size_t p = 0; p < part_count; p++) {
+		models[p] = instances[p].model;
+		model_normals[p] = glm::mat3(glm::transpose(glm::inverse(models[p])));
+		mirrored[p] = instances[p].mesh->getGeometryType() == GL_TRIANGLES && glm::determinant(glm::mat3(models[p])) < 0.f;
+	}
+
+	// swaps the last two corners of every complete triangle
+	auto flipWinding = [](size_t i, size_t count) -> size_t {
+		const size_t corner = i % 3;
+		if (corner == 0 || i - corner + 2 >= count) return i;
+		return corner == 1 ? i + 1 : i - 1;
+	};
+
+	// T may not be default constructible, the placeholder vertices are overwritten below
+	merged->vertices.resize(vertex_offsets[part_count], first->vertices[0]);
+	if (indexed) merged->indices = std::vector<GLuint>(index_offsets[part_count]);
+
+	// every chunk starts at the part that contains its first vertex
+	parallelFor(0, vertex_offsets[part_count], [&](size_t begin, size_t end) {
+		size_t p = std::upper_bound(vertex_offsets.begin(), vertex_offsets.end(), begin) - vertex_offsets.begin() - 1;
+		for (size_t v = begin; v < end; v++) {
+			while (v >= vertex_offsets[p + 1]) p++;
+			size_t source = v - vertex_offsets[p];
+			// the vertices of unindexed parts are the corners of their triangles
+			if (mirrored[p] && !parts[p]->indices.has_value()) source = flipWinding(source, parts[p]->vertices.size());
+			merged->vertices[v] = T::transform(parts[p]->vertices[source], models[p], model_normals[p]);
+		}
+	});
+
+	if (indexed) {
+		std::vector<GLuint> & indices = merged->indices.value();
+		parallelFor(0, part_count, [&](size_t begin, size_t end) {
+			for (size_t p = begin; p < end; p++) {
+				const GLuint offset = static_cast<GLuint>(vertex_offsets[p]);
+				auto target = indices.begin() + index_offsets[p];
+				if (parts[p]->indices.has_value()) {
+					const std::vector<GLuint> & source = parts[p]->indices.value();
+					std::transform(source.begin(), source.end(), target, [offset](GLuint x) -> GLuint { return x + offset; });
+					if (mirrored[p]) {
+						for (size_t i = 1; i + 1 < source.size(); i += 3) std::iter_swap(target + i, target + i + 1);
+					}
+				}
+				else {
+					std::iota(target, target + parts[p]->vertices.size(), offset);
+				}
+			}
+		}, 1);
+	}
+	return merged;
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glad/gl.h>
+
+namespace mygl {
+	class StreamBuffer;
+}
+
+/**
+ * @brief A persistently mapped buffer that is split into a ring of regions for data that changes every frame.
+ *
+ * The CPU writes into one region while the GPU may still read from the others. Every region is protected by a fence,
+ * so a region is only overwritten after all draw calls that used it have finished.
+ */
+class mygl::StreamBuffer {
+public:
+	/**
+	 * @brief Construct a new StreamBuffer object.
+	 *
+	 * @param region_size the size of a single region in bytes
+	 * @param region_count the number of regions (3 for triple buffering)
+	 */
+	StreamBuffer(size_t region_size, unsigned int region_count = 3);
+	~StreamBuffer();
+
+	StreamBuffer(const StreamBuffer &) = delete;
+	StreamBuffer & operator = (const StreamBuffer &) = delete;
+
+	/**
+	 * @brief Advances to the next region and waits until the GPU no longer uses it.
+	 *
+	 * @return void* the mapped memory of the region, valid for region_size bytes
+	 */
+	void * beginWrite();
+
+	/**
+	 * @brief Returns the mapped memory of the current region without advancing.
+	 *
+	 * @return void* the mapped memory of the current region
+	 */
+	void * getCurrentRegion();
+
+	/**
+	 * @brief Places a fence after the commands that read from the current region.
+	 * Has to be called after every draw call that sources data from the current region.
+	 */
+	void fenceCurrentRegion();
+
+	/**
+	 * @brief Returns the OpenGL buffer object.
+	 *
+	 * @return GLuint the buffer name
+	 */
+	GLuint getID();
+
+	/**
+	 * @brief Returns the index of the region that was written last.
+	 *
+	 * @return unsigned int the current region index
+	 */
+	unsigned int getCurrentRegionIndex();
+
+	/**
+	 * @brief Returns the byte offset of the current region inside of the buffer.
+	 *
+	 * @return size_t the byte offset
+	 */
+	size_t getCurrentOffset();
+
+	size_t getRegionSize();
+	unsigned int getRegionCount();
+private:
+	GLuint ID = 0;
+	size_t region_size;
+	unsigned int region_count;
+	unsigned int current_region = 0;
+	unsigned char * mapped = nullptr;
+	std::vector<GLsync> fences;
+
+	void waitForRegion(unsigned int region);
+};
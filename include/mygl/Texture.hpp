@@ -1,18 +1,27 @@
 #pragma once
 #include <glad/gl.h>
+#include <glm/glm.hpp>
 #include <string>
+#include <vector>
 #include <iostream>
 
+#include <mygl/MipGeneration.hpp>
+#include <mygl/SamplerCache.hpp>
+#include <mygl/TextureFile.hpp>
+
 namespace mygl {
 	static std::string defaultLibrary = "./textures/";
 	static std::string defaultRelativePath = "missingTexture.png";
 
 	class Texture;
+	class TextureLoader;
+	class TextureStreamer;
 }
 
 /**
  * @brief An image that can be bound to an OpenGL texture unit.
  * 
+ * The image is kept in immutable storage, its sampling state in a shared sampler object (see SamplerCache).
  */
 class mygl::Texture {
 public:
@@ -21,10 +30,11 @@ public:
 	 * 
 	 * @param library the relative path to multiple textures
 	 * @param relativePath the relative path to a single texture inside the library
+	 * @param content what the image stores, which decides how its mipmaps are filtered
 	 * 
 	 * Loads a texture from the specified library path and following relative path.
 	 */
-	Texture(std::string library, std::string relativePath);
+	Texture(std::string library, std::string relativePath, TextureContent content = TextureContent::Linear);
 
 	/**
 	 * @brief Construct a new Texture object.
@@ -42,19 +52,75 @@ public:
 	 */
 	Texture();
 
+	/**
+	 * @brief Construct a new Texture object from an encoded image in memory (e.g. an image embedded in a glTF file).
+	 * 
+	 * @param encoded the encoded image (png, jpg, ...)
+	 * @param size the size of the encoded image in bytes
+	 * @param name the name that is used in messages
+	 * @param content what the image stores, which decides how its mipmaps are filtered
+	 */
+	Texture(const unsigned char * encoded, size_t size, std::string name, TextureContent content = TextureContent::Linear);
+
+	/**
+	 * @brief Construct a new Texture object from decoded pixels and generates its mipmaps.
+	 * 
+	 * @param rgba the pixels with 4 bytes per texel, row by row
+	 * @param width the width in texels
+	 * @param height the height in texels
+	 * @param name the name that is used in messages
+	 * @param level_count the number of mipmap levels, 0 for the complete chain
+	 * @param content what the pixels store, which decides how the mipmaps are filtered
+	 */
+	Texture(const unsigned char * rgba, int width, int height, std::string name, GLsizei level_count = 0, TextureContent content = TextureContent::Linear);
+
+	/**
+	 * @brief Construct a new Texture object that shows a single texel until its image is uploaded by a TextureLoader.
+	 * 
+	 * @param name the name that is used in messages
+	 * @param placeholder the color of the texel
+	 */
+	Texture(std::string name, const glm::vec4 & placeholder);
+
+	/**
+	 * @brief Construct a new Texture object from block compressed levels, which are uploaded as they are.
+	 * 
+	 * @param texture the compressed texture with its complete mipmap chain
+	 * @param name the name that is used in messages
+	 */
+	Texture(const CompressedTexture & texture, std::string name);
+
+	/**
+	 * @brief Destroy the Texture object and deletes the OpenGL texture with all its levels.
+	 * 
+	 */
+	~Texture();
+
+	Texture(const Texture &) = delete;
+	Texture & operator = (const Texture &) = delete;
+
 	/**
 	 * @brief Loads a texture from a previously specified path.
+	 * Paths with the TEXTURE_FILE_EXTENSION are loaded as compressed texture files.
 	 * 
 	 */
 	void load();
 
 	/**
-	 * @brief Binds the current texture to an OpenGL texture unit.
+	 * @brief Binds the current texture and its sampler to an OpenGL texture unit.
 	 * 
 	 * @param textureUnit the texture unit to bind the texture to
 	 */
 	void bind(GLenum textureUnit);
 
+	/**
+	 * @brief Sets the sampling state that is used from the next bind on, trilinear filtering with repeat by default.
+	 * 
+	 * @param sampler the sampling state
+	 */
+	void setSampler(const SamplerDescription & sampler);
+	const SamplerDescription & getSampler();
+
 	/**
 	 * @brief Returns whether the texture was loaded into memory successfully.
 	 * 
@@ -62,11 +128,49 @@ public:
 	 * @return false else
 	 */
 	bool isSuccessfullyLoaded();
+
+	/**
+	 * @brief Returns the OpenGL texture object, which is replaced whenever the texture gets new storage
+	 * (e.g. when a TextureLoader uploads its image).
+	 * 
+	 * @return GLuint the texture name
+	 */
+	GLuint getID();
+
+	int getWidth();
+	int getHeight();
+
+	/**
+	 * @brief Returns the video memory of the texture including its mipmaps.
+	 * 
+	 * @return size_t the number of bytes
+	 */
+	size_t getMemorySize();
+
+	/**
+	 * @brief Reads the texels of the base level back from video memory, compressed textures are decoded by the driver.
+	 * 
+	 * @return std::vector<unsigned char> the texels with 4 bytes each, empty if the base level is not resident
+	 */
+	std::vector<unsigned char> readPixels();
 private:
-	GLuint ID;
+	friend class TextureLoader;
+	friend class TextureStreamer;
+
+	GLuint ID = 0;
+	SamplerDescription sampler;
+	GLuint sampler_ID = 0;
+	size_t sampler_generation = 0;
+	TextureContent content = TextureContent::Linear;
 	int width, height, nrChannels;
 	unsigned char * data;
 	std::string library, relativePath;
 	bool successfullyLoaded = false;
+	size_t memorySize = 0;
 	void create(std::string library, std::string relativePath);
+	void allocate(GLenum internal_format, GLsizei width, GLsizei height, GLsizei level_count);
+	static GLsizei getLevelCount(GLsizei width, GLsizei height);
+	void upload(std::string name);
+	void uploadLevels(const std::vector<MipLevel> & levels, GLsizei level_count);
+	void uploadCompressed(const CompressedTexture & texture);
 };
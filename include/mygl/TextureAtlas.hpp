@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <mygl/SceneObject.hpp>
+
+namespace mygl {
+	class SkylinePacker;
+	struct TextureAtlasOptions;
+	struct TextureAtlasReport;
+}
+
+/**
+ * @brief Packs rectangles into a fixed page with the bottom-left skyline heuristic.
+ *
+ * The skyline is the upper contour of all placed rectangles; a new rectangle is placed at the lowest position on it,
+ * preferring the narrowest segment on ties, which keeps the wasted area below the skyline small.
+ */
+class mygl::SkylinePacker {
+public:
+	SkylinePacker(uint32_t width, uint32_t height);
+
+	/**
+	 * @brief Places a rectangle.
+	 *
+	 * @param width the width of the rectangle
+	 * @param height the height of the rectangle
+	 * @param x receives the left edge
+	 * @param y receives the bottom edge
+	 * @return true if the rectangle was placed
+	 * @return false if it does not fit into the page anymore
+	 */
+	bool insert(uint32_t width, uint32_t height, uint32_t & x, uint32_t & y);
+
+	/**
+	 * @brief Returns the fraction of the page that is covered by placed rectangles.
+	 *
+	 * @return float the occupancy in [0, 1]
+	 */
+	float getOccupancy();
+
+private:
+	struct Segment {
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+	};
+
+	uint32_t width;
+	uint32_t height;
+	uint64_t used_area = 0;
+	std::vector<Segment> skyline;
+
+	bool fit(size_t segment, uint32_t width, uint32_t height, uint32_t & y);
+};
+
+/**
+ * @brief The options of packMaterialTextures.
+ *
+ */
+struct mygl::TextureAtlasOptions {
+	/**
+	 * @brief The width and height of an atlas page in texels.
+	 *
+	 */
+	uint32_t page_size = 2048;
+
+	/**
+	 * @brief Textures with a larger width or height are not packed.
+	 *
+	 */
+	uint32_t max_texture_size = 256;
+
+	/**
+	 * @brief The border around every texture that repeats its edge texels, rounded up to a power of two.
+	 * The pages only get the mipmap levels whose texels do not mix neighbouring textures, log2(padding) + 1 levels.
+	 *
+	 */
+	uint32_t padding = 4;
+};
+
+/**
+ * @brief The result of packMaterialTextures.
+ *
+ */
+struct mygl::TextureAtlasReport {
+	size_t packed_materials = 0;
+	size_t packed_textures = 0;
+	size_t skipped_materials = 0;
+	size_t page_count = 0;
+};
+
+namespace mygl {
+
+/**
+ * @brief Packs the small textures of materials into shared atlas pages.
+ *
+ * Every packed material receives the page textures of its properties and a uv transform that maps its uv range
+ * [0, 1] onto its region. All textures of a material share the same region, one page per property, so a material
+ * qualifies if all its textures have the same size of at most max_texture_size. Materials with textures that are still
+ * loading or that cannot be read back (streamed textures without their finest level) are skipped. Materials that share
+ * the same textures share their region.
+ *
+ * The pages are sampled with GL_CLAMP_TO_EDGE and a region cannot repeat, so a packed material only renders correctly
+ * if the uv coordinates of its meshes stay in [0, 1]. Materials with a uv transform other than the identity (which
+ * usually tile their textures) are skipped; the caller has to leave out materials of meshes that tile through their
+ * uv coordinates, e.g. with hasRepeatingTextureCoordinates.
+ *
+ * @param materials the candidates, materials that do not qualify keep their textures
+ * @param options the page size and the padding
+ * @return TextureAtlasReport the statistics of the packing
+ */
+TextureAtlasReport packMaterialTextures(const std::vector<std::shared_ptr<Material>> & materials, const TextureAtlasOptions & options = TextureAtlasOptions());
+
+/**
+ * @brief Checks whether the texture coordinates of a mesh leave [0, 1], so that its textures repeat.
+ *
+ * @param data the mesh data
+ * @param tolerance how far the coordinates may leave [0, 1] without counting as repeating
+ * @return true if the material of the mesh should not be packed into an atlas
+ */
+template <typename T>
+bool hasRepeatingTextureCoordinates(const MeshData<T> & data, float tolerance = 1e-3f)
+{
+	for (const T & vertex : data.vertices) {
+		if (std::min(vertex.uv.x, vertex.uv.y) < -tolerance || std::max(vertex.uv.x, vertex.uv.y) > 1.f + tolerance) return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Applies a uv transform (see Material::uv_transform) to the texture coordinates of a mesh.
+ *
+ * Meshes whose transform is baked can share a single material per atlas page, so that they can be batched.
+ *
+ * @param data the mesh data
+ * @param uv_transform the scale (xy) and the offset (zw)
+ */
+template <typename T>
+void transformTextureCoordinates(MeshData<T> & data, const glm::vec4 & uv_transform)
+{
+	for (T & vertex : data.vertices) vertex.uv = vertex.uv * glm::vec2(uv_transform.x, uv_transform.y) + glm::vec2(uv_transform.z, uv_transform.w);
+}
+
+}
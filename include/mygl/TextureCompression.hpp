@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <mygl/MipGeneration.hpp>
+#include <mygl/TextureFile.hpp>
+
+namespace mygl {
+	struct TextureCookOptions;
+}
+
+/**
+ * @brief The options of cookTexture.
+ *
+ */
+struct mygl::TextureCookOptions {
+	TextureBlockFormat format = TextureBlockFormat::BC7;
+	TextureContent content = TextureContent::Color;
+	MipFilter mip_filter = MipFilter::Box;
+
+	/**
+	 * @brief Whether the sampler decodes the sRGB colors. The renderer samples all textures as linear values, so this is
+	 * off by default to keep the shading of cooked and uncompressed textures identical.
+	 *
+	 */
+	bool srgb = false;
+};
+
+namespace mygl {
+
+/**
+ * @brief Encodes an image into 4 x 4 blocks.
+ *
+ * @param rgba the image with 4 bytes per texel, partial blocks at the border repeat their last texel
+ * @param width the width in texels
+ * @param height the height in texels
+ * @param format the block format, BC4 encodes the red channel and BC5 the red and green channel
+ * @return std::vector<unsigned char> the blocks row by row
+ */
+std::vector<unsigned char> compressBlocks(const unsigned char * rgba, uint32_t width, uint32_t height, TextureBlockFormat format);
+
+/**
+ * @brief Computes the mipmap chain of an image and encodes all its levels.
+ *
+ * @param rgba the image with 4 bytes per texel
+ * @param width the width in texels
+ * @param height the height in texels
+ * @param options the format and the content of the image
+ * @return CompressedTexture the compressed texture
+ */
+CompressedTexture cookTexture(const unsigned char * rgba, uint32_t width, uint32_t height, const TextureCookOptions & options);
+
+/**
+ * @brief Loads an image file (png, jpg, ...), cooks it and writes the result into a texture file.
+ *
+ * @param input the path of the image file
+ * @param output the path of the texture file
+ * @param options the format and the content of the image
+ */
+void cookTextureFile(const std::string & input, const std::string & output, const TextureCookOptions & options);
+
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glad/gl.h>
+
+// S3TC is an extension that is not part of the core profile, but supported by every desktop implementation
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+namespace mygl {
+	/**
+	 * @brief The block compressed formats of a texture file, every block stores 4 x 4 texels.
+	 *
+	 */
+	enum class TextureBlockFormat : uint32_t {
+		BC1 = 1,	// RGB, 8 bytes per block
+		BC3 = 3,	// RGBA, 16 bytes per block
+		BC4 = 4,	// R, 8 bytes per block
+		BC5 = 5,	// RG, 16 bytes per block
+		BC7 = 7		// RGBA, 16 bytes per block
+	};
+	struct CompressedTextureLevel;
+	struct CompressedTexture;
+	struct TextureFileHeader;
+	struct TextureFileLevel;
+
+	/**
+	 * @brief The first bytes of every texture file.
+	 *
+	 */
+	static const char TEXTURE_FILE_MAGIC[4] = { 'M', 'Y', 'G', 'T' };
+
+	/**
+	 * @brief The version of the texture file layout, files with another version are rejected.
+	 *
+	 */
+	static const uint32_t TEXTURE_FILE_VERSION = 1;
+
+	/**
+	 * @brief The extension of texture files, Texture loads files with it as compressed textures.
+	 *
+	 */
+	static const std::string TEXTURE_FILE_EXTENSION = ".mygt";
+}
+
+/**
+ * @brief A single mipmap level of a compressed texture.
+ *
+ */
+struct mygl::CompressedTextureLevel {
+	uint32_t width = 0;
+	uint32_t height = 0;
+
+	/**
+	 * @brief The blocks row by row, ceil(width / 4) * ceil(height / 4) blocks.
+	 *
+	 */
+	std::vector<unsigned char> blocks;
+};
+
+/**
+ * @brief A block compressed texture with its complete mipmap chain.
+ *
+ */
+struct mygl::CompressedTexture {
+	TextureBlockFormat format = TextureBlockFormat::BC7;
+
+	/**
+	 * @brief Whether the color channels are sRGB encoded and have to be decoded by the sampler.
+	 *
+	 */
+	bool srgb = false;
+
+	/**
+	 * @brief The levels from the largest to the 1 x 1 level.
+	 *
+	 */
+	std::vector<CompressedTextureLevel> levels;
+};
+
+/**
+ * @brief The header at the beginning of a texture file, followed by level_count TextureFileLevel entries.
+ *
+ * All values are stored little-endian, the blocks of every level start at a multiple of 16 bytes.
+ */
+struct mygl::TextureFileHeader {
+	char magic[4] = { 'M', 'Y', 'G', 'T' };
+	uint32_t version = TEXTURE_FILE_VERSION;
+	uint32_t header_size = sizeof(TextureFileHeader);
+	uint32_t format = 0;
+	uint32_t flags = 0;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t level_count = 0;
+
+	static const uint32_t FLAG_SRGB = 1;
+};
+
+/**
+ * @brief The size and the position of the blocks of a level inside of a texture file.
+ *
+ */
+struct mygl::TextureFileLevel {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint64_t offset = 0;
+	uint64_t size = 0;
+};
+
+namespace mygl {
+
+/**
+ * @brief Returns the size of a single 4 x 4 block.
+ *
+ * @param format the block format
+ * @return size_t 8 for BC1 and BC4, 16 else
+ */
+size_t getBlockBytes(TextureBlockFormat format);
+
+/**
+ * @brief Returns the size of the blocks of a level.
+ *
+ * @param format the block format
+ * @param width the width of the level in texels
+ * @param height the height of the level in texels
+ * @return size_t the size in bytes
+ */
+size_t getCompressedLevelBytes(TextureBlockFormat format, uint32_t width, uint32_t height);
+
+/**
+ * @brief Returns the OpenGL internal format for glCompressedTexImage2D.
+ *
+ * @param format the block format
+ * @param srgb whether the color channels are sRGB encoded (only BC1, BC3 and BC7)
+ * @return GLenum the internal format
+ */
+GLenum getCompressedInternalFormat(TextureBlockFormat format, bool srgb);
+
+/**
+ * @brief Writes a compressed texture into a texture file.
+ *
+ * @param path the path of the file
+ * @param texture the texture
+ */
+void writeTextureFile(const std::string & path, const CompressedTexture & texture);
+
+/**
+ * @brief Reads and validates a texture file.
+ *
+ * @param path the path of the file
+ * @return CompressedTexture the texture
+ */
+CompressedTexture readTextureFile(const std::string & path);
+
+/**
+ * @brief Reads and validates the header and the level table of a texture file without reading its blocks, so that
+ * single levels can be read on demand.
+ *
+ * @param path the path of the file
+ * @param header receives the header
+ * @return std::vector<TextureFileLevel> the levels from the largest to the smallest
+ */
+std::vector<TextureFileLevel> readTextureFileLayout(const std::string & path, TextureFileHeader & header);
+
+/**
+ * @brief Reads the blocks of a single level of a texture file.
+ *
+ * @param path the path of the file
+ * @param level the level from the table of readTextureFileLayout
+ * @return std::vector<unsigned char> the blocks
+ */
+std::vector<unsigned char> readTextureFileLevel(const std::string & path, const TextureFileLevel & level);
+
+/**
+ * @brief Returns whether a path has the extension of texture files.
+ *
+ * @param path the path
+ * @return true if the path ends with TEXTURE_FILE_EXTENSION
+ * @return false else
+ */
+bool isTextureFile(const std::string & path);
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/Texture.hpp>
+#include <mygl/StreamBuffer.hpp>
+
+namespace mygl {
+	class TextureLoader;
+}
+
+/**
+ * @brief Loads textures in the background, so that large scenes can be loaded without freezing the window.
+ *
+ * Every texture is returned immediately and shows a placeholder texel. The images are decoded by a pool of worker
+ * threads. 'update' has to be called once per frame on the thread of the OpenGL context: it copies the decoded images
+ * into a persistently mapped pixel unpack buffer and uploads them until the time budget of the frame is spent.
+ * The workers also compute the mipmaps of every image (see generateMipLevels), so that the upload only copies levels.
+ * Textures that are destroyed before their image is decoded are skipped. Compressed texture files are read by the
+ * workers as well and their levels are uploaded directly, since they need neither decoding nor mipmap generation.
+ */
+class mygl::TextureLoader {
+public:
+	/**
+	 * @brief Construct a new TextureLoader object and starts its worker threads.
+	 *
+	 * @param worker_count the number of decoding threads, 0 uses all but one hardware thread
+	 * @param staging_size the size of the pixel unpack buffer in bytes, split into a ring of 3 regions; larger images
+	 * are uploaded directly from memory
+	 */
+	TextureLoader(unsigned int worker_count = 0, size_t staging_size = 48 << 20);
+	~TextureLoader();
+
+	TextureLoader(const TextureLoader &) = delete;
+	TextureLoader & operator = (const TextureLoader &) = delete;
+
+	/**
+	 * @brief Creates a texture and schedules the decoding of its image file.
+	 *
+	 * @param library the relative path to multiple textures
+	 * @param relative_path the relative path to a single texture inside the library
+	 * @param placeholder the color of the texture until its image is uploaded, or if the image cannot be loaded
+	 * @param content what the image stores, which decides how its mipmaps are filtered
+	 * @return std::shared_ptr<Texture> the texture
+	 */
+	std::shared_ptr<Texture> load(const std::string & library, const std::string & relative_path, const glm::vec4 & placeholder = glm::vec4(1.f),
+		TextureContent content = TextureContent::Linear);
+
+	/**
+	 * @brief Creates a texture and schedules the decoding of an encoded image in memory.
+	 *
+	 * @param encoded the encoded image (png, jpg, ...)
+	 * @param name the name that is used in messages
+	 * @param placeholder the color of the texture until its image is uploaded, or if the image cannot be decoded
+	 * @param content what the image stores, which decides how its mipmaps are filtered
+	 * @return std::shared_ptr<Texture> the texture
+	 */
+	std::shared_ptr<Texture> load(std::vector<unsigned char> encoded, const std::string & name, const glm::vec4 & placeholder = glm::vec4(1.f),
+		TextureContent content = TextureContent::Linear);
+
+	/**
+	 * @brief Uploads decoded images until the time budget is spent. At least one image is uploaded per call.
+	 * Afterwards the textures of the TextureManager are trimmed to its budget, since the uploads grow them.
+	 *
+	 * @param budget_milliseconds the time that may be spent on uploads
+	 * @return size_t the number of uploaded textures
+	 */
+	size_t update(double budget_milliseconds = 2.0);
+
+	/**
+	 * @brief Decodes and uploads all scheduled textures before returning, e.g. behind a loading screen.
+	 *
+	 */
+	void finish();
+
+	/**
+	 * @brief Returns how many textures are waiting for their decoding or upload.
+	 *
+	 * @return size_t the number of pending textures
+	 */
+	size_t getPendingCount();
+
+private:
+	struct Job {
+		std::weak_ptr<Texture> texture;
+		std::string path;
+		std::vector<unsigned char> encoded;
+		TextureContent content = TextureContent::Linear;
+	};
+
+	struct Image {
+		std::weak_ptr<Texture> texture;
+		std::shared_ptr<std::vector<MipLevel>> levels;
+		size_t size = 0;
+		std::shared_ptr<CompressedTexture> compressed;
+	};
+
+	std::deque<Job> jobs;
+	std::deque<Image> images;
+	size_t decoding_count = 0;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::condition_variable decoded;
+	bool stopping = false;
+	std::vector<std::thread> workers;
+
+	std::unique_ptr<StreamBuffer> staging;
+
+	void run();
+	void schedule(Job job);
+	void upload(Texture & texture, const Image & image, std::optional<size_t> staging_offset);
+};
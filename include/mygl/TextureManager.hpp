@@ -3,22 +3,74 @@
 #include <string>
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
+#include <glm/glm.hpp>
+
+#include <mygl/Texture.hpp>
+#include <mygl/TextureLoader.hpp>
 
 namespace fs = std::filesystem;
 
 typedef unsigned long long TextureSpaceSize;
 
+/**
+ * @brief Finds texture directories and shares loaded textures between all materials.
+ *
+ * Textures are registered by their resolved path and, if content hashing is enabled, by the hash of their encoded
+ * image, so that copies of the same file are loaded once. The registry holds a reference to every texture; textures
+ * that are referenced by nobody else are evicted, least recently acquired first, while the video memory of
+ * all textures exceeds the budget. Must only be used on the thread of the OpenGL context.
+ */
 class TextureManager {
 private:
+    struct TextureEntry {
+        std::shared_ptr<mygl::Texture> texture;
+        uint64_t last_use = 0;
+    };
+
+    struct IndexedPath {
+        fs::path path;
+        size_t source = 0;
+        unsigned int depth = 0;
+        bool directory = false;
+    };
+
+    struct WatchedDirectory {
+        fs::path path;
+        size_t source = 0;
+        unsigned int depth = 0;
+    };
+
     std::set<fs::path> registered_paths;
-    std::map<std::string, fs::path> cached_paths;
+    std::vector<fs::path> sources;
+    std::unordered_map<std::string, std::vector<IndexedPath>> path_index;
+    std::unordered_map<int, WatchedDirectory> watched_directories;
+    int notify_fd = -1;
     TextureSpaceSize next_texture_id;
+
+    std::map<std::string, TextureEntry> textures;
+    std::map<std::string, std::string> texture_aliases;
+    size_t texture_budget = 1ull << 30;
+    bool content_hashing = false;
+    uint64_t use_counter = 0;
+
     TextureManager();
     TextureManager(const TextureManager&);
     TextureManager & operator = (const TextureManager &);
-    bool findPathLocally(fs::directory_entry dir, std::string filename, fs::path * target);
+    void indexSource(size_t source);
+    void indexDirectory(const fs::path & path, size_t source, unsigned int depth);
+    void addIndexEntry(const fs::path & path, size_t source, unsigned int depth, bool directory);
+    void removeIndexEntries(const fs::path & path);
+    void watchDirectory(const fs::path & path, size_t source, unsigned int depth);
+    void pollSourceChanges();
+    fs::path findIndexedPath(const std::string & name, bool directory);
+    std::shared_ptr<mygl::Texture> findTexture(const std::string & key);
+    std::shared_ptr<mygl::Texture> insertTexture(const std::string & key, std::shared_ptr<mygl::Texture> texture);
+    void eraseTexture(std::map<std::string, TextureEntry>::iterator entry);
 public:
     static TextureManager& getInstance() {
         static TextureManager instance;
@@ -27,6 +79,129 @@ public:
 
     ~TextureManager();
 
+    /**
+     * @brief Registers a directory that is searched for textures and indexes its whole tree.
+     *
+     * The tree is scanned once, in parallel. On Linux, the index follows changes of the tree through inotify, other
+     * platforms have to call refreshSources after files were added or removed.
+     *
+     * @param path the directory
+     */
     void registerSource(fs::path path);
+
+    /**
+     * @brief Returns the path of a texture directory by its name with a single index lookup.
+     *
+     * Sources that were registered earlier are preferred, then directories that are closer to their source.
+     *
+     * @param name the name of the directory (or of a source itself)
+     * @return fs::path the path, empty if no directory has the name
+     */
     fs::path findTexturePath(std::string name);
-};
\ No newline at end of file
+
+    /**
+     * @brief Returns the path of a file inside of the registered sources by its name, like findTexturePath.
+     *
+     * @param filename the name of the file
+     * @return fs::path the path, empty if no file has the name
+     */
+    fs::path findAssetPath(std::string filename);
+
+    /**
+     * @brief Rebuilds the index of all sources and drops the sources that no longer exist.
+     *
+     */
+    void refreshSources();
+
+    /**
+     * @brief Returns the number of indexed files and directories.
+     *
+     * @return size_t the number of paths
+     */
+    size_t getIndexedCount();
+
+    /**
+     * @brief Returns the shared texture of an image file and loads it if it is not registered yet.
+     *
+     * Failed loads are not registered, check Texture::isSuccessfullyLoaded. The same file is registered once per content.
+     *
+     * @param path the path of the image file
+     * @param loader loads a missing texture in the background if set, the returned texture shows the placeholder
+     * until it is uploaded
+     * @param placeholder the color of a texture that is loaded in the background
+     * @param content what the image stores, which decides how its mipmaps are filtered
+     * @return std::shared_ptr<mygl::Texture> the texture
+     */
+    std::shared_ptr<mygl::Texture> acquireTexture(const fs::path & path, mygl::TextureLoader * loader = nullptr,
+        const glm::vec4 & placeholder = glm::vec4(1.f), mygl::TextureContent content = mygl::TextureContent::Linear);
+
+    /**
+     * @brief Returns the shared texture of an encoded image in memory (e.g. embedded in a glTF file) by its content and by what it stores.
+     *
+     * @param encoded the encoded image (png, jpg, ...)
+     * @param size the size of the encoded image in bytes
+     * @param name the name that is used in messages
+     * @param loader loads a missing texture in the background if set
+     * @param placeholder the color of a texture that is loaded in the background
+     * @param content what the image stores, which decides how its mipmaps are filtered
+     * @return std::shared_ptr<mygl::Texture> the texture
+     */
+    std::shared_ptr<mygl::Texture> acquireTexture(const unsigned char * encoded, size_t size, const std::string & name,
+        mygl::TextureLoader * loader = nullptr, const glm::vec4 & placeholder = glm::vec4(1.f),
+        mygl::TextureContent content = mygl::TextureContent::Linear);
+
+    /**
+     * @brief Sets whether image files are also identified by the hash of their content.
+     * Finds copies of the same image under different paths at the cost of reading every file before it is decoded.
+     *
+     * @param enabled whether the content is hashed
+     */
+    void setContentHashing(bool enabled);
+
+    /**
+     * @brief Sets the video memory that the registered textures may occupy and evicts textures to meet it.
+     *
+     * @param bytes the budget in bytes
+     */
+    void setTextureBudget(size_t bytes);
+    size_t getTextureBudget();
+
+    /**
+     * @brief Evicts unused textures, least recently acquired first, until the registered textures fit into the budget.
+     *
+     * @return size_t the number of freed bytes
+     */
+    size_t trimTextures();
+
+    /**
+     * @brief Evicts all textures that are referenced by nobody but the registry.
+     *
+     * @return size_t the number of freed bytes
+     */
+    size_t releaseUnusedTextures();
+
+    /**
+     * @brief Drops the references of the registry to all textures, e.g. before the OpenGL context is destroyed.
+     *
+     * The registry is a static that outlives the context. Textures that are still referenced by materials are deleted
+     * together with them, which has to happen before the context is destroyed as well.
+     */
+    void releaseTextures();
+
+    /**
+     * @brief Returns the video memory of all registered textures, including their mipmaps.
+     *
+     * @return size_t the number of bytes
+     */
+    size_t getTextureMemory();
+    size_t getTextureCount();
+
+    /**
+     * @brief Returns the key of an encoded image, which is derived from its size and its 64 bit FNV-1a hash.
+     *
+     * @param encoded the encoded image
+     * @param size the size in bytes
+     * @return std::string the key
+     */
+    static std::string hashContent(const unsigned char * encoded, size_t size);
+};
@@ -0,0 +1,158 @@
+#pragma once
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/Texture.hpp>
+#include <mygl/TextureFile.hpp>
+
+namespace mygl {
+	class Material;
+	class TextureStreamer;
+}
+
+/**
+ * @brief Keeps only the mipmap levels of compressed texture files resident that are visible on screen, within a fixed
+ * video memory budget.
+ *
+ * A texture starts with its coarse tail levels, which stay resident. Every frame, the demanded level of each texture is
+ * requested (see Scene::requestTextures) and 'update' streams finer levels in, one level at a time and coarse to fine,
+ * or drops levels that are no longer demanded. While the demanded levels exceed the budget, the largest levels of the
+ * least demanded textures are dropped first. The immutable storage of a texture only holds its resident levels, so
+ * the texture moves into a new texture object whenever its levels change, and stays complete.
+ *
+ * The levels are read by a background thread; all other methods must be called on the thread of the OpenGL context.
+ * Image files without precomputed mipmaps are loaded completely and are not streamed.
+ */
+class mygl::TextureStreamer {
+public:
+	/**
+	 * @brief Construct a new TextureStreamer object and starts its reading thread.
+	 *
+	 * @param budget the video memory that the streamed textures may occupy in bytes
+	 * @param tail_size the extent in texels up to which levels always stay resident
+	 */
+	TextureStreamer(size_t budget = 256 << 20, uint32_t tail_size = 64);
+	~TextureStreamer();
+
+	TextureStreamer(const TextureStreamer &) = delete;
+	TextureStreamer & operator = (const TextureStreamer &) = delete;
+
+	/**
+	 * @brief Returns the streamed texture of a compressed texture file, which is shared by all callers.
+	 *
+	 * Only the tail levels are uploaded immediately. Other files are loaded completely.
+	 *
+	 * @param path the path of the file
+	 * @return std::shared_ptr<Texture> the texture, check Texture::isSuccessfullyLoaded
+	 */
+	std::shared_ptr<Texture> load(const std::string & path);
+
+	/**
+	 * @brief Requests a mipmap level of a texture for the current frame. The finest request of a frame wins.
+	 *
+	 * @param texture the texture, textures that are not streamed are ignored
+	 * @param level the demanded level, fractions are rounded down
+	 */
+	void requestLevel(const Texture & texture, float level);
+
+	/**
+	 * @brief Requests the levels of all textures of a material for the current frame.
+	 *
+	 * The level of a texture is chosen so that one texel covers about one pixel, assuming that its uv range [0, 1]
+	 * spans the given screen extent. Tiled uv coordinates therefore request finer levels than necessary, never
+	 * coarser ones.
+	 *
+	 * @param material the material
+	 * @param screen_size the extent in pixels that the uv range covers on screen
+	 */
+	void requestMaterial(const Material & material, float screen_size);
+
+	/**
+	 * @brief Drops and streams levels towards the requests of the current frame and starts the next frame.
+	 *
+	 * @param upload_budget the number of bytes that may be uploaded in this frame, at least one level is uploaded
+	 * @return size_t the number of uploaded levels
+	 */
+	size_t update(size_t upload_budget = 8 << 20);
+
+	void setBudget(size_t bytes);
+	size_t getBudget();
+
+	/**
+	 * @brief Sets a bias that is added to all requested levels, positive values save memory at the cost of sharpness.
+	 *
+	 * @param bias the bias in levels
+	 */
+	void setLevelBias(float bias);
+
+	/**
+	 * @brief Returns the video memory of the resident levels of all streamed textures.
+	 *
+	 * @return size_t the number of bytes
+	 */
+	size_t getResidentMemory();
+	size_t getStreamedCount();
+
+	/**
+	 * @brief Returns how many levels are being read or waiting for their upload.
+	 *
+	 * @return size_t the number of levels
+	 */
+	size_t getPendingCount();
+
+private:
+	struct StreamedTexture {
+		std::weak_ptr<Texture> texture;
+		const Texture * address = nullptr;
+		std::string path;
+		GLenum internal_format = 0;
+		std::vector<TextureFileLevel> levels;
+		uint32_t tail_level = 0;		// the finest level that always stays resident
+		uint32_t resident_level = 0;	// the finest resident level
+		uint32_t target_level = 0;		// the finest level that should be resident after this frame
+		uint32_t finest_level = 0;		// the finest level that can be read from the file
+		float demand = INFINITY;		// the finest requested level of the current frame
+		bool reading = false;
+	};
+
+	struct Read {
+		std::string path;
+		uint32_t level = 0;
+		TextureFileLevel layout;
+		std::vector<unsigned char> blocks;
+	};
+
+	std::map<std::string, StreamedTexture> textures;
+	std::map<const Texture *, std::string> texture_paths;
+	size_t budget;
+	uint32_t tail_size;
+	float level_bias = 0.f;
+	size_t resident_memory = 0;
+
+	std::deque<Read> reads;
+	std::deque<Read> completed;
+	size_t reading_count = 0;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopping = false;
+	std::thread reader;
+
+	void run();
+	void chooseTargetLevels();
+	std::map<std::string, StreamedTexture>::iterator eraseTexture(std::map<std::string, StreamedTexture>::iterator entry);
+	void dropLevels(StreamedTexture & entry, Texture & texture, uint32_t level);
+	void uploadLevel(StreamedTexture & entry, Texture & texture, uint32_t level, const std::vector<unsigned char> & blocks);
+	void reallocate(StreamedTexture & entry, Texture & texture, uint32_t level);
+	static size_t getLevelBytes(const StreamedTexture & entry, uint32_t first_level);
+};
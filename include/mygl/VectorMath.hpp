@@ -16,10 +16,12 @@ namespace mygl {
  * @param p3 the second neighbor point
  * @return glm::vec3 the tangent vector
  */
-glm::vec3 calculateTangent(VertexFormat p1, VertexFormat p2, VertexFormat p3);
+glm::vec3 calculateTangent(const VertexFormat & p1, const VertexFormat & p2, const VertexFormat & p3);
 
 /**
- * @brief Calculates and sets the tangent vectors for multiple GL_TRIANGLES.
+ * @brief Calculates and sets flat tangent vectors for multiple GL_TRIANGLES.
+ * 
+ * For indexed meshes with smooth tangents see generateNormalsAndTangents.
  * 
  * @param vertices the vertices of the triangles (always a multiple of 3)
  */
@@ -1,11 +1,25 @@
 #pragma once
+#include <vector>
 #include <glad/gl.h>
 #include <glm/glm.hpp>
 
 namespace mygl {
 	class VertexFormat;
+	struct VertexAttribute;
 }
 
+/**
+ * @brief The description of a single vertex attribute (see glVertexAttribPointer).
+ * 
+ */
+struct mygl::VertexAttribute {
+	GLuint location = 0;
+	GLint component_count = 0;
+	GLenum component_type = GL_FLOAT;
+	GLboolean normalized = GL_FALSE;
+	GLuint offset = 0;
+};
+
 /**
  * @brief The format of a vertex with all related information
  * 
@@ -28,5 +42,38 @@ public:
 	VertexFormat(const glm::vec3 &position, const glm::vec3 &normal, const glm::vec2 &uv, const glm::vec3 &tangent);
 	~VertexFormat();
 
+	/**
+	 * @brief Enables and describes the attributes of this format for the bound vertex array and vertex buffer.
+	 * 
+	 */
 	static void registerFormat();
+
+	/**
+	 * @brief Returns the attributes of this format, in the order of their locations.
+	 * 
+	 * @return std::vector<VertexAttribute> the attribute layout
+	 */
+	static std::vector<VertexAttribute> getLayout();
+
+	/**
+	 * @brief Returns whether two vertices are equal within the given tolerances.
+	 * 
+	 * @param a the first vertex
+	 * @param b the second vertex
+	 * @param position_tolerance the maximal distance between the positions along each axis
+	 * @param attribute_tolerance the maximal difference of each component of the normal, uv and tangent
+	 * @return true if the vertices can be merged
+	 * @return false else
+	 */
+	static bool isNearlyEqual(const VertexFormat &a, const VertexFormat &b, float position_tolerance, float attribute_tolerance);
+
+	/**
+	 * @brief Returns a copy of the vertex that is transformed into another coordinate system.
+	 * 
+	 * @param vertex the vertex to transform
+	 * @param model the matrix that transforms positions
+	 * @param model_normal the matrix that transforms normals (the inverse transpose of the upper 3x3 of the model matrix)
+	 * @return VertexFormat the transformed vertex with normalized normal and tangent
+	 */
+	static VertexFormat transform(const VertexFormat &vertex, const glm::mat4 &model, const glm::mat3 &model_normal);
 };
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+#include <vector>
+#include <numeric>
+#include <cmath>
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+
+#include <mygl/SceneObject.hpp>
+#include <mygl/Parallel.hpp>
+
+namespace mygl {
+	struct WeldOptions;
+}
+
+/**
+ * @brief The tolerances that decide whether two vertices are merged.
+ *
+ */
+struct mygl::WeldOptions {
+	/**
+	 * @brief The maximal distance of two positions along each axis (0 for bitwise equal positions).
+	 *
+	 */
+	float position_tolerance = 1e-6f;
+
+	/**
+	 * @brief The maximal difference of each component of the remaining attributes (normal, uv, tangent).
+	 *
+	 */
+	float attribute_tolerance = 1e-4f;
+};
+
+namespace mygl {
+
+/**
+ * @brief Merges duplicate vertices and turns the mesh into an indexed mesh.
+ *
+ * Positions are quantized into a grid with twice the position tolerance as cell size. Vertices are only compared with
+ * the vertices of their own cell and of the closest neighboring cells, using T::isNearlyEqual for the final decision.
+ * Every group of equal vertices is replaced by its first vertex, so the order of the remaining vertices is stable.
+ * Hashing, sorting and matching run on multiple threads.
+ *
+ * Works for triangle soups without indices (e.g. after calculateAndSetTangents_GL_TRIANGLES) as well as for
+ * indexed meshes, whose indices are rewritten.
+ *
+ * @param data the mesh data that will be modified
+ * @param options the tolerances for positions and attributes
+ * @return std::vector<GLuint> the remap table (old vertex index -> new vertex index)
+ */
+template <typename T>
+std::vector<GLuint> weldVertices(MeshData<T> & data, const WeldOptions & options = WeldOptions())
+{
+	const size_t vertex_count = data.vertices.size();
+	std::vector<GLuint> remap(vertex_count);
+	if (vertex_count == 0) return remap;
+
+	// with a cell size of twice the tolerance, equal vertices lie either in the same cell
+	// or in the neighboring cell on the side that is closer to the vertex
+	const bool exact = options.position_tolerance <= 0.f;
+	const float inverse_cell_size = exact ? 0.f : 0.5f / options.position_tolerance;
+
+	auto cellOf = [&](const glm::vec3 & p) -> glm::ivec3 {
+		if (exact) return glm::ivec3(0);
+		return glm::ivec3(static_cast<int>(std::floor(p.x * inverse_cell_size)),
+			static_cast<int>(std::floor(p.y * inverse_cell_size)),
+			static_cast<int>(std::floor(p.z * inverse_cell_size)));
+	};
+	auto hashCell = [&](const glm::ivec3 & cell, const glm::vec3 & p) -> unsigned long long {
+		unsigned long long h = 14695981039346656037ull;
+		auto mix = [&h](unsigned int v) {
+			h ^= v;
+			h *= 1099511628211ull;
+		};
+		if (exact) {
+			const unsigned int * bits = reinterpret_cast<const unsigned int *>(&p);
+			mix(bits[0]); mix(bits[1]); mix(bits[2]);
+		} else {
+			mix(static_cast<unsigned int>(cell.x)); mix(static_cast<unsigned int>(cell.y)); mix(static_cast<unsigned int>(cell.z));
+		}
+		return h;
+	};
+
+	// 1. hash the quantized positions
+	std::vector<unsigned long long> keys(vertex_count);
+	parallelFor(0, vertex_count, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; v++) {
+			const glm::vec3 & p = data.vertices[v].position;
+			keys[v] = hashCell(cellOf(p), p);
+		}
+	});
+
+	// 2. sort the vertices by key, so that every cell is a contiguous range sorted by vertex index
+	std::vector<GLuint> sorted(vertex_count);
+	std::iota(sorted.begin(), sorted.end(), 0);
+	parallelSort(sorted.begin(), sorted.end(), [&keys](GLuint a, GLuint b) {
+		return keys[a] != keys[b] ? keys[a] < keys[b] : a < b;
+	});
+	std::vector<unsigned long long> sorted_keys(vertex_count);
+	std::vector<GLuint> sorted_position(vertex_count);
+	parallelFor(0, vertex_count, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			sorted_keys[i] = keys[sorted[i]];
+			sorted_position[sorted[i]] = static_cast<GLuint>(i);
+		}
+	});
+
+	// 3. every vertex looks for an equal vertex with a smaller index, first in its own cell, then in the neighbors
+	std::vector<GLuint> representative(vertex_count);
+	parallelFor(0, vertex_count, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; v++) {
+			const T & vertex = data.vertices[v];
+			GLuint best = static_cast<GLuint>(v);
+
+			// the own cell ends with this vertex, the earlier vertices of the cell precede it
+			const size_t position = sorted_position[v];
+			size_t run_begin = position;
+			while (run_begin > 0 && sorted_keys[run_begin - 1] == keys[v]) run_begin--;
+			for (size_t i = run_begin; i < position; i++) {
+				if (T::isNearlyEqual(vertex, data.vertices[sorted[i]], options.position_tolerance, options.attribute_tolerance)) {
+					best = sorted[i];
+					break;
+				}
+			}
+
+			if (best == v && !exact) {
+				const glm::ivec3 cell = cellOf(vertex.position);
+				glm::ivec3 side;
+				for (int axis = 0; axis < 3; axis++) {
+					float scaled = vertex.position[axis] * inverse_cell_size;
+					side[axis] = scaled - std::floor(scaled) < 0.5f ? -1 : 1;
+				}
+				for (int neighbor = 1; neighbor < 8 && best == v; neighbor++) {
+					glm::ivec3 offset((neighbor & 1) ? side.x : 0, (neighbor & 2) ? side.y : 0, (neighbor & 4) ? side.z : 0);
+					unsigned long long key = hashCell(cell + offset, vertex.position);
+					auto range = std::equal_range(sorted_keys.begin(), sorted_keys.end(), key);
+					for (auto it = range.first; it != range.second; ++it) {
+						GLuint candidate = sorted[it - sorted_keys.begin()];
+						if (candidate >= v) break;
+						if (T::isNearlyEqual(vertex, data.vertices[candidate], options.position_tolerance, options.attribute_tolerance)) {
+							best = candidate;
+							break;
+						}
+					}
+				}
+			}
+			representative[v] = best;
+		}
+	});
+
+	// 4. follow chains of representatives and assign compact indices in the original order
+	GLuint unique_count = 0;
+	for (size_t v = 0; v < vertex_count; v++) {
+		GLuint r = representative[v];
+		if (r == v) {
+			remap[v] = unique_count++;
+		} else {
+			representative[v] = representative[r];
+			remap[v] = remap[r];
+		}
+	}
+
+	// 5. build the welded vertices and indices
+	std::vector<T> vertices;
+	vertices.reserve(unique_count);
+	for (size_t v = 0; v < vertex_count; v++) {
+		if (representative[v] == v) vertices.push_back(data.vertices[v]);
+	}
+
+	if (data.indices.has_value()) {
+		std::vector<GLuint> & indices = data.indices.value();
+		parallelFor(0, indices.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				if (indices[i] != RESTART_INDEX) indices[i] = remap[indices[i]];
+			}
+		});
+	} else {
+		data.indices = remap;
+	}
+	data.vertices = std::move(vertices);
+	return remap;
+}
+
+}
@@ -1,5 +1,8 @@
 #include <stdexcept>
 #include <mygl/AppFrame.hpp>
+#include <mygl/BufferHeap.hpp>
+#include <mygl/SamplerCache.hpp>
+#include <mygl/TextureManager.hpp>
 #include <iostream>
 
 using namespace mygl;
@@ -88,6 +91,10 @@ bool AppFrame::render() {
         this->app->render();
         glfwSwapBuffers(this->window);
     }
+    // the shared GL objects of the singletons have to be deleted while the context exists
+    BufferHeap::getInstance().release();
+    TextureManager::getInstance().releaseTextures();
+    SamplerCache::getInstance().release();
     glfwTerminate();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mygl/Bounds.hpp>
+#include <mygl/Parallel.hpp>
+
+using namespace mygl;
+
+Bounds mygl::calculateBounds(const std::vector<glm::vec3> & positions)
+{
+	Bounds bounds;
+	if (positions.empty()) return bounds;
+
+	const size_t chunk_count = std::max<size_t>(getWorkerCount(), 1);
+	const size_t chunk_size = (positions.size() + chunk_count - 1) / chunk_count;
+	std::vector<glm::vec3> chunk_min(chunk_count, glm::vec3(std::numeric_limits<float>::max()));
+	std::vector<glm::vec3> chunk_max(chunk_count, glm::vec3(-std::numeric_limits<float>::max()));
+	parallelFor(0, chunk_count, [&](size_t begin, size_t end) {
+		for (size_t c = begin; c < end; c++) {
+			const size_t first = c * chunk_size, last = std::min(positions.size(), first + chunk_size);
+			for (size_t v = first; v < last; v++) {
+				chunk_min[c] = glm::min(chunk_min[c], positions[v]);
+				chunk_max[c] = glm::max(chunk_max[c], positions[v]);
+			}
+		}
+	}, 1);
+
+	bounds.min = chunk_min[0];
+	bounds.max = chunk_max[0];
+	for (size_t c = 1; c < chunk_count; c++) {
+		bounds.min = glm::min(bounds.min, chunk_min[c]);
+		bounds.max = glm::max(bounds.max, chunk_max[c]);
+	}
+	bounds.center = (bounds.min + bounds.max) * 0.5f;
+
+	std::vector<float> chunk_radius(chunk_count, 0.f);
+	parallelFor(0, chunk_count, [&](size_t begin, size_t end) {
+		for (size_t c = begin; c < end; c++) {
+			const size_t first = c * chunk_size, last = std::min(positions.size(), first + chunk_size);
+			float radius_squared = 0.f;
+			for (size_t v = first; v < last; v++) {
+				glm::vec3 d = positions[v] - bounds.center;
+				radius_squared = std::max(radius_squared, glm::dot(d, d));
+			}
+			chunk_radius[c] = radius_squared;
+		}
+	}, 1);
+	bounds.radius = std::sqrt(*std::max_element(chunk_radius.begin(), chunk_radius.end()));
+	return bounds;
+}
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <mygl/BufferHeap.hpp>
+
+using namespace mygl;
+
+static inline size_t alignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+BufferHeap::BufferHeap(size_t page_size)
+{
+	this->page_size = std::max<size_t>(page_size, 1 << 16);
+}
+
+BufferHeap & BufferHeap::getInstance()
+{
+	static BufferHeap instance;
+	return instance;
+}
+
+uint32_t BufferHeap::createPage(size_t size)
+{
+	Page page;
+	page.size = size;
+	glCreateBuffers(1, &page.buffer);
+	glNamedBufferStorage(page.buffer, static_cast<GLsizeiptr>(size), NULL, GL_DYNAMIC_STORAGE_BIT | GL_MAP_WRITE_BIT);
+	insertFreeBlock(page, 0, size);
+
+	// reuse the slot of a released page, so that the page indices of live allocations stay valid
+	for (uint32_t p = 0; p < this->pages.size(); p++) {
+		if (this->pages[p].buffer == 0) {
+			this->pages[p] = std::move(page);
+			return p;
+		}
+	}
+	this->pages.push_back(std::move(page));
+	return static_cast<uint32_t>(this->pages.size() - 1);
+}
+
+void BufferHeap::releasePage(Page & page)
+{
+	for (auto & vertex_array : page.vertex_arrays) glDeleteVertexArrays(1, &vertex_array.second);
+	if (page.buffer != 0) glDeleteBuffers(1, &page.buffer);
+	page = Page();
+}
+
+void BufferHeap::insertFreeBlock(Page & page, size_t offset, size_t size)
+{
+	if (size == 0) return;
+
+	// coalesce with the neighboring free blocks
+	auto next = page.free_by_offset.lower_bound(offset);
+	if (next != page.free_by_offset.end() && next->first == offset + size) {
+		size += next->second;
+		eraseFreeBlock(page, next);
+	}
+	auto previous = page.free_by_offset.lower_bound(offset);
+	if (previous != page.free_by_offset.begin()) {
+		previous--;
+		if (previous->first + previous->second == offset) {
+			offset = previous->first;
+			size += previous->second;
+			eraseFreeBlock(page, previous);
+		}
+	}
+	page.free_by_offset[offset] = size;
+	page.free_by_size.insert({ size, offset });
+}
+
+void BufferHeap::eraseFreeBlock(Page & page, std::map<size_t, size_t>::iterator block)
+{
+	auto range = page.free_by_size.equal_range(block->second);
+	for (auto it = range.first; it != range.second; it++) {
+		if (it->second == block->first) {
+			page.free_by_size.erase(it);
+			break;
+		}
+	}
+	page.free_by_offset.erase(block);
+}
+
+bool BufferHeap::allocateFromPage(uint32_t page_index, size_t size, size_t alignment, size_t & offset)
+{
+	Page & page = this->pages[page_index];
+	if (page.buffer == 0 || page.size - page.used < size) return false;
+
+	// best fit: the smallest block that still holds the allocation after aligning its start
+	for (auto it = page.free_by_size.lower_bound(size); it != page.free_by_size.end(); it++) {
+		const size_t block_offset = it->second;
+		const size_t block_size = it->first;
+		const size_t aligned = alignUp(block_offset, alignment);
+		if (aligned + size > block_offset + block_size) continue;
+
+		eraseFreeBlock(page, page.free_by_offset.find(block_offset));
+		insertFreeBlock(page, block_offset, aligned - block_offset);
+		insertFreeBlock(page, aligned + size, block_offset + block_size - aligned - size);
+		page.used += size;
+		page.allocation_count++;
+		offset = aligned;
+		return true;
+	}
+	return false;
+}
+
+BufferHeap::Handle BufferHeap::allocate(size_t size, size_t alignment)
+{
+	size = std::max<size_t>(size, 1);
+	alignment = std::max<size_t>(alignment, 1);
+
+	size_t offset = 0;
+	uint32_t page_index = 0;
+	bool found = false;
+	for (; page_index < this->pages.size(); page_index++) {
+		found = allocateFromPage(page_index, size, alignment, offset);
+		if (found) break;
+	}
+	if (!found) {
+		page_index = createPage(std::max(this->page_size, alignUp(size, 1 << 16)));
+		if (!allocateFromPage(page_index, size, alignment, offset)) {
+			std::cerr << "ERROR::cannot allocate " << size << " bytes from the buffer heap" << std::endl;
+			throw std::runtime_error("cannot allocate from the buffer heap");
+		}
+	}
+
+	BufferAllocation allocation;
+	allocation.page = page_index;
+	allocation.buffer = this->pages[page_index].buffer;
+	allocation.offset = offset;
+	allocation.size = size;
+	allocation.alignment = alignment;
+	allocation.live = true;
+
+	if (!this->free_handles.empty()) {
+		Handle handle = this->free_handles.back();
+		this->free_handles.pop_back();
+		this->allocations[handle] = allocation;
+		return handle;
+	}
+	this->allocations.push_back(allocation);
+	return static_cast<Handle>(this->allocations.size() - 1);
+}
+
+void BufferHeap::free(Handle handle)
+{
+	if (handle == INVALID_HANDLE || handle >= this->allocations.size() || !this->allocations[handle].live) return;
+
+	BufferAllocation & allocation = this->allocations[handle];
+	Page & page = this->pages[allocation.page];
+	insertFreeBlock(page, allocation.offset, allocation.size);
+	page.used -= allocation.size;
+	page.allocation_count--;
+	allocation.live = false;
+	this->free_handles.push_back(handle);
+
+	if (page.allocation_count > 0) return;
+	const size_t page_count = std::count_if(this->pages.begin(), this->pages.end(), [](const Page & other) { return other.buffer != 0; });
+	if (page_count > 1) releasePage(page);
+}
+
+void BufferHeap::release()
+{
+	for (Page & page : this->pages) releasePage(page);
+	this->pages.clear();
+	this->allocations.clear();
+	this->free_handles.clear();
+}
+
+const BufferAllocation & BufferHeap::get(Handle handle) const
+{
+	return this->allocations[handle];
+}
+
+void BufferHeap::upload(Handle handle, size_t offset, const void * source, size_t size)
+{
+	const BufferAllocation & allocation = this->allocations[handle];
+	if (size == 0) return;
+	if (offset + size > allocation.size) {
+		std::cerr << "ERROR::upload exceeds the buffer allocation" << std::endl;
+		throw std::runtime_error("upload exceeds the buffer allocation");
+	}
+	glNamedBufferSubData(allocation.buffer, static_cast<GLintptr>(allocation.offset + offset), static_cast<GLsizeiptr>(size), source);
+}
+
+void BufferHeap::download(Handle handle, size_t offset, void * target, size_t size) const
+{
+	const BufferAllocation & allocation = this->allocations[handle];
+	if (size == 0) return;
+	if (offset + size > allocation.size) {
+		std::cerr << "ERROR::download exceeds the buffer allocation" << std::endl;
+		throw std::runtime_error("download exceeds the buffer allocation");
+	}
+	glGetNamedBufferSubData(allocation.buffer, static_cast<GLintptr>(allocation.offset + offset), static_cast<GLsizeiptr>(size), target);
+}
+
+void * BufferHeap::map(Handle handle)
+{
+	const BufferAllocation & allocation = this->allocations[handle];
+	return glMapNamedBufferRange(allocation.buffer, static_cast<GLintptr>(allocation.offset), static_cast<GLsizeiptr>(allocation.size),
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+void BufferHeap::unmap(Handle handle)
+{
+	glUnmapNamedBuffer(this->allocations[handle].buffer);
+}
+
+size_t BufferHeap::defragment(size_t max_moved_bytes)
+{
+	// the live allocations of every page, ordered by offset
+	std::vector<std::vector<Handle>> page_allocations(this->pages.size());
+	for (Handle h = 0; h < this->allocations.size(); h++) {
+		if (this->allocations[h].live) page_allocations[this->allocations[h].page].push_back(h);
+	}
+
+	size_t moved = 0;
+	for (uint32_t p = 0; p < this->pages.size(); p++) {
+		Page & page = this->pages[p];
+		if (page.buffer == 0) continue;
+		if (page.allocation_count == 0) {
+			releasePage(page);
+			continue;
+		}
+		// a page with a single free block can not become more compact
+		if (page.free_by_offset.size() <= 1 || moved + page.used > max_moved_bytes) continue;
+
+		std::vector<Handle> & handles = page_allocations[p];
+		std::sort(handles.begin(), handles.end(), [this](Handle a, Handle b) {
+			return this->allocations[a].offset < this->allocations[b].offset;
+		});
+
+		// copying inside of one buffer must not overlap, so the allocations are packed into a new buffer
+		GLuint buffer = 0;
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, static_cast<GLsizeiptr>(page.size), NULL, GL_DYNAMIC_STORAGE_BIT | GL_MAP_WRITE_BIT);
+		size_t end = 0;
+		for (Handle h : handles) {
+			BufferAllocation & allocation = this->allocations[h];
+			const size_t offset = alignUp(end, allocation.alignment);
+			glCopyNamedBufferSubData(page.buffer, buffer, static_cast<GLintptr>(allocation.offset), static_cast<GLintptr>(offset),
+				static_cast<GLsizeiptr>(allocation.size));
+			allocation.offset = offset;
+			allocation.buffer = buffer;
+			end = offset + allocation.size;
+			moved += allocation.size;
+		}
+
+		for (auto & vertex_array : page.vertex_arrays) glDeleteVertexArrays(1, &vertex_array.second);
+		page.vertex_arrays.clear();
+		glDeleteBuffers(1, &page.buffer);
+		page.buffer = buffer;
+		page.free_by_offset.clear();
+		page.free_by_size.clear();
+
+		// alignment gaps between the packed allocations stay available
+		size_t previous_end = 0;
+		for (Handle h : handles) {
+			insertFreeBlock(page, previous_end, this->allocations[h].offset - previous_end);
+			previous_end = this->allocations[h].offset + this->allocations[h].size;
+		}
+		insertFreeBlock(page, previous_end, page.size - previous_end);
+	}
+
+	this->defragmentation_count++;
+	this->moved_bytes += moved;
+	return moved;
+}
+
+BufferHeapStatistics BufferHeap::getStatistics() const
+{
+	BufferHeapStatistics statistics;
+	size_t free_bytes = 0, largest_free_bytes = 0;
+	for (const Page & page : this->pages) {
+		if (page.buffer == 0) continue;
+		statistics.page_count++;
+		statistics.reserved_bytes += page.size;
+		statistics.used_bytes += page.used;
+		statistics.allocation_count += page.allocation_count;
+		statistics.free_block_count += page.free_by_offset.size();
+		if (!page.free_by_size.empty()) {
+			const size_t largest = page.free_by_size.rbegin()->first;
+			statistics.largest_free_block = std::max(statistics.largest_free_block, largest);
+			largest_free_bytes += largest;
+		}
+		free_bytes += page.size - page.used;
+	}
+	statistics.fragmentation = free_bytes > 0 ? 1.f - static_cast<float>(largest_free_bytes) / static_cast<float>(free_bytes) : 0.f;
+	statistics.defragmentation_count = this->defragmentation_count;
+	statistics.moved_bytes = this->moved_bytes;
+	return statistics;
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <mygl/ChannelPacking.hpp>
+
+#include <stb_image.h>
+
+using namespace mygl;
+
+namespace {
+	// samples a channel bilinearly at the texel centers of the target size, clamped to the edges
+	float sampleChannel(const ChannelSource & source, float u, float v)
+	{
+		const float x = std::clamp(u * source.width - 0.5f, 0.f, static_cast<float>(source.width - 1));
+		const float y = std::clamp(v * source.height - 0.5f, 0.f, static_cast<float>(source.height - 1));
+		const int x0 = static_cast<int>(x), y0 = static_cast<int>(y);
+		const int x1 = std::min(x0 + 1, source.width - 1), y1 = std::min(y0 + 1, source.height - 1);
+		const float fx = x - x0, fy = y - y0;
+		auto texel = [&](int tx, int ty) {
+			return static_cast<float>(source.rgba[(static_cast<size_t>(ty) * source.width + tx) * 4 + source.channel]);
+		};
+		const float top = texel(x0, y0) * (1.f - fx) + texel(x1, y0) * fx;
+		const float bottom = texel(x0, y1) * (1.f - fx) + texel(x1, y1) * fx;
+		return top * (1.f - fy) + bottom * fy;
+	}
+
+	bool hasTexture(const std::optional<std::shared_ptr<Texture>> & texture)
+	{
+		return texture.has_value() && texture.value() && texture.value()->isSuccessfullyLoaded();
+	}
+
+	size_t countTextures(const Material & material)
+	{
+		std::set<Texture *> textures;
+		for (const std::optional<std::shared_ptr<Texture>> * texture : { &material.albedo.texture, &material.normal.texture, &material.roughness.texture,
+			&material.metallic.texture, &material.ao.texture, &material.height.texture, &material.opacity.texture }) {
+			if (texture->has_value() && texture->value()) textures.insert(texture->value().get());
+		}
+		return textures.size();
+	}
+}
+
+std::vector<unsigned char> mygl::packChannels(const std::array<ChannelSource, 4> & sources, int width, int height, const glm::vec4 & defaults)
+{
+	std::vector<unsigned char> packed(static_cast<size_t>(width) * height * 4);
+	for (size_t c = 0; c < 4; c++) {
+		const ChannelSource & source = sources[c];
+		if (!source.rgba) {
+			const unsigned char value = static_cast<unsigned char>(glm::clamp(defaults[c], 0.f, 1.f) * 255.f + 0.5f);
+			for (size_t t = 0; t < packed.size() / 4; t++) packed[t * 4 + c] = value;
+			continue;
+		}
+		const bool same_size = source.width == width && source.height == height;
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				const size_t t = static_cast<size_t>(y) * width + x;
+				if (same_size) {
+					packed[t * 4 + c] = source.rgba[t * 4 + source.channel];
+				}
+				else {
+					const float value = sampleChannel(source, (x + 0.5f) / width, (y + 0.5f) / height);
+					packed[t * 4 + c] = static_cast<unsigned char>(std::clamp(value + 0.5f, 0.f, 255.f));
+				}
+			}
+		}
+	}
+	return packed;
+}
+
+size_t mygl::packMaterialChannels(Material & material)
+{
+	const size_t before = countTextures(material);
+	std::map<Texture *, std::vector<unsigned char>> pixels;
+	auto readSource = [&pixels](const MaterialProperty<float> & property, ChannelSource & source) {
+		if (!hasTexture(property.texture)) return false;
+		Texture & texture = *property.texture.value();
+		auto found = pixels.find(&texture);
+		if (found == pixels.end()) found = pixels.emplace(&texture, texture.readPixels()).first;
+		if (found->second.empty()) return false;
+		source = { found->second.data(), texture.getWidth(), texture.getHeight(), std::min(property.channel, 3u) };
+		return true;
+	};
+
+	// the packed texture gets the size of the largest map
+	MaterialProperty<float> * properties[4] = {};
+	properties[PACKED_AO_CHANNEL] = &material.ao;
+	properties[PACKED_ROUGHNESS_CHANNEL] = &material.roughness;
+	properties[PACKED_METALLIC_CHANNEL] = &material.metallic;
+	properties[PACKED_HEIGHT_CHANNEL] = &material.height;
+	std::array<ChannelSource, 4> sources;
+	std::set<Texture *> textures;
+	int width = 0, height = 0;
+	for (size_t c = 0; c < 4; c++) {
+		if (!readSource(*properties[c], sources[c])) continue;
+		textures.insert(properties[c]->texture.value().get());
+		width = std::max(width, sources[c].width);
+		height = std::max(height, sources[c].height);
+	}
+	// the maps may already share a single texture, like the metallic-roughness texture of glTF
+	if (textures.size() > 1) {
+		glm::vec4 defaults;
+		for (size_t c = 0; c < 4; c++) defaults[c] = properties[c]->value_default;
+		const std::vector<unsigned char> packed = packChannels(sources, width, height, defaults);
+		std::shared_ptr<Texture> texture(new Texture(packed.data(), width, height, "packed_" + PACKED_PROPERTY_NAME));
+		for (size_t c = 0; c < 4; c++) {
+			if (!sources[c].rgba) continue;
+			properties[c]->texture = texture;
+			properties[c]->channel = static_cast<uint32_t>(c);
+		}
+	}
+
+	// the albedo texture carries the opacity in its otherwise unused alpha channel
+	ChannelSource opacity;
+	if (hasTexture(material.albedo.texture) && material.opacity.texture != material.albedo.texture && readSource(material.opacity, opacity)) {
+		Texture & albedo = *material.albedo.texture.value();
+		const std::vector<unsigned char> colors = albedo.readPixels();
+		if (!colors.empty()) {
+			std::array<ChannelSource, 4> channels;
+			for (uint32_t c = 0; c < 3; c++) channels[c] = { colors.data(), albedo.getWidth(), albedo.getHeight(), c };
+			channels[3] = opacity;
+			const std::vector<unsigned char> packed = packChannels(channels, albedo.getWidth(), albedo.getHeight(), glm::vec4(1.f));
+			std::shared_ptr<Texture> texture(new Texture(packed.data(), albedo.getWidth(), albedo.getHeight(), "packed_albedo_opacity", 0, TextureContent::Color));
+			material.albedo.texture = texture;
+			material.opacity.texture = texture;
+			material.opacity.channel = 3;
+		}
+	}
+
+	return before - std::min(before, countTextures(material));
+}
+
+void mygl::packChannelFiles(const std::array<std::string, 4> & inputs, const std::string & output, const TextureCookOptions & options, const glm::vec4 & defaults)
+{
+	std::array<ChannelSource, 4> sources;
+	std::array<unsigned char *, 4> images = {};
+	int width = 0, height = 0;
+	for (size_t c = 0; c < 4; c++) {
+		if (inputs[c].empty()) continue;
+		int channels = 0;
+		images[c] = stbi_load(inputs[c].c_str(), &sources[c].width, &sources[c].height, &channels, STBI_rgb_alpha);
+		if (!images[c])
+		{
+			for (unsigned char * image : images) if (image) stbi_image_free(image);
+			std::cerr << "ERROR::cannot load image " << inputs[c] << std::endl;
+			throw std::runtime_error("cannot load image " + inputs[c]);
+		}
+		sources[c].rgba = images[c];
+		width = std::max(width, sources[c].width);
+		height = std::max(height, sources[c].height);
+	}
+	if (width == 0 || height == 0) {
+		std::cerr << "ERROR::no image to pack into " << output << std::endl;
+		throw std::runtime_error("no image to pack into " + output);
+	}
+
+	const std::vector<unsigned char> packed = packChannels(sources, width, height, defaults);
+	for (unsigned char * image : images) if (image) stbi_image_free(image);
+	writeTextureFile(output, cookTexture(packed.data(), static_cast<uint32_t>(width), static_cast<uint32_t>(height), options));
+}
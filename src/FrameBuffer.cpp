@@ -1,55 +1,93 @@
 #include <mygl/FrameBuffer.hpp>
+#include <mygl/SamplerCache.hpp>
 
 using namespace mygl;
 
+namespace {
+    // immutable storage needs a sized internal format, unsized ones get the size of their data type
+    GLenum getSizedFormat(GLenum format, GLenum type)
+    {
+        const size_t size = type == GL_FLOAT ? 2 : (type == GL_HALF_FLOAT ? 1 : 0);
+        switch (format)
+        {
+        case GL_RED: return std::array<GLenum, 3>{ GL_R8, GL_R16F, GL_R32F }[size];
+        case GL_RG: return std::array<GLenum, 3>{ GL_RG8, GL_RG16F, GL_RG32F }[size];
+        case GL_RGB: return std::array<GLenum, 3>{ GL_RGB8, GL_RGB16F, GL_RGB32F }[size];
+        case GL_RGBA: return std::array<GLenum, 3>{ GL_RGBA8, GL_RGBA16F, GL_RGBA32F }[size];
+        default: return format;
+        }
+    }
+}
+
 FrameBuffer::FrameBuffer(FrameBufferConfiguration & config, ScreenResolution & screen_res)
 {
-    glGenFramebuffers(1, &(this->ID));
-    glBindFramebuffer(GL_FRAMEBUFFER, this->ID);
+    glCreateFramebuffers(1, &(this->ID));
 
+    const GLenum internal_format = getSizedFormat(config.color_profile, config.data_type);
+    std::vector<GLenum> attachments;
     this->texture_color_buffer_IDs.reserve(config.num_color_buffers);
-    for (GLuint i = 0; i < texture_color_buffer_IDs.capacity(); ++i)
+    for (GLuint i = 0; i < config.num_color_buffers; ++i)
     {
         GLuint textureID;
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, config.color_profile, screen_res.width, screen_res.height, 0, config.color_type, config.data_type, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, textureID, 0);
+        glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
+        glTextureStorage2D(textureID, 1, internal_format, screen_res.width, screen_res.height);
+        // the default state would sample missing mipmaps and repeat, which breaks users of the raw texture without a sampler
+        glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glNamedFramebufferTexture(this->ID, GL_COLOR_ATTACHMENT0 + i, textureID, 0);
         this->texture_color_buffer_IDs.push_back(textureID);
+        attachments.push_back(GL_COLOR_ATTACHMENT0 + i);
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    GLuint attachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
-    glDrawBuffers(config.num_color_buffers, attachments);
+    glNamedFramebufferDrawBuffers(this->ID, static_cast<GLsizei>(attachments.size()), attachments.data());
 
     if (config.use_depth_buffer)
     {
         GLuint RBO;
-        glGenRenderbuffers(1, &RBO);
+        glCreateRenderbuffers(1, &RBO);
         this->RBO = RBO;
-		glBindRenderbuffer(GL_RENDERBUFFER, RBO);
-		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, screen_res.width, screen_res.height);
-        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        glNamedRenderbufferStorage(RBO, GL_DEPTH_COMPONENT24, screen_res.width, screen_res.height);
+        glNamedFramebufferRenderbuffer(this->ID, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, RBO);
+    }
 
-		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, RBO);
+    if (glCheckNamedFramebufferStatus(this->ID, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "ERROR::cannot initialize framebuffer" << std::endl;
+        throw std::runtime_error("cannot initialize framebuffer");
     }
+}
 
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+FrameBuffer::FrameBuffer(const std::vector<GLuint> & color_textures, std::optional<GLuint> depth_texture, GLenum depth_attachment)
+{
+    glCreateFramebuffers(1, &(this->ID));
+    this->owns_attachments = false;
+    this->texture_color_buffer_IDs = color_textures;
+
+    std::vector<GLenum> attachments;
+    for (GLuint i = 0; i < color_textures.size(); ++i)
     {
+        glNamedFramebufferTexture(this->ID, GL_COLOR_ATTACHMENT0 + i, color_textures[i], 0);
+        attachments.push_back(GL_COLOR_ATTACHMENT0 + i);
+    }
+    // depth only passes (e.g. shadow maps) draw into no color buffer
+    if (attachments.empty()) glNamedFramebufferDrawBuffer(this->ID, GL_NONE);
+    else glNamedFramebufferDrawBuffers(this->ID, static_cast<GLsizei>(attachments.size()), attachments.data());
+
+    if (depth_texture.has_value()) glNamedFramebufferTexture(this->ID, depth_attachment, depth_texture.value(), 0);
+
+    if (glCheckNamedFramebufferStatus(this->ID, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        glDeleteFramebuffers(1, &(this->ID));
         std::cerr << "ERROR::cannot initialize framebuffer" << std::endl;
         throw std::runtime_error("cannot initialize framebuffer");
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 FrameBuffer::~FrameBuffer()
 {
     glDeleteFramebuffers(1, &(this->ID));
-    for (GLuint i = 0; i < this->texture_color_buffer_IDs.size(); ++i)
+    for (GLuint i = 0; this->owns_attachments && i < this->texture_color_buffer_IDs.size(); ++i)
     {
         glDeleteTextures(1, &(this->texture_color_buffer_IDs[i]));
     }
@@ -79,6 +117,18 @@ GLuint FrameBuffer::getColorBufferID(size_t idx)
     return this->texture_color_buffer_IDs[idx];
 }
 
+void FrameBuffer::bindColorBuffer(size_t idx, GLenum textureUnit)
+{
+    // the attachments have a single level and are sampled without repetition
+    SamplerDescription sampler;
+    sampler.min_filter = GL_LINEAR;
+    sampler.wrap_s = GL_CLAMP_TO_EDGE;
+    sampler.wrap_t = GL_CLAMP_TO_EDGE;
+    sampler.max_anisotropy = 1.f;
+    glBindTextureUnit(textureUnit - GL_TEXTURE0, this->texture_color_buffer_IDs[idx]);
+    glBindSampler(textureUnit - GL_TEXTURE0, SamplerCache::getInstance().getSampler(sampler));
+}
+
 void FrameBuffer::setDebugName(const std::string name)
 {
     this->debug_name = name;
@@ -0,0 +1,83 @@
+#include <unordered_map>
+#include <mygl/IndexFormat.hpp>
+
+using namespace mygl;
+
+GLenum mygl::chooseIndexType(size_t vertex_count)
+{
+	return vertex_count <= MAX_VERTICES_16BIT ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+size_t mygl::getIndexSize(GLenum index_type)
+{
+	switch (index_type)
+	{
+	case GL_UNSIGNED_BYTE:
+		return sizeof(GLubyte);
+	case GL_UNSIGNED_SHORT:
+		return sizeof(GLushort);
+	default:
+		return sizeof(GLuint);
+	}
+}
+
+std::vector<GLushort> mygl::packIndices16(const std::vector<GLuint> & indices)
+{
+	std::vector<GLushort> packed(indices.size());
+	for (size_t i = 0; i < indices.size(); i++) {
+		packed[i] = indices[i] == RESTART_INDEX ? static_cast<GLushort>(0xFFFF) : static_cast<GLushort>(indices[i]);
+	}
+	return packed;
+}
+
+std::vector<IndexChunk> mygl::splitIndices16(const std::vector<GLuint> & indices, std::vector<GLuint> & out_vertex_order, std::vector<GLushort> & out_indices)
+{
+	std::vector<IndexChunk> chunks;
+	out_vertex_order.clear();
+	out_indices.clear();
+	out_indices.reserve(indices.size());
+
+	std::unordered_map<GLuint, GLushort> local_vertices;
+	IndexChunk chunk;
+	for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+		// start a new chunk if the triangle might not fit into the current one
+		if (local_vertices.size() + 3 > MAX_VERTICES_16BIT) {
+			chunk.index_count = out_indices.size() - chunk.index_offset;
+			chunks.push_back(chunk);
+
+			chunk.index_offset = out_indices.size();
+			chunk.base_vertex = static_cast<GLint>(out_vertex_order.size());
+			local_vertices.clear();
+		}
+
+		for (size_t k = 0; k < 3; k++) {
+			GLuint vertex = indices[t + k];
+			auto it = local_vertices.find(vertex);
+			if (it == local_vertices.end()) {
+				GLushort local = static_cast<GLushort>(local_vertices.size());
+				it = local_vertices.emplace(vertex, local).first;
+				out_vertex_order.push_back(vertex);
+			}
+			out_indices.push_back(it->second);
+		}
+	}
+	chunk.index_count = out_indices.size() - chunk.index_offset;
+	if (chunk.index_count > 0) chunks.push_back(chunk);
+	return chunks;
+}
+
+bool mygl::isStripGeometry(GLenum geometry_type)
+{
+	switch (geometry_type)
+	{
+	case GL_LINE_STRIP:
+	case GL_LINE_LOOP:
+	case GL_LINE_STRIP_ADJACENCY:
+	case GL_TRIANGLE_STRIP:
+	case GL_TRIANGLE_FAN:
+	case GL_TRIANGLE_STRIP_ADJACENCY:
+		return true;
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,292 @@
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <mygl/Json.hpp>
+
+using namespace mygl;
+
+namespace mygl {
+	class JsonParser;
+}
+
+/**
+ * @brief A recursive descent parser for JsonValue.
+ */
+class mygl::JsonParser {
+public:
+	JsonParser(const char * text, size_t length) : current(text), end(text + length) {}
+
+	JsonValue parseDocument()
+	{
+		JsonValue value = parseValue(0);
+		skipWhitespace();
+		if (this->current != this->end) fail("unexpected characters after the document");
+		return value;
+	}
+
+private:
+	const char * current;
+	const char * end;
+
+	static const int MAX_DEPTH = 512;
+
+	[[noreturn]] void fail(const std::string & reason)
+	{
+		throw std::runtime_error("invalid json: " + reason);
+	}
+
+	void skipWhitespace()
+	{
+		while (this->current != this->end && (*this->current == ' ' || *this->current == '\t' || *this->current == '\n' || *this->current == '\r')) {
+			this->current++;
+		}
+	}
+
+	bool consume(const char * literal)
+	{
+		size_t length = std::strlen(literal);
+		if (static_cast<size_t>(this->end - this->current) < length || std::strncmp(this->current, literal, length) != 0) return false;
+		this->current += length;
+		return true;
+	}
+
+	JsonValue parseValue(int depth)
+	{
+		if (depth > MAX_DEPTH) fail("nested too deeply");
+		skipWhitespace();
+		if (this->current == this->end) fail("unexpected end");
+
+		JsonValue value;
+		switch (*this->current) {
+		case '{':
+			value.type = JsonValue::Type::Object;
+			this->current++;
+			skipWhitespace();
+			if (this->current != this->end && *this->current == '}') {
+				this->current++;
+				return value;
+			}
+			while (true) {
+				skipWhitespace();
+				std::string key = parseString();
+				skipWhitespace();
+				if (this->current == this->end || *this->current != ':') fail("expected ':'");
+				this->current++;
+				value.object[key] = parseValue(depth + 1);
+				skipWhitespace();
+				if (this->current == this->end) fail("unexpected end");
+				if (*this->current == ',') { this->current++; continue; }
+				if (*this->current == '}') { this->current++; break; }
+				fail("expected ',' or '}'");
+			}
+			return value;
+		case '[':
+			value.type = JsonValue::Type::Array;
+			this->current++;
+			skipWhitespace();
+			if (this->current != this->end && *this->current == ']') {
+				this->current++;
+				return value;
+			}
+			while (true) {
+				value.array.push_back(parseValue(depth + 1));
+				skipWhitespace();
+				if (this->current == this->end) fail("unexpected end");
+				if (*this->current == ',') { this->current++; continue; }
+				if (*this->current == ']') { this->current++; break; }
+				fail("expected ',' or ']'");
+			}
+			return value;
+		case '"':
+			value.type = JsonValue::Type::String;
+			value.string = parseString();
+			return value;
+		case 't':
+			if (!consume("true")) fail("invalid literal");
+			value.type = JsonValue::Type::Bool;
+			value.boolean = true;
+			return value;
+		case 'f':
+			if (!consume("false")) fail("invalid literal");
+			value.type = JsonValue::Type::Bool;
+			return value;
+		case 'n':
+			if (!consume("null")) fail("invalid literal");
+			return value;
+		default:
+			value.type = JsonValue::Type::Number;
+			value.number = parseNumber();
+			return value;
+		}
+	}
+
+	double parseNumber()
+	{
+		// strtod needs a terminated string, numbers are short enough for a local copy
+		char buffer[64];
+		size_t length = 0;
+		while (this->current != this->end && length < sizeof(buffer) - 1 && std::strchr("+-0123456789.eE", *this->current)) {
+			buffer[length++] = *this->current++;
+		}
+		buffer[length] = '\0';
+		char * parsed_end = nullptr;
+		double number = std::strtod(buffer, &parsed_end);
+		if (length == 0 || parsed_end != buffer + length) fail("invalid number");
+		return number;
+	}
+
+	static void appendUtf8(std::string & target, unsigned int code_point)
+	{
+		if (code_point < 0x80) {
+			target += static_cast<char>(code_point);
+		} else if (code_point < 0x800) {
+			target += static_cast<char>(0xC0 | (code_point >> 6));
+			target += static_cast<char>(0x80 | (code_point & 0x3F));
+		} else if (code_point < 0x10000) {
+			target += static_cast<char>(0xE0 | (code_point >> 12));
+			target += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			target += static_cast<char>(0x80 | (code_point & 0x3F));
+		} else {
+			target += static_cast<char>(0xF0 | (code_point >> 18));
+			target += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+			target += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+			target += static_cast<char>(0x80 | (code_point & 0x3F));
+		}
+	}
+
+	unsigned int parseHex4()
+	{
+		if (this->end - this->current < 4) fail("invalid escape");
+		unsigned int value = 0;
+		for (int i = 0; i < 4; i++) {
+			char c = *this->current++;
+			value <<= 4;
+			if (c >= '0' && c <= '9') value |= c - '0';
+			else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+			else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+			else fail("invalid escape");
+		}
+		return value;
+	}
+
+	std::string parseString()
+	{
+		if (this->current == this->end || *this->current != '"') fail("expected string");
+		this->current++;
+		std::string result;
+		while (true) {
+			if (this->current == this->end) fail("unterminated string");
+			char c = *this->current++;
+			if (c == '"') break;
+			if (c != '\\') {
+				result += c;
+				continue;
+			}
+			if (this->current == this->end) fail("unterminated string");
+			char escape = *this->current++;
+			switch (escape) {
+			case '"': result += '"'; break;
+			case '\\': result += '\\'; break;
+			case '/': result += '/'; break;
+			case 'b': result += '\b'; break;
+			case 'f': result += '\f'; break;
+			case 'n': result += '\n'; break;
+			case 'r': result += '\r'; break;
+			case 't': result += '\t'; break;
+			case 'u': {
+				unsigned int code_point = parseHex4();
+				// a high surrogate has to be followed by a low one, a lone surrogate is no code point
+				if (code_point >= 0xD800 && code_point < 0xDC00) {
+					if (!consume("\\u")) fail("invalid escape");
+					unsigned int low = parseHex4();
+					if (low < 0xDC00 || low > 0xDFFF) fail("invalid escape");
+					code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+				}
+				else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+					fail("invalid escape");
+				}
+				appendUtf8(result, code_point);
+				break;
+			}
+			default:
+				fail("invalid escape");
+			}
+		}
+		return result;
+	}
+};
+
+static const JsonValue NULL_VALUE;
+
+JsonValue::JsonValue()
+{
+
+}
+
+JsonValue JsonValue::parse(const char * text, size_t length)
+{
+	JsonParser parser(text, length);
+	return parser.parseDocument();
+}
+
+JsonValue JsonValue::parse(const std::string & text)
+{
+	return parse(text.data(), text.size());
+}
+
+JsonValue::Type JsonValue::getType() const { return this->type; }
+bool JsonValue::isNull() const { return this->type == Type::Null; }
+bool JsonValue::isNumber() const { return this->type == Type::Number; }
+bool JsonValue::isString() const { return this->type == Type::String; }
+bool JsonValue::isArray() const { return this->type == Type::Array; }
+bool JsonValue::isObject() const { return this->type == Type::Object; }
+
+bool JsonValue::has(const std::string & key) const
+{
+	return this->type == Type::Object && this->object.find(key) != this->object.end();
+}
+
+const JsonValue & JsonValue::operator [] (const std::string & key) const
+{
+	if (this->type != Type::Object) return NULL_VALUE;
+	auto it = this->object.find(key);
+	return it == this->object.end() ? NULL_VALUE : it->second;
+}
+
+const JsonValue & JsonValue::operator [] (size_t index) const
+{
+	if (this->type != Type::Array || index >= this->array.size()) return NULL_VALUE;
+	return this->array[index];
+}
+
+size_t JsonValue::size() const
+{
+	if (this->type == Type::Array) return this->array.size();
+	if (this->type == Type::Object) return this->object.size();
+	return 0;
+}
+
+double JsonValue::asNumber(double fallback) const
+{
+	return this->type == Type::Number ? this->number : fallback;
+}
+
+int JsonValue::asInt(int fallback) const
+{
+	return this->type == Type::Number ? static_cast<int>(this->number) : fallback;
+}
+
+bool JsonValue::asBool(bool fallback) const
+{
+	return this->type == Type::Bool ? this->boolean : fallback;
+}
+
+std::string JsonValue::asString(const std::string & fallback) const
+{
+	return this->type == Type::String ? this->string : fallback;
+}
+
+const std::map<std::string, JsonValue> & JsonValue::getMembers() const
+{
+	return this->object;
+}
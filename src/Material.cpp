@@ -1,30 +1,72 @@
+#include <filesystem>
 #include <mygl/Material.hpp>
+#include <mygl/ChannelPacking.hpp>
+#include <mygl/TextureManager.hpp>
 
 using namespace mygl;
 
+namespace {
+	bool hasPackedTexture(std::string library, std::string name, std::string separator, std::string fileType)
+	{
+		std::error_code error;
+		return std::filesystem::is_regular_file(library + name + separator + PACKED_PROPERTY_NAME + "." + fileType, error);
+	}
+
+	// the property decides how the mipmaps of its texture are filtered
+	TextureContent getTextureContent(const std::string & property_name)
+	{
+		if (property_name == "albedo") return TextureContent::Color;
+		if (property_name == "normal") return TextureContent::Normal;
+		return TextureContent::Linear;
+	}
+}
+
 template<typename T>
 MaterialProperty<T>::MaterialProperty() {
 	this->value_default = (T)0.f;
 	this->texture = std::nullopt;
+	this->channel = 0;
 }
 
 template<typename T>
 MaterialProperty<T>::MaterialProperty(T value_default) {
 	this->value_default = value_default;
 	this->texture = std::nullopt;
+	this->channel = 0;
 }
 
 template<typename T>
 void MaterialProperty<T>::loadTexture(std::string library, std::string texture_name, std::string separator, std::string property_name, std::string fileType)
 {
-	auto tmp = std::shared_ptr<Texture>(new Texture(library, texture_name + separator + property_name + period + fileType));
+	auto tmp = TextureManager::getInstance().acquireTexture(library + texture_name + separator + property_name + period + fileType, nullptr, glm::vec4(1.f),
+		getTextureContent(property_name));
 	if (tmp->isSuccessfullyLoaded()) this->texture = tmp;
 }
 
 template<typename T>
 void MaterialProperty<T>::loadTexture(std::string texture_name, std::string separator, std::string property_name, std::string fileType)
 {
-	auto tmp = std::shared_ptr<Texture>(new Texture(texture_name + separator + property_name + period + fileType));
+	auto tmp = TextureManager::getInstance().acquireTexture(defaultLibrary + texture_name + separator + property_name + period + fileType, nullptr, glm::vec4(1.f),
+		getTextureContent(property_name));
+	if (tmp->isSuccessfullyLoaded()) this->texture = tmp;
+}
+
+template<typename T>
+void MaterialProperty<T>::loadTexture(TextureLoader & loader, std::string library, std::string texture_name, std::string separator, std::string property_name,
+	std::string fileType, const glm::vec4 & placeholder)
+{
+	// the loader cannot report a missing file before its placeholder is used, so the default value is kept instead
+	const std::string path = library + texture_name + separator + property_name + period + fileType;
+	std::error_code error;
+	if (!std::filesystem::is_regular_file(path, error)) return;
+	this->texture = TextureManager::getInstance().acquireTexture(path, &loader, placeholder, getTextureContent(property_name));
+}
+
+template<typename T>
+void MaterialProperty<T>::loadTexture(TextureStreamer & streamer, std::string library, std::string texture_name, std::string separator, std::string property_name,
+	std::string fileType)
+{
+	auto tmp = streamer.load(library + texture_name + separator + property_name + period + fileType);
 	if (tmp->isSuccessfullyLoaded()) this->texture = tmp;
 }
 
@@ -38,16 +80,23 @@ Material::Material() {
 	this->opacity = MaterialProperty<float>(1.f);
 
 	this->height_scale = 1.0f;
+	this->uv_transform = glm::vec4(1.f, 1.f, 0.f, 0.f);
 }
 
 void Material::loadTextures(std::string library, std::string name, std::string separator, std::string fileType)
 {
 	this->albedo.loadTexture(library, name, separator, "albedo", fileType);
 	this->normal.loadTexture(library, name, separator, "normal", fileType);
-	this->roughness.loadTexture(library, name, separator, "roughness", fileType);
-	this->metallic.loadTexture(library, name, separator, "metallic", fileType);
-	this->ao.loadTexture(library, name, separator, "ao", fileType);
-	this->height.loadTexture(library, name, separator, "height", fileType);
+	if (hasPackedTexture(library, name, separator, fileType)) {
+		this->ao.loadTexture(library, name, separator, PACKED_PROPERTY_NAME, fileType);
+		if (this->ao.texture.has_value()) setPackedTexture(this->ao.texture.value());
+	}
+	else {
+		this->roughness.loadTexture(library, name, separator, "roughness", fileType);
+		this->metallic.loadTexture(library, name, separator, "metallic", fileType);
+		this->ao.loadTexture(library, name, separator, "ao", fileType);
+		this->height.loadTexture(library, name, separator, "height", fileType);
+	}
 	this->opacity.loadTexture(library, name, separator, "opacity", fileType);
 }
 
@@ -55,20 +104,99 @@ void Material::loadTextures(std::string name, std::string separator, std::string
 {
 	this->albedo.loadTexture(name, separator, "albedo", fileType);
 	this->normal.loadTexture(name, separator, "normal", fileType);
-	this->roughness.loadTexture(name, separator, "roughness", fileType);
-	this->metallic.loadTexture(name, separator, "metallic", fileType);
-	this->ao.loadTexture(name, separator, "ao", fileType);
-	this->height.loadTexture(name, separator, "height", fileType);
+	if (hasPackedTexture(defaultLibrary, name, separator, fileType)) {
+		this->ao.loadTexture(name, separator, PACKED_PROPERTY_NAME, fileType);
+		if (this->ao.texture.has_value()) setPackedTexture(this->ao.texture.value());
+	}
+	else {
+		this->roughness.loadTexture(name, separator, "roughness", fileType);
+		this->metallic.loadTexture(name, separator, "metallic", fileType);
+		this->ao.loadTexture(name, separator, "ao", fileType);
+		this->height.loadTexture(name, separator, "height", fileType);
+	}
 	this->opacity.loadTexture(name, separator, "opacity", fileType);
 }
 
+void Material::loadTextures(TextureLoader & loader, std::string library, std::string name, std::string separator, std::string fileType)
+{
+	// normal maps encode the default direction (0, 0, 1) as (0.5, 0.5, 1)
+	this->albedo.loadTexture(loader, library, name, separator, "albedo", fileType, glm::vec4(this->albedo.value_default, 1.f));
+	this->normal.loadTexture(loader, library, name, separator, "normal", fileType, glm::vec4(this->normal.value_default * 0.5f + 0.5f, 1.f));
+	if (hasPackedTexture(library, name, separator, fileType)) {
+		glm::vec4 placeholder;
+		placeholder[PACKED_AO_CHANNEL] = this->ao.value_default;
+		placeholder[PACKED_ROUGHNESS_CHANNEL] = this->roughness.value_default;
+		placeholder[PACKED_METALLIC_CHANNEL] = this->metallic.value_default;
+		placeholder[PACKED_HEIGHT_CHANNEL] = this->height.value_default;
+		this->ao.loadTexture(loader, library, name, separator, PACKED_PROPERTY_NAME, fileType, placeholder);
+		if (this->ao.texture.has_value()) setPackedTexture(this->ao.texture.value());
+	}
+	else {
+		this->roughness.loadTexture(loader, library, name, separator, "roughness", fileType, glm::vec4(glm::vec3(this->roughness.value_default), 1.f));
+		this->metallic.loadTexture(loader, library, name, separator, "metallic", fileType, glm::vec4(glm::vec3(this->metallic.value_default), 1.f));
+		this->ao.loadTexture(loader, library, name, separator, "ao", fileType, glm::vec4(glm::vec3(this->ao.value_default), 1.f));
+		this->height.loadTexture(loader, library, name, separator, "height", fileType, glm::vec4(glm::vec3(this->height.value_default), 1.f));
+	}
+	this->opacity.loadTexture(loader, library, name, separator, "opacity", fileType, glm::vec4(glm::vec3(this->opacity.value_default), 1.f));
+}
+
+void Material::loadTextures(TextureStreamer & streamer, std::string library, std::string name, std::string separator, std::string fileType)
+{
+	this->albedo.loadTexture(streamer, library, name, separator, "albedo", fileType);
+	this->normal.loadTexture(streamer, library, name, separator, "normal", fileType);
+	if (hasPackedTexture(library, name, separator, fileType)) {
+		this->ao.loadTexture(streamer, library, name, separator, PACKED_PROPERTY_NAME, fileType);
+		if (this->ao.texture.has_value()) setPackedTexture(this->ao.texture.value());
+	}
+	else {
+		this->roughness.loadTexture(streamer, library, name, separator, "roughness", fileType);
+		this->metallic.loadTexture(streamer, library, name, separator, "metallic", fileType);
+		this->ao.loadTexture(streamer, library, name, separator, "ao", fileType);
+		this->height.loadTexture(streamer, library, name, separator, "height", fileType);
+	}
+	this->opacity.loadTexture(streamer, library, name, separator, "opacity", fileType);
+}
+
+void Material::setPackedTexture(std::shared_ptr<Texture> texture)
+{
+	this->ao.texture = texture;
+	this->ao.channel = PACKED_AO_CHANNEL;
+	this->roughness.texture = texture;
+	this->roughness.channel = PACKED_ROUGHNESS_CHANNEL;
+	this->metallic.texture = texture;
+	this->metallic.channel = PACKED_METALLIC_CHANNEL;
+	this->height.texture = texture;
+	this->height.channel = PACKED_HEIGHT_CHANNEL;
+}
+
+std::array<GLuint, 7> Material::getTextureUnits(GLuint textureUnitsBegin) const
+{
+	const std::optional<std::shared_ptr<Texture>> * textures[] = {
+		&this->albedo.texture, &this->normal.texture, &this->roughness.texture, &this->metallic.texture,
+		&this->ao.texture, &this->height.texture, &this->opacity.texture
+	};
+	std::array<GLuint, 7> units;
+	for (GLuint p = 0; p < units.size(); p++) {
+		units[p] = textureUnitsBegin + p;
+		if (!textures[p]->has_value()) continue;
+		for (GLuint q = 0; q < p; q++) {
+			if (textures[q]->has_value() && textures[q]->value() == textures[p]->value()) {
+				units[p] = units[q];
+				break;
+			}
+		}
+	}
+	return units;
+}
+
 void Material::bindTextures(GLuint textureUnitsBegin)
 {
-	if (this->albedo.texture.has_value())		this->albedo.texture.value()->bind(GL_TEXTURE0 + textureUnitsBegin);
-	if (this->normal.texture.has_value())		this->normal.texture.value()->bind(GL_TEXTURE0 + textureUnitsBegin + 1);
-	if (this->roughness.texture.has_value())	this->roughness.texture.value()->bind(GL_TEXTURE0 + textureUnitsBegin + 2);
-	if (this->metallic.texture.has_value())		this->metallic.texture.value()->bind(GL_TEXTURE0 + textureUnitsBegin + 3);
-	if (this->ao.texture.has_value())			this->ao.texture.value()->bind(GL_TEXTURE0 + textureUnitsBegin + 4);
-	if (this->height.texture.has_value())		this->height.texture.value()->bind(GL_TEXTURE0 + textureUnitsBegin + 5);
-	if (this->opacity.texture.has_value())		this->opacity.texture.value()->bind(GL_TEXTURE0 + textureUnitsBegin + 6);
+	const std::optional<std::shared_ptr<Texture>> * textures[] = {
+		&this->albedo.texture, &this->normal.texture, &this->roughness.texture, &this->metallic.texture,
+		&this->ao.texture, &this->height.texture, &this->opacity.texture
+	};
+	const std::array<GLuint, 7> units = getTextureUnits(textureUnitsBegin);
+	for (GLuint p = 0; p < units.size(); p++) {
+		if (textures[p]->has_value() && units[p] == textureUnitsBegin + p) textures[p]->value()->bind(GL_TEXTURE0 + units[p]);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mygl/MeshAttributes.hpp>
+
+using namespace mygl;
+
+/**
+ * @brief Returns a unit vector that is orthogonal to the given unit vector.
+ */
+static glm::vec3 findOrthogonal(const glm::vec3 & n)
+{
+	glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1.f, 0.f, 0.f) : glm::vec3(0.f, 1.f, 0.f);
+	return glm::normalize(axis - n * glm::dot(n, axis));
+}
+
+/**
+ * @brief Approximates acos with a maximal error of about 7e-5 radians (Abramowitz and Stegun 4.4.45).
+ * Good enough for weights and much cheaper than std::acos.
+ */
+static float fastAcos(float x)
+{
+	x = std::max(-1.f, std::min(1.f, x));
+	const float a = std::abs(x);
+	const float result = std::sqrt(1.f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f - 0.0187293f * a)));
+	return x < 0.f ? 3.14159265f - result : result;
+}
+
+MeshAttributes mygl::generateAttributes(const std::vector<GLuint> & indices, const std::vector<glm::vec3> & positions,
+	const std::vector<glm::vec2> & uvs, const AttributeOptions & options, const std::vector<glm::vec3> * existing_normals)
+{
+	MeshAttributes attributes;
+	const size_t vertex_count = positions.size();
+	const size_t triangle_count = indices.size() / 3;
+	const bool generate_tangents = options.tangents && uvs.size() == vertex_count;
+	attributes.bounds = calculateBounds(positions);
+	if (!options.normals && !generate_tangents) return attributes;
+
+	// 1. face pass: one weighted normal per corner and one tangent frame per triangle
+	std::vector<glm::vec3> corner_normals(options.normals ? triangle_count * 3 : 0);
+	std::vector<glm::vec3> face_tangents(generate_tangents ? triangle_count : 0);
+	std::vector<glm::vec3> face_bitangents(generate_tangents ? triangle_count : 0);
+	std::vector<unsigned char> face_valid(triangle_count, 0);
+	parallelFor(0, triangle_count, [&](size_t begin, size_t end) {
+		for (size_t t = begin; t < end; t++) {
+			const GLuint i0 = indices[t * 3 + 0], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+			// skips restart indices and other invalid references
+			if (i0 >= vertex_count || i1 >= vertex_count || i2 >= vertex_count) continue;
+			face_valid[t] = 1;
+
+			const glm::vec3 & p0 = positions[i0];
+			const glm::vec3 & p1 = positions[i1];
+			const glm::vec3 & p2 = positions[i2];
+			const glm::vec3 e1 = p1 - p0;
+			const glm::vec3 e2 = p2 - p0;
+			// the length of the cross product is twice the area, which makes it the area weight
+			const glm::vec3 area_normal = glm::cross(e1, e2);
+
+			if (options.normals) {
+				if (options.angle_weighted) {
+					// the normalized edges are shared by the corners
+					const glm::vec3 e3 = p2 - p1;
+					const float l1 = glm::length(e1), l2 = glm::length(e2), l3 = glm::length(e3);
+					if (l1 > 0.f && l2 > 0.f && l3 > 0.f) {
+						const glm::vec3 n1 = e1 / l1, n2 = e2 / l2, n3 = e3 / l3;
+						corner_normals[t * 3 + 0] = area_normal * fastAcos(glm::dot(n1, n2));
+						corner_normals[t * 3 + 1] = area_normal * fastAcos(-glm::dot(n1, n3));
+						corner_normals[t * 3 + 2] = area_normal * fastAcos(glm::dot(n2, n3));
+					}
+				}
+				else {
+					corner_normals[t * 3 + 0] = corner_normals[t * 3 + 1] = corner_normals[t * 3 + 2] = area_normal;
+				}
+			}
+
+			if (generate_tangents) {
+				const glm::vec2 d1 = uvs[i1] - uvs[i0];
+				const glm::vec2 d2 = uvs[i2] - uvs[i0];
+				const float determinant = d1.x * d2.y - d2.x * d1.y;
+				if (std::abs(determinant) <= std::numeric_limits<float>::epsilon()) continue;
+				// without the division by the determinant the directions are weighted by the size of the triangle
+				const float orientation = determinant < 0.f ? -1.f : 1.f;
+				face_tangents[t] = (e1 * d2.y - e2 * d1.y) * orientation;
+				face_bitangents[t] = (e2 * d1.x - e1 * d2.x) * orientation;
+			}
+		}
+	});
+
+	// 2. adjacency from vertices to corners, so that the vertex pass can gather without synchronization
+	std::vector<GLuint> corner_offsets(vertex_count + 1, 0);
+	for (size_t t = 0; t < triangle_count; t++) {
+		if (!face_valid[t]) continue;
+		for (int c = 0; c < 3; c++) corner_offsets[indices[t * 3 + c] + 1]++;
+	}
+	for (size_t v = 0; v < vertex_count; v++) corner_offsets[v + 1] += corner_offsets[v];
+	std::vector<GLuint> corners(corner_offsets[vertex_count]);
+	{
+		std::vector<GLuint> fill(corner_offsets.begin(), corner_offsets.end() - 1);
+		for (size_t t = 0; t < triangle_count; t++) {
+			if (!face_valid[t]) continue;
+			for (int c = 0; c < 3; c++) corners[fill[indices[t * 3 + c]]++] = static_cast<GLuint>(t * 3 + c);
+		}
+	}
+
+	// 3. vertex pass
+	if (options.normals) attributes.normals.assign(vertex_count, glm::vec3(0.f, 0.f, 1.f));
+	if (generate_tangents) attributes.tangents.assign(vertex_count, glm::vec4(1.f, 0.f, 0.f, 1.f));
+	parallelFor(0, vertex_count, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; v++) {
+			glm::vec3 normal(0.f);
+			if (options.normals) {
+				for (GLuint k = corner_offsets[v]; k < corner_offsets[v + 1]; k++) normal += corner_normals[corners[k]];
+				const float length = glm::length(normal);
+				normal = length > 0.f ? normal / length : glm::vec3(0.f, 0.f, 1.f);
+				attributes.normals[v] = normal;
+			}
+			else if (existing_normals && existing_normals->size() == vertex_count) {
+				normal = (*existing_normals)[v];
+				const float length = glm::length(normal);
+				normal = length > 0.f ? normal / length : glm::vec3(0.f, 0.f, 1.f);
+			}
+			else {
+				normal = glm::vec3(0.f, 0.f, 1.f);
+			}
+
+			if (!generate_tangents) continue;
+			glm::vec3 tangent(0.f), bitangent(0.f);
+			for (GLuint k = corner_offsets[v]; k < corner_offsets[v + 1]; k++) {
+				tangent += face_tangents[corners[k] / 3];
+				bitangent += face_bitangents[corners[k] / 3];
+			}
+			// Gram-Schmidt against the normal
+			tangent -= normal * glm::dot(normal, tangent);
+			const float length = glm::length(tangent);
+			tangent = length > 1e-12f ? tangent / length : findOrthogonal(normal);
+			const float handedness = glm::dot(glm::cross(normal, tangent), bitangent) < 0.f ? -1.f : 1.f;
+			attributes.tangents[v] = glm::vec4(tangent, handedness);
+		}
+	});
+	return attributes;
+}
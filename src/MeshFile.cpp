@@ -0,0 +1,370 @@
+#include <fstream>
+#include <iostream>
+#include <mygl/MeshFile.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace mygl;
+
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
+}
+
+// === writer ===
+
+void mygl::writeMeshFile(const std::string & path, const MeshFileSource & source)
+{
+	MeshFileHeader header;
+	header.vertex_stride = static_cast<uint32_t>(source.vertex_stride);
+	header.vertex_count = source.vertex_count;
+	header.geometry_type = source.geometry_type;
+	header.attribute_count = static_cast<uint32_t>(source.layout.size());
+	header.flags = source.primitive_restart ? MeshFileHeader::FLAG_PRIMITIVE_RESTART : 0;
+	for (int i = 0; i < 3; i++) {
+		header.bounds_min[i] = source.bounds.min[i];
+		header.bounds_max[i] = source.bounds.max[i];
+		header.bounds_center[i] = source.bounds.center[i];
+	}
+	header.bounds_radius = source.bounds.radius;
+
+	std::vector<MeshFileAttribute> attributes(source.layout.size());
+	for (size_t a = 0; a < source.layout.size(); a++) {
+		attributes[a].location = source.layout[a].location;
+		attributes[a].component_count = static_cast<uint32_t>(source.layout[a].component_count);
+		attributes[a].component_type = source.layout[a].component_type;
+		attributes[a].normalized = source.layout[a].normalized;
+		attributes[a].offset = source.layout[a].offset;
+	}
+
+	// the full mesh is the first level of detail, all levels share one index section
+	std::vector<MeshFileLod> lods;
+	std::vector<const std::vector<GLuint>*> lod_indices;
+	if (source.indices) {
+		lods.push_back({ 0, source.indices->size(), 0.f, 0 });
+		lod_indices.push_back(source.indices);
+		if (source.lods) {
+			for (const MeshFileLodData & lod : *source.lods) {
+				lods.push_back({ lods.back().index_offset + lods.back().index_count, lod.indices.size(), lod.error, 0 });
+				lod_indices.push_back(&lod.indices);
+			}
+		}
+		header.index_count = lods.back().index_offset + lods.back().index_count;
+		header.index_type = chooseIndexType(source.vertex_count);
+		header.lod_count = static_cast<uint32_t>(lods.size());
+	}
+
+	std::vector<MeshFileMeshlet> meshlets;
+	if (source.meshlets) {
+		meshlets.resize(source.meshlets->meshlets.size());
+		for (size_t m = 0; m < meshlets.size(); m++) {
+			const Meshlet & meshlet = source.meshlets->meshlets[m];
+			meshlets[m].vertex_offset = static_cast<uint32_t>(meshlet.vertex_offset);
+			meshlets[m].vertex_count = meshlet.vertex_count;
+			meshlets[m].triangle_offset = static_cast<uint32_t>(meshlet.triangle_offset);
+			meshlets[m].triangle_count = meshlet.triangle_count;
+			for (int i = 0; i < 3; i++) {
+				meshlets[m].center[i] = meshlet.center[i];
+				meshlets[m].cone_axis[i] = meshlet.cone_axis[i];
+			}
+			meshlets[m].radius = meshlet.radius;
+			meshlets[m].cone_cutoff = meshlet.cone_cutoff;
+		}
+		header.meshlet_count = static_cast<uint32_t>(meshlets.size());
+	}
+
+	// section table
+	uint64_t offset = alignOffset(sizeof(MeshFileHeader));
+	auto place = [&offset](MeshFileSection & section, uint64_t size) {
+		section.offset = size > 0 ? offset : 0;
+		section.size = size;
+		offset = alignOffset(offset + size);
+	};
+	place(header.attributes, sizeof(MeshFileAttribute) * attributes.size());
+	place(header.vertices, static_cast<uint64_t>(source.vertex_stride) * source.vertex_count);
+	place(header.indices, header.index_type == 0 ? 0 : getIndexSize(header.index_type) * header.index_count);
+	place(header.lods, sizeof(MeshFileLod) * lods.size());
+	place(header.meshlets, sizeof(MeshFileMeshlet) * meshlets.size());
+	place(header.meshlet_vertices, source.meshlets ? sizeof(GLuint) * source.meshlets->vertices.size() : 0);
+	place(header.meshlet_triangles, source.meshlets ? source.meshlets->triangles.size() : 0);
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cerr << "ERROR::cannot write mesh file " << path << std::endl;
+		throw std::runtime_error("cannot write mesh file " + path);
+	}
+
+	uint64_t written = 0;
+	auto writeSection = [&file, &written](const MeshFileSection & section, const void * data) {
+		if (section.size == 0) return;
+		static const char padding[MESH_FILE_ALIGNMENT] = {};
+		file.write(padding, static_cast<std::streamsize>(section.offset - written));
+		file.write(static_cast<const char*>(data), static_cast<std::streamsize>(section.size));
+		written = section.offset + section.size;
+	};
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(MeshFileHeader));
+	written = sizeof(MeshFileHeader);
+	writeSection(header.attributes, attributes.data());
+	writeSection(header.vertices, source.vertices);
+
+	if (header.index_type == GL_UNSIGNED_SHORT) {
+		std::vector<GLushort> packed;
+		packed.reserve(header.index_count);
+		for (const std::vector<GLuint> * indices : lod_indices) {
+			std::vector<GLushort> lod_packed = packIndices16(*indices);
+			packed.insert(packed.end(), lod_packed.begin(), lod_packed.end());
+		}
+		writeSection(header.indices, packed.data());
+	}
+	else if (header.index_type == GL_UNSIGNED_INT) {
+		// the levels are already contiguous in the file, so they are written one after another without a copy
+		MeshFileSection section = header.indices;
+		for (const std::vector<GLuint> * indices : lod_indices) {
+			section.size = sizeof(GLuint) * indices->size();
+			writeSection(section, indices->data());
+			section.offset += section.size;
+		}
+	}
+
+	writeSection(header.lods, lods.data());
+	writeSection(header.meshlets, meshlets.data());
+	if (source.meshlets) {
+		writeSection(header.meshlet_vertices, source.meshlets->vertices.data());
+		writeSection(header.meshlet_triangles, source.meshlets->triangles.data());
+	}
+
+	if (!file)
+	{
+		std::cerr << "ERROR::cannot write mesh file " << path << std::endl;
+		throw std::runtime_error("cannot write mesh file " + path);
+	}
+}
+
+// === reader ===
+
+MeshFile::MeshFile(const std::string & path)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	LARGE_INTEGER file_size;
+	if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size))
+	{
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+		std::cerr << "ERROR::cannot open mesh file " << path << std::endl;
+		throw std::runtime_error("cannot open mesh file " + path);
+	}
+	this->file_handle = file;
+	this->size = static_cast<size_t>(file_size.QuadPart);
+	if (this->size > 0) {
+		this->mapping_handle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (this->mapping_handle) {
+			this->mapped = static_cast<const unsigned char *>(MapViewOfFile(this->mapping_handle, FILE_MAP_READ, 0, 0, 0));
+		}
+	}
+#else
+	this->file_descriptor = open(path.c_str(), O_RDONLY);
+	struct stat file_status;
+	if (this->file_descriptor < 0 || fstat(this->file_descriptor, &file_status) != 0)
+	{
+		unmap();
+		std::cerr << "ERROR::cannot open mesh file " << path << std::endl;
+		throw std::runtime_error("cannot open mesh file " + path);
+	}
+	this->size = static_cast<size_t>(file_status.st_size);
+	if (this->size > 0) {
+		void * address = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, this->file_descriptor, 0);
+		if (address != MAP_FAILED) {
+			this->mapped = static_cast<const unsigned char *>(address);
+			// the sections are read front to back when they are uploaded
+			madvise(address, this->size, MADV_SEQUENTIAL);
+		}
+	}
+#endif
+	if (!this->mapped)
+	{
+		unmap();
+		std::cerr << "ERROR::cannot map mesh file " << path << std::endl;
+		throw std::runtime_error("cannot map mesh file " + path);
+	}
+
+	try {
+		validate(path);
+	} catch (...) {
+		unmap();
+		throw;
+	}
+}
+
+MeshFile::~MeshFile()
+{
+	unmap();
+}
+
+void MeshFile::unmap()
+{
+#ifdef _WIN32
+	if (this->mapped) UnmapViewOfFile(this->mapped);
+	if (this->mapping_handle) CloseHandle(this->mapping_handle);
+	if (this->file_handle) CloseHandle(this->file_handle);
+	this->mapping_handle = nullptr;
+	this->file_handle = nullptr;
+#else
+	if (this->mapped) munmap(const_cast<unsigned char *>(this->mapped), this->size);
+	if (this->file_descriptor >= 0) close(this->file_descriptor);
+	this->file_descriptor = -1;
+#endif
+	this->mapped = nullptr;
+}
+
+void MeshFile::validate(const std::string & path) const
+{
+	auto fail = [&path](const std::string & reason) {
+		std::cerr << "ERROR::invalid mesh file " << path << ": " << reason << std::endl;
+		throw std::runtime_error("invalid mesh file " + path + ": " + reason);
+	};
+
+	if (this->size < sizeof(MeshFileHeader)) fail("too small");
+	const MeshFileHeader & header = getHeader();
+	if (std::memcmp(header.magic, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC)) != 0) fail("wrong magic");
+	if (header.version != MESH_FILE_VERSION) fail("unsupported version " + std::to_string(header.version));
+	if (header.header_size != sizeof(MeshFileHeader)) fail("unexpected header size");
+
+	const MeshFileSection * sections[] = { &header.attributes, &header.vertices, &header.indices, &header.lods,
+		&header.meshlets, &header.meshlet_vertices, &header.meshlet_triangles };
+	for (const MeshFileSection * section : sections) {
+		if (section->size == 0) continue;
+		if (section->offset % MESH_FILE_ALIGNMENT != 0) fail("unaligned section");
+		if (section->offset > this->size || section->size > this->size - section->offset) fail("truncated section");
+	}
+
+	if (header.attributes.size != sizeof(MeshFileAttribute) * header.attribute_count) fail("wrong attribute count");
+	if (header.vertices.size != static_cast<uint64_t>(header.vertex_stride) * header.vertex_count) fail("wrong vertex count");
+	if (header.index_type != 0 && header.index_type != GL_UNSIGNED_SHORT && header.index_type != GL_UNSIGNED_INT) fail("wrong index type");
+	if (header.index_type != 0 && header.indices.size != getIndexSize(header.index_type) * header.index_count) fail("wrong index count");
+	if (header.lods.size != sizeof(MeshFileLod) * header.lod_count) fail("wrong level of detail count");
+	if (header.meshlets.size != sizeof(MeshFileMeshlet) * header.meshlet_count) fail("wrong meshlet count");
+	for (uint32_t l = 0; l < header.lod_count; l++) {
+		const MeshFileLod & lod = getLods()[l];
+		if (lod.index_offset > header.index_count || lod.index_count > header.index_count - lod.index_offset) fail("level of detail out of range");
+	}
+	const MeshFileMeshlet * meshlets = reinterpret_cast<const MeshFileMeshlet *>(this->mapped + header.meshlets.offset);
+	for (uint32_t m = 0; m < header.meshlet_count; m++) {
+		if ((static_cast<uint64_t>(meshlets[m].vertex_offset) + meshlets[m].vertex_count) * sizeof(GLuint) > header.meshlet_vertices.size
+			|| static_cast<uint64_t>(meshlets[m].triangle_offset) + meshlets[m].triangle_count * 3ull > header.meshlet_triangles.size) fail("meshlet out of range");
+	}
+
+	// the indices are used to read the vertices on the CPU and on the GPU, so they have to stay in range
+	const bool primitive_restart = (header.flags & MeshFileHeader::FLAG_PRIMITIVE_RESTART) != 0;
+	if (header.index_type == GL_UNSIGNED_SHORT) {
+		const GLushort * indices = reinterpret_cast<const GLushort *>(this->mapped + header.indices.offset);
+		for (uint64_t i = 0; i < header.index_count; i++) {
+			if (indices[i] >= header.vertex_count && !(primitive_restart && indices[i] == 0xFFFF)) fail("index out of range");
+		}
+	}
+	else if (header.index_type == GL_UNSIGNED_INT) {
+		const GLuint * indices = reinterpret_cast<const GLuint *>(this->mapped + header.indices.offset);
+		for (uint64_t i = 0; i < header.index_count; i++) {
+			if (indices[i] >= header.vertex_count && !(primitive_restart && indices[i] == 0xFFFFFFFF)) fail("index out of range");
+		}
+	}
+	const GLuint * meshlet_vertices = reinterpret_cast<const GLuint *>(this->mapped + header.meshlet_vertices.offset);
+	for (uint64_t v = 0; v < header.meshlet_vertices.size / sizeof(GLuint); v++) {
+		if (meshlet_vertices[v] >= header.vertex_count) fail("meshlet vertex out of range");
+	}
+	const unsigned char * meshlet_triangles = this->mapped + header.meshlet_triangles.offset;
+	for (uint32_t m = 0; m < header.meshlet_count; m++) {
+		for (uint64_t t = 0; t < meshlets[m].triangle_count * 3ull; t++) {
+			if (meshlet_triangles[meshlets[m].triangle_offset + t] >= meshlets[m].vertex_count) fail("meshlet triangle out of range");
+		}
+	}
+}
+
+const MeshFileHeader & MeshFile::getHeader() const
+{
+	return *reinterpret_cast<const MeshFileHeader *>(this->mapped);
+}
+
+std::vector<VertexAttribute> MeshFile::getLayout() const
+{
+	const MeshFileHeader & header = getHeader();
+	const MeshFileAttribute * attributes = reinterpret_cast<const MeshFileAttribute *>(this->mapped + header.attributes.offset);
+	std::vector<VertexAttribute> layout(header.attribute_count);
+	for (uint32_t a = 0; a < header.attribute_count; a++) {
+		layout[a].location = attributes[a].location;
+		layout[a].component_count = static_cast<GLint>(attributes[a].component_count);
+		layout[a].component_type = attributes[a].component_type;
+		layout[a].normalized = static_cast<GLboolean>(attributes[a].normalized);
+		layout[a].offset = attributes[a].offset;
+	}
+	return layout;
+}
+
+const void * MeshFile::getVertices() const
+{
+	return this->mapped + getHeader().vertices.offset;
+}
+
+const void * MeshFile::getIndices() const
+{
+	const MeshFileHeader & header = getHeader();
+	return header.index_type == 0 ? nullptr : this->mapped + header.indices.offset;
+}
+
+const MeshFileLod * MeshFile::getLods() const
+{
+	return reinterpret_cast<const MeshFileLod *>(this->mapped + getHeader().lods.offset);
+}
+
+const MeshFileLod & MeshFile::getLod(unsigned int lod) const
+{
+	if (lod >= getHeader().lod_count) {
+		throw std::out_of_range("the mesh file has no level of detail " + std::to_string(lod));
+	}
+	return getLods()[lod];
+}
+
+Bounds MeshFile::getBounds() const
+{
+	const MeshFileHeader & header = getHeader();
+	Bounds bounds;
+	bounds.min = glm::vec3(header.bounds_min[0], header.bounds_min[1], header.bounds_min[2]);
+	bounds.max = glm::vec3(header.bounds_max[0], header.bounds_max[1], header.bounds_max[2]);
+	bounds.center = glm::vec3(header.bounds_center[0], header.bounds_center[1], header.bounds_center[2]);
+	bounds.radius = header.bounds_radius;
+	return bounds;
+}
+
+MeshletData MeshFile::getMeshlets() const
+{
+	const MeshFileHeader & header = getHeader();
+	MeshletData data;
+	const MeshFileMeshlet * meshlets = reinterpret_cast<const MeshFileMeshlet *>(this->mapped + header.meshlets.offset);
+	data.meshlets.resize(header.meshlet_count);
+	for (uint32_t m = 0; m < header.meshlet_count; m++) {
+		Meshlet & meshlet = data.meshlets[m];
+		meshlet.vertex_offset = meshlets[m].vertex_offset;
+		meshlet.vertex_count = meshlets[m].vertex_count;
+		meshlet.triangle_offset = meshlets[m].triangle_offset;
+		meshlet.triangle_count = meshlets[m].triangle_count;
+		meshlet.center = glm::vec3(meshlets[m].center[0], meshlets[m].center[1], meshlets[m].center[2]);
+		meshlet.radius = meshlets[m].radius;
+		meshlet.cone_axis = glm::vec3(meshlets[m].cone_axis[0], meshlets[m].cone_axis[1], meshlets[m].cone_axis[2]);
+		meshlet.cone_cutoff = meshlets[m].cone_cutoff;
+	}
+	const GLuint * vertices = reinterpret_cast<const GLuint *>(this->mapped + header.meshlet_vertices.offset);
+	data.vertices.assign(vertices, vertices + header.meshlet_vertices.size / sizeof(GLuint));
+	const unsigned char * triangles = this->mapped + header.meshlet_triangles.offset;
+	data.triangles.assign(triangles, triangles + header.meshlet_triangles.size);
+	return data;
+}
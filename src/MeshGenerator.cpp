@@ -0,0 +1,453 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <mygl/MeshGenerator.hpp>
+#include <mygl/Parallel.hpp>
+
+using namespace mygl;
+
+static const float PI = static_cast<float>(M_PI);
+static const float TWO_PI = static_cast<float>(2.0 * M_PI);
+
+/**
+ * @brief Returns the bounds of an axis aligned box with a sphere around it.
+ */
+static Bounds getBoxBounds(const glm::vec3 & min, const glm::vec3 & max)
+{
+	Bounds bounds;
+	bounds.min = min;
+	bounds.max = max;
+	bounds.center = (min + max) * 0.5f;
+	bounds.radius = glm::length(max - min) * 0.5f;
+	return bounds;
+}
+
+// === grid helpers ===
+
+/**
+ * @brief Returns how many rows of a grid are processed at least per thread, so that small grids stay on one thread.
+ */
+static inline size_t getRowsPerChunk(size_t columns)
+{
+	return std::max<size_t>(1, 4096 / std::max<size_t>(columns, 1));
+}
+
+/**
+ * @brief Writes the vertices of a grid with (rows + 1) x (columns + 1) vertices, row by row.
+ *
+ * @param vertex_at returns the vertex of a row and column
+ */
+template <typename F>
+static void writeGridVertices(VertexFormat * vertices, size_t rows, size_t columns, F vertex_at)
+{
+	const size_t row_vertices = columns + 1;
+	parallelFor(0, rows + 1, [&](size_t begin, size_t end) {
+		for (size_t r = begin; r < end; r++) {
+			for (size_t c = 0; c < row_vertices; c++) vertices[r * row_vertices + c] = vertex_at(r, c);
+		}
+	}, getRowsPerChunk(columns));
+}
+
+/**
+ * @brief Writes two triangles per cell of a grid that was written by writeGridVertices.
+ *
+ * The triangles are counter-clockwise if the cross product of the column and the row direction points to the front.
+ *
+ * @param base_vertex the index of the first vertex of the grid
+ * @param flip whether the winding is reversed
+ */
+template <typename I>
+static void writeGridIndices(I * indices, size_t rows, size_t columns, size_t base_vertex, bool flip = false)
+{
+	const size_t row_vertices = columns + 1;
+	parallelFor(0, rows, [&](size_t begin, size_t end) {
+		for (size_t r = begin; r < end; r++) {
+			I * target = indices + r * columns * 6;
+			for (size_t c = 0; c < columns; c++) {
+				const I start = static_cast<I>(base_vertex + row_vertices * r + c);
+				const I right = static_cast<I>(start + 1);
+				const I below = static_cast<I>(start + row_vertices);
+				const I below_right = static_cast<I>(below + 1);
+				target[0] = start;
+				target[1] = flip ? below : right;
+				target[2] = flip ? right : below;
+				target[3] = below;
+				target[4] = flip ? below_right : right;
+				target[5] = flip ? right : below_right;
+				target += 6;
+			}
+		}
+	}, getRowsPerChunk(columns));
+}
+
+static inline size_t getGridVertexCount(size_t rows, size_t columns)
+{
+	return (rows + 1) * (columns + 1);
+}
+
+static inline size_t getGridIndexCount(size_t rows, size_t columns)
+{
+	return rows * columns * 6;
+}
+
+// === MeshGenerator ===
+
+MeshGenerator::~MeshGenerator()
+{
+
+}
+
+void MeshGenerator::checkSpans(size_t vertex_count, size_t index_count) const
+{
+	const GeometryCounts counts = getCounts();
+	if (vertex_count != counts.vertex_count || index_count != counts.index_count) {
+		std::cerr << "ERROR::the memory for the generated mesh does not match its vertex and index counts" << std::endl;
+		throw std::runtime_error("the memory for the generated mesh does not match its vertex and index counts");
+	}
+}
+
+std::shared_ptr<MeshData<VertexFormat>> MeshGenerator::createMeshData() const
+{
+	const GeometryCounts counts = getCounts();
+	std::shared_ptr<MeshData<VertexFormat>> data(new MeshData<VertexFormat>());
+	data->vertices.resize(counts.vertex_count, VertexFormat(glm::vec3(0.f), glm::vec3(0.f), glm::vec2(0.f), glm::vec3(0.f)));
+	data->indices = std::vector<GLuint>(counts.index_count);
+	generate(std::span<VertexFormat>(data->vertices), std::span<GLuint>(data->indices.value()));
+	return data;
+}
+
+std::shared_ptr<SceneMesh<VertexFormat>> MeshGenerator::createSceneMesh(std::shared_ptr<Material> material) const
+{
+	const GeometryCounts counts = getCounts();
+	std::shared_ptr<SceneMesh<VertexFormat>> mesh(new SceneMesh<VertexFormat>(counts.vertex_count, counts.index_count, GL_TRIANGLES, material,
+		[this, counts](VertexFormat * vertices, void * indices, GLenum index_type) {
+			if (index_type == GL_UNSIGNED_SHORT) {
+				generate(std::span<VertexFormat>(vertices, counts.vertex_count), std::span<GLushort>(static_cast<GLushort*>(indices), counts.index_count));
+			}
+			else {
+				generate(std::span<VertexFormat>(vertices, counts.vertex_count), std::span<GLuint>(static_cast<GLuint*>(indices), counts.index_count));
+			}
+		}));
+	// the mesh has no CPU data to compute its bounds from
+	mesh->setBounds(getBounds());
+	return mesh;
+}
+
+// === PlaneMeshGenerator ===
+
+PlaneMeshGenerator::PlaneMeshGenerator(glm::vec3 center, glm::vec3 normal, glm::vec3 direction, float side_length, unsigned int tesselation, float uv_scaling)
+	: center(center), normal(normal), direction(direction), side_length(side_length), tesselation(tesselation), uv_scaling(uv_scaling)
+{
+
+}
+
+GeometryCounts PlaneMeshGenerator::getCounts() const
+{
+	const size_t steps = static_cast<size_t>(this->tesselation) + 1;
+	return { getGridVertexCount(steps, steps), getGridIndexCount(steps, steps) };
+}
+
+Bounds PlaneMeshGenerator::getBounds() const
+{
+	const glm::vec3 r = glm::normalize(glm::cross(this->normal, this->direction));
+	const glm::vec3 u = (this->side_length / 2) * this->direction, v = (this->side_length / 2) * r;
+	const glm::vec3 extent = glm::abs(u) + glm::abs(v);
+	return getBoxBounds(this->center - extent, this->center + extent);
+}
+
+template <typename I>
+void PlaneMeshGenerator::write(std::span<VertexFormat> vertices, std::span<I> indices) const
+{
+	checkSpans(vertices.size(), indices.size());
+	const size_t steps = static_cast<size_t>(this->tesselation) + 1;
+	const float step_size = this->side_length / steps;
+	const float step_size_uv = 1.f / static_cast<float>(steps);
+	const glm::vec3 r = glm::normalize(glm::cross(this->normal, this->direction));
+	const glm::vec3 next_row = r * step_size;
+	const glm::vec3 next_column = this->direction * step_size;
+	const glm::vec3 start = this->center - (this->side_length / 2) * (this->direction + r);
+
+	writeGridVertices(vertices.data(), steps, steps, [&](size_t s, size_t t) {
+		const float s_f = static_cast<float>(s);
+		const float t_f = static_cast<float>(t);
+		return VertexFormat(start + next_row * s_f + next_column * t_f, this->normal, glm::vec2(s_f, t_f) * step_size_uv * this->uv_scaling, r);
+	});
+	writeGridIndices(indices.data(), steps, steps, 0);
+}
+
+void PlaneMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const { write(vertices, indices); }
+void PlaneMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const { write(vertices, indices); }
+
+// === BoxMeshGenerator ===
+
+BoxMeshGenerator::BoxMeshGenerator(glm::vec3 center, glm::vec3 size, unsigned int tesselation)
+	: center(center), size(size), tesselation(tesselation)
+{
+
+}
+
+GeometryCounts BoxMeshGenerator::getCounts() const
+{
+	const size_t steps = static_cast<size_t>(this->tesselation) + 1;
+	return { 6 * getGridVertexCount(steps, steps), 6 * getGridIndexCount(steps, steps) };
+}
+
+Bounds BoxMeshGenerator::getBounds() const
+{
+	const glm::vec3 half = glm::abs(this->size) * 0.5f;
+	return getBoxBounds(this->center - half, this->center + half);
+}
+
+template <typename I>
+void BoxMeshGenerator::write(std::span<VertexFormat> vertices, std::span<I> indices) const
+{
+	checkSpans(vertices.size(), indices.size());
+	static const glm::vec3 normals[6] = { glm::vec3(1.f, 0.f, 0.f), glm::vec3(-1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f),
+		glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 0.f, 1.f), glm::vec3(0.f, 0.f, -1.f) };
+	static const glm::vec3 directions[6] = { glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, 0.f, 1.f),
+		glm::vec3(0.f, 0.f, 1.f), glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, 1.f, 0.f) };
+
+	const size_t steps = static_cast<size_t>(this->tesselation) + 1;
+	const size_t face_vertices = getGridVertexCount(steps, steps);
+	const size_t face_indices = getGridIndexCount(steps, steps);
+	const glm::vec3 half = this->size * 0.5f;
+	const float step_uv = 1.f / static_cast<float>(steps);
+
+	// every face is a plane grid: rows along r = normal x direction, columns along the direction
+	for (size_t f = 0; f < 6; f++) {
+		const glm::vec3 n = normals[f];
+		const glm::vec3 d = directions[f];
+		const glm::vec3 r = glm::cross(n, d);
+		const glm::vec3 face_center = this->center + n * glm::dot(glm::abs(n), half);
+		const glm::vec3 r_extent = r * glm::dot(glm::abs(r), half);
+		const glm::vec3 d_extent = d * glm::dot(glm::abs(d), half);
+		const glm::vec3 start = face_center - r_extent - d_extent;
+		writeGridVertices(vertices.data() + f * face_vertices, steps, steps, [&](size_t s, size_t t) {
+			const glm::vec2 uv = glm::vec2(static_cast<float>(s), static_cast<float>(t)) * step_uv;
+			return VertexFormat(start + 2.f * (r_extent * uv.x + d_extent * uv.y), n, uv, r);
+		});
+		writeGridIndices(indices.data() + f * face_indices, steps, steps, f * face_vertices);
+	}
+}
+
+void BoxMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const { write(vertices, indices); }
+void BoxMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const { write(vertices, indices); }
+
+// === SphereMeshGenerator ===
+
+SphereMeshGenerator::SphereMeshGenerator(glm::vec3 center, float radius, unsigned int segments, unsigned int rings)
+	: center(center), radius(radius), segments(std::max(segments, 3u)), rings(std::max(rings, 2u))
+{
+
+}
+
+GeometryCounts SphereMeshGenerator::getCounts() const
+{
+	return { getGridVertexCount(this->rings, this->segments), getGridIndexCount(this->rings, this->segments) };
+}
+
+Bounds SphereMeshGenerator::getBounds() const
+{
+	Bounds bounds = getBoxBounds(this->center - glm::vec3(this->radius), this->center + glm::vec3(this->radius));
+	bounds.radius = this->radius;
+	return bounds;
+}
+
+template <typename I>
+void SphereMeshGenerator::write(std::span<VertexFormat> vertices, std::span<I> indices) const
+{
+	checkSpans(vertices.size(), indices.size());
+
+	// rows go from the north to the south pole, columns around the y-axis; the poles keep degenerate triangles,
+	// so that every row has the same layout
+	writeGridVertices(vertices.data(), this->rings, this->segments, [&](size_t r, size_t c) {
+		const float u = static_cast<float>(c) / this->segments;
+		const float v = static_cast<float>(r) / this->rings;
+		const float phi = u * TWO_PI;
+		const float theta = v * PI;
+		// exact poles, so that their degenerate triangles have no area
+		const float sin_theta = r == 0 || r == this->rings ? 0.f : std::sin(theta);
+		const glm::vec3 normal(sin_theta * std::cos(phi), std::cos(theta), sin_theta * std::sin(phi));
+		const glm::vec3 tangent(-std::sin(phi), 0.f, std::cos(phi));
+		return VertexFormat(this->center + this->radius * normal, normal, glm::vec2(u, 1.f - v), tangent);
+	});
+	writeGridIndices(indices.data(), this->rings, this->segments, 0);
+}
+
+void SphereMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const { write(vertices, indices); }
+void SphereMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const { write(vertices, indices); }
+
+// === CylinderMeshGenerator ===
+
+CylinderMeshGenerator::CylinderMeshGenerator(glm::vec3 center, float radius, float height, unsigned int segments, unsigned int height_segments, bool caps)
+	: center(center), radius(radius), height(height), segments(std::max(segments, 3u)), height_segments(std::max(height_segments, 1u)), caps(caps)
+{
+
+}
+
+GeometryCounts CylinderMeshGenerator::getCounts() const
+{
+	GeometryCounts counts = { getGridVertexCount(this->height_segments, this->segments), getGridIndexCount(this->height_segments, this->segments) };
+	if (this->caps) {
+		// a center and a ring of vertices per cap, one triangle per segment
+		counts.vertex_count += 2 * (static_cast<size_t>(this->segments) + 1);
+		counts.index_count += 2 * static_cast<size_t>(this->segments) * 3;
+	}
+	return counts;
+}
+
+Bounds CylinderMeshGenerator::getBounds() const
+{
+	const glm::vec3 half(this->radius, this->height * 0.5f, this->radius);
+	Bounds bounds = getBoxBounds(this->center - half, this->center + half);
+	bounds.radius = std::sqrt(half.x * half.x + half.y * half.y);
+	return bounds;
+}
+
+template <typename I>
+void CylinderMeshGenerator::write(std::span<VertexFormat> vertices, std::span<I> indices) const
+{
+	checkSpans(vertices.size(), indices.size());
+	const float half_height = this->height * 0.5f;
+
+	// the side: rows from the top to the bottom, columns around the y-axis
+	writeGridVertices(vertices.data(), this->height_segments, this->segments, [&](size_t r, size_t c) {
+		const float u = static_cast<float>(c) / this->segments;
+		const float v = static_cast<float>(r) / this->height_segments;
+		const float phi = u * TWO_PI;
+		const glm::vec3 normal(std::cos(phi), 0.f, std::sin(phi));
+		const glm::vec3 position = this->center + glm::vec3(this->radius * normal.x, half_height - v * this->height, this->radius * normal.z);
+		return VertexFormat(position, normal, glm::vec2(u, 1.f - v), glm::vec3(-normal.z, 0.f, normal.x));
+	});
+	writeGridIndices(indices.data(), this->height_segments, this->segments, 0);
+	if (!this->caps) return;
+
+	const size_t side_vertices = getGridVertexCount(this->height_segments, this->segments);
+	const size_t side_indices = getGridIndexCount(this->height_segments, this->segments);
+	for (size_t cap = 0; cap < 2; cap++) {
+		const float sign = cap == 0 ? 1.f : -1.f;
+		const glm::vec3 normal(0.f, sign, 0.f);
+		const size_t first = side_vertices + cap * (static_cast<size_t>(this->segments) + 1);
+		VertexFormat * cap_vertices = vertices.data() + first;
+		I * cap_indices = indices.data() + side_indices + cap * static_cast<size_t>(this->segments) * 3;
+
+		cap_vertices[0] = VertexFormat(this->center + normal * half_height, normal, glm::vec2(0.5f), glm::vec3(1.f, 0.f, 0.f));
+		parallelFor(0, this->segments, [&](size_t begin, size_t end) {
+			for (size_t s = begin; s < end; s++) {
+				const float phi = TWO_PI * static_cast<float>(s) / this->segments;
+				const glm::vec3 direction(std::cos(phi), 0.f, std::sin(phi));
+				cap_vertices[1 + s] = VertexFormat(this->center + normal * half_height + this->radius * direction, normal,
+					glm::vec2(0.5f) + 0.5f * glm::vec2(direction.x, sign * direction.z), glm::vec3(1.f, 0.f, 0.f));
+
+				// counter-clockwise when seen from outside of the cap
+				const I center_index = static_cast<I>(first);
+				const I current = static_cast<I>(first + 1 + s);
+				const I next = static_cast<I>(first + 1 + (s + 1) % this->segments);
+				cap_indices[s * 3] = center_index;
+				cap_indices[s * 3 + 1] = cap == 0 ? next : current;
+				cap_indices[s * 3 + 2] = cap == 0 ? current : next;
+			}
+		}, 4096);
+	}
+}
+
+void CylinderMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const { write(vertices, indices); }
+void CylinderMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const { write(vertices, indices); }
+
+// === TorusMeshGenerator ===
+
+TorusMeshGenerator::TorusMeshGenerator(glm::vec3 center, float major_radius, float minor_radius, unsigned int major_segments, unsigned int minor_segments)
+	: center(center), major_radius(major_radius), minor_radius(minor_radius), major_segments(std::max(major_segments, 3u)), minor_segments(std::max(minor_segments, 3u))
+{
+
+}
+
+GeometryCounts TorusMeshGenerator::getCounts() const
+{
+	return { getGridVertexCount(this->minor_segments, this->major_segments), getGridIndexCount(this->minor_segments, this->major_segments) };
+}
+
+Bounds TorusMeshGenerator::getBounds() const
+{
+	const float outer = this->major_radius + this->minor_radius;
+	Bounds bounds = getBoxBounds(this->center - glm::vec3(outer, this->minor_radius, outer), this->center + glm::vec3(outer, this->minor_radius, outer));
+	bounds.radius = outer;
+	return bounds;
+}
+
+template <typename I>
+void TorusMeshGenerator::write(std::span<VertexFormat> vertices, std::span<I> indices) const
+{
+	checkSpans(vertices.size(), indices.size());
+
+	// rows around the tube (walked clockwise, so that the grid faces outwards), columns around the y-axis
+	writeGridVertices(vertices.data(), this->minor_segments, this->major_segments, [&](size_t r, size_t c) {
+		const float u = static_cast<float>(c) / this->major_segments;
+		const float v = static_cast<float>(r) / this->minor_segments;
+		const float phi = u * TWO_PI;
+		const float theta = -v * TWO_PI;
+		const glm::vec3 ring(std::cos(phi), 0.f, std::sin(phi));
+		const glm::vec3 normal = std::cos(theta) * ring + glm::vec3(0.f, std::sin(theta), 0.f);
+		const glm::vec3 position = this->center + this->major_radius * ring + this->minor_radius * normal;
+		return VertexFormat(position, normal, glm::vec2(u, v), glm::vec3(-ring.z, 0.f, ring.x));
+	});
+	writeGridIndices(indices.data(), this->minor_segments, this->major_segments, 0);
+}
+
+void TorusMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const { write(vertices, indices); }
+void TorusMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const { write(vertices, indices); }
+
+// === HeightfieldMeshGenerator ===
+
+HeightfieldMeshGenerator::HeightfieldMeshGenerator(std::span<const float> heights, size_t columns, size_t rows, glm::vec3 origin,
+	glm::vec2 spacing, float height_scale)
+	: heights(heights), columns(columns), rows(rows), origin(origin), spacing(spacing), height_scale(height_scale)
+{
+	if (columns < 2 || rows < 2 || heights.size() < columns * rows) {
+		std::cerr << "ERROR::a heightfield needs at least 2 x 2 samples and columns * rows heights" << std::endl;
+		throw std::runtime_error("a heightfield needs at least 2 x 2 samples and columns * rows heights");
+	}
+}
+
+GeometryCounts HeightfieldMeshGenerator::getCounts() const
+{
+	return { getGridVertexCount(this->rows - 1, this->columns - 1), getGridIndexCount(this->rows - 1, this->columns - 1) };
+}
+
+Bounds HeightfieldMeshGenerator::getBounds() const
+{
+	const auto range = std::minmax_element(this->heights.begin(), this->heights.begin() + this->rows * this->columns);
+	const float lowest = std::min(*range.first * this->height_scale, *range.second * this->height_scale);
+	const float highest = std::max(*range.first * this->height_scale, *range.second * this->height_scale);
+	const glm::vec3 corner = this->origin + glm::vec3(this->spacing.x * (this->columns - 1), 0.f, this->spacing.y * (this->rows - 1));
+	return getBoxBounds(glm::min(this->origin, corner) + glm::vec3(0.f, lowest, 0.f), glm::max(this->origin, corner) + glm::vec3(0.f, highest, 0.f));
+}
+
+template <typename I>
+void HeightfieldMeshGenerator::write(std::span<VertexFormat> vertices, std::span<I> indices) const
+{
+	checkSpans(vertices.size(), indices.size());
+	const float * samples = this->heights.data();
+	const size_t columns = this->columns;
+	const size_t rows = this->rows;
+	auto height = [&](size_t r, size_t c) { return samples[r * columns + c] * this->height_scale; };
+
+	writeGridVertices(vertices.data(), rows - 1, columns - 1, [&](size_t r, size_t c) {
+		// central differences, one-sided at the borders
+		const size_t c0 = c > 0 ? c - 1 : c, c1 = c + 1 < columns ? c + 1 : c;
+		const size_t r0 = r > 0 ? r - 1 : r, r1 = r + 1 < rows ? r + 1 : r;
+		const float slope_x = (height(r, c1) - height(r, c0)) / (this->spacing.x * static_cast<float>(c1 - c0));
+		const float slope_z = (height(r1, c) - height(r0, c)) / (this->spacing.y * static_cast<float>(r1 - r0));
+		const glm::vec3 position = this->origin + glm::vec3(this->spacing.x * c, height(r, c), this->spacing.y * r);
+		const glm::vec3 normal = glm::normalize(glm::vec3(-slope_x, 1.f, -slope_z));
+		const glm::vec3 tangent = glm::normalize(glm::vec3(1.f, slope_x, 0.f));
+		const glm::vec2 uv(static_cast<float>(c) / (columns - 1), static_cast<float>(r) / (rows - 1));
+		return VertexFormat(position, normal, uv, tangent);
+	});
+	// columns along +x and rows along +z face downwards, so the winding is reversed
+	writeGridIndices(indices.data(), rows - 1, columns - 1, 0, true);
+}
+
+void HeightfieldMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLuint> indices) const { write(vertices, indices); }
+void HeightfieldMeshGenerator::generate(std::span<VertexFormat> vertices, std::span<GLushort> indices) const { write(vertices, indices); }
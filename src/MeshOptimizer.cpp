@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <mygl/MeshOptimizer.hpp>
+
+using namespace mygl;
+
+// === vertex cache optimization (Forsyth) ===
+
+static const int FORSYTH_CACHE_SIZE = 32;
+static const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+static const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+static const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+static const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+static float calculateForsythVertexScore(int cache_position, unsigned int live_triangles)
+{
+	if (live_triangles == 0) return -1.f;
+
+	float score = 0.f;
+	if (cache_position >= 0) {
+		if (cache_position < 3) {
+			// the vertices of the last triangle get a fixed score to avoid using them again right away
+			score = FORSYTH_LAST_TRIANGLE_SCORE;
+		} else {
+			const float scaler = 1.f / (FORSYTH_CACHE_SIZE - 3);
+			score = std::pow(1.f - (cache_position - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+		}
+	}
+	// boost vertices with few remaining triangles to finish them off
+	score += FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(live_triangles), -FORSYTH_VALENCE_BOOST_POWER);
+	return score;
+}
+
+VertexCacheStatistics mygl::analyzeVertexCache(const std::vector<GLuint> & indices, size_t vertex_count, unsigned int cache_size)
+{
+	VertexCacheStatistics statistics;
+	if (indices.empty() || vertex_count == 0) return statistics;
+
+	// a FIFO cache can be simulated with a timestamp per vertex:
+	// a vertex is inside of the cache, if less than cache_size vertices were added after it
+	std::vector<size_t> timestamps(vertex_count, 0);
+	size_t timestamp = cache_size + 1;
+	for (GLuint index : indices) {
+		if (timestamp - timestamps[index] > cache_size) {
+			timestamps[index] = timestamp++;
+			statistics.vertices_transformed++;
+		}
+	}
+
+	size_t triangle_count = indices.size() / 3;
+	statistics.acmr = triangle_count == 0 ? 0.f : static_cast<float>(statistics.vertices_transformed) / triangle_count;
+	statistics.atvr = static_cast<float>(statistics.vertices_transformed) / vertex_count;
+	return statistics;
+}
+
+void mygl::optimizeVertexCache(std::vector<GLuint> & indices, size_t vertex_count)
+{
+	const size_t triangle_count = indices.size() / 3;
+	if (triangle_count == 0 || vertex_count == 0) return;
+
+	// adjacency: which triangles use a vertex
+	std::vector<unsigned int> live_triangles(vertex_count, 0);
+	for (GLuint index : indices) live_triangles[index]++;
+
+	std::vector<size_t> adjacency_offsets(vertex_count + 1, 0);
+	for (size_t v = 0; v < vertex_count; v++) adjacency_offsets[v + 1] = adjacency_offsets[v] + live_triangles[v];
+
+	std::vector<unsigned int> adjacency(indices.size());
+	std::vector<size_t> adjacency_fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+	for (size_t t = 0; t < triangle_count; t++) {
+		for (size_t k = 0; k < 3; k++) {
+			GLuint v = indices[t * 3 + k];
+			adjacency[adjacency_fill[v]++] = static_cast<unsigned int>(t);
+		}
+	}
+
+	std::vector<int> cache_positions(vertex_count, -1);
+	std::vector<float> vertex_scores(vertex_count);
+	for (size_t v = 0; v < vertex_count; v++) {
+		vertex_scores[v] = calculateForsythVertexScore(-1, live_triangles[v]);
+	}
+
+	std::vector<bool> emitted(triangle_count, false);
+	std::vector<GLuint> result;
+	result.reserve(indices.size());
+
+	std::vector<GLuint> cache, next_cache;
+	cache.reserve(FORSYTH_CACHE_SIZE + 3);
+	next_cache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+	size_t input_cursor = 0;
+	long long best_triangle = -1;
+
+	for (size_t emitted_count = 0; emitted_count < triangle_count; emitted_count++) {
+		if (best_triangle < 0) {
+			// no candidate in the cache, continue with the next triangle in input order
+			while (emitted[input_cursor]) input_cursor++;
+			best_triangle = static_cast<long long>(input_cursor);
+		}
+
+		const size_t t = static_cast<size_t>(best_triangle);
+		const GLuint triangle[3] = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+		result.insert(result.end(), triangle, triangle + 3);
+		emitted[t] = true;
+
+		// remove the triangle from the adjacency of its vertices
+		for (GLuint v : triangle) {
+			unsigned int * begin = &adjacency[adjacency_offsets[v]];
+			unsigned int * end = begin + live_triangles[v];
+			unsigned int * it = std::find(begin, end, static_cast<unsigned int>(t));
+			std::swap(*it, *(end - 1));
+			live_triangles[v]--;
+		}
+
+		// the vertices of the emitted triangle move to the front of the cache
+		next_cache.assign(triangle, triangle + 3);
+		for (GLuint v : cache) {
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2]) next_cache.push_back(v);
+		}
+
+		// update the scores of every vertex that is or was inside of the cache
+		for (size_t i = 0; i < next_cache.size(); i++) {
+			GLuint v = next_cache[i];
+			cache_positions[v] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+			vertex_scores[v] = calculateForsythVertexScore(cache_positions[v], live_triangles[v]);
+		}
+		if (next_cache.size() > FORSYTH_CACHE_SIZE) next_cache.resize(FORSYTH_CACHE_SIZE);
+		std::swap(cache, next_cache);
+
+		// find the best triangle that uses a cached vertex
+		best_triangle = -1;
+		float best_score = -1.f;
+		for (GLuint v : cache) {
+			const unsigned int * begin = &adjacency[adjacency_offsets[v]];
+			for (unsigned int i = 0; i < live_triangles[v]; i++) {
+				unsigned int candidate = begin[i];
+				float score = vertex_scores[indices[candidate * 3]] + vertex_scores[indices[candidate * 3 + 1]] + vertex_scores[indices[candidate * 3 + 2]];
+				if (score > best_score) {
+					best_score = score;
+					best_triangle = candidate;
+				}
+			}
+		}
+	}
+
+	indices = std::move(result);
+}
+
+// === overdraw optimization (Sander et al.) ===
+
+void mygl::optimizeOverdraw(std::vector<GLuint> & indices, const std::vector<glm::vec3> & positions, float threshold)
+{
+	const size_t triangle_count = indices.size() / 3;
+	if (triangle_count == 0 || positions.empty()) return;
+
+	const unsigned int cache_size = 16;
+	std::vector<size_t> timestamps(positions.size(), 0);
+	size_t timestamp = cache_size + 1;
+
+	auto simulateTriangle = [&](size_t t) -> unsigned int {
+		unsigned int misses = 0;
+		for (size_t k = 0; k < 3; k++) {
+			GLuint v = indices[t * 3 + k];
+			if (timestamp - timestamps[v] > cache_size) {
+				timestamps[v] = timestamp++;
+				misses++;
+			}
+		}
+		return misses;
+	};
+
+	// hard boundaries: triangles where the cache effectively restarts (all vertices miss)
+	std::vector<size_t> hard_boundaries;
+	std::vector<unsigned int> triangle_misses(triangle_count);
+	for (size_t t = 0; t < triangle_count; t++) {
+		triangle_misses[t] = simulateTriangle(t);
+		if (t == 0 || triangle_misses[t] == 3) hard_boundaries.push_back(t);
+	}
+	hard_boundaries.push_back(triangle_count);
+
+	// soft boundaries: split hard clusters wherever the running ACMR is still within the threshold
+	std::vector<size_t> clusters;
+	for (size_t h = 0; h + 1 < hard_boundaries.size(); h++) {
+		const size_t start = hard_boundaries[h];
+		const size_t end = hard_boundaries[h + 1];
+
+		unsigned int cluster_misses = 0;
+		for (size_t t = start; t < end; t++) cluster_misses += triangle_misses[t];
+		const float cluster_threshold = threshold * static_cast<float>(cluster_misses) / (end - start);
+
+		clusters.push_back(start);
+		timestamp += cache_size + 1; // flush the cache
+		unsigned int running_misses = 0;
+		size_t running_start = start;
+		for (size_t t = start; t < end; t++) {
+			running_misses += simulateTriangle(t);
+			if (t + 1 < end && static_cast<float>(running_misses) / (t + 1 - running_start) <= cluster_threshold) {
+				clusters.push_back(t + 1);
+				timestamp += cache_size + 1;
+				running_misses = 0;
+				running_start = t + 1;
+			}
+		}
+	}
+	clusters.push_back(triangle_count);
+
+	// sort clusters by how much they face away from the center of the mesh
+	glm::vec3 mesh_centroid(0.f);
+	float mesh_area = 0.f;
+	std::vector<glm::vec3> cluster_centroids(clusters.size() - 1, glm::vec3(0.f));
+	std::vector<glm::vec3> cluster_normals(clusters.size() - 1, glm::vec3(0.f));
+	for (size_t c = 0; c + 1 < clusters.size(); c++) {
+		float cluster_area = 0.f;
+		for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+			const glm::vec3 & p0 = positions[indices[t * 3]];
+			const glm::vec3 & p1 = positions[indices[t * 3 + 1]];
+			const glm::vec3 & p2 = positions[indices[t * 3 + 2]];
+			glm::vec3 n = glm::cross(p1 - p0, p2 - p0); // length is twice the area
+			float area = glm::length(n);
+			glm::vec3 centroid = (p0 + p1 + p2) / 3.f;
+
+			cluster_centroids[c] += centroid * area;
+			cluster_normals[c] += n;
+			cluster_area += area;
+		}
+		mesh_centroid += cluster_centroids[c];
+		mesh_area += cluster_area;
+		cluster_centroids[c] = cluster_area > 0.f ? cluster_centroids[c] / cluster_area : positions[indices[clusters[c] * 3]];
+		float normal_length = glm::length(cluster_normals[c]);
+		if (normal_length > 0.f) cluster_normals[c] /= normal_length;
+	}
+	if (mesh_area > 0.f) mesh_centroid /= mesh_area;
+
+	std::vector<float> sort_keys(clusters.size() - 1);
+	for (size_t c = 0; c < sort_keys.size(); c++) {
+		sort_keys[c] = glm::dot(cluster_centroids[c] - mesh_centroid, cluster_normals[c]);
+	}
+
+	std::vector<size_t> order(sort_keys.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&sort_keys](size_t a, size_t b) { return sort_keys[a] > sort_keys[b]; });
+
+	std::vector<GLuint> result;
+	result.reserve(indices.size());
+	for (size_t c : order) {
+		result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+	}
+	indices = std::move(result);
+}
+
+// === vertex fetch optimization ===
+
+std::vector<GLuint> mygl::optimizeVertexFetchRemap(std::vector<GLuint> & indices, size_t vertex_count)
+{
+	std::vector<GLuint> remap(vertex_count, ~0u);
+	GLuint next_vertex = 0;
+	for (GLuint & index : indices) {
+		if (remap[index] == ~0u) remap[index] = next_vertex++;
+		index = remap[index];
+	}
+	return remap;
+}
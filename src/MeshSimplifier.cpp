@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <queue>
+#include <unordered_map>
+#include <mygl/MeshSimplifier.hpp>
+
+using namespace mygl;
+
+namespace {
+
+/**
+ * A symmetric 4x4 error quadric (Garland and Heckbert), weighted by the area of the planes it was built from.
+ */
+struct Quadric {
+	double a2 = 0, ab = 0, ac = 0, ad = 0;
+	double b2 = 0, bc = 0, bd = 0;
+	double c2 = 0, cd = 0;
+	double d2 = 0;
+	double weight = 0;
+
+	static Quadric fromPlane(const glm::dvec3 & n, double d, double weight)
+	{
+		Quadric q;
+		q.a2 = n.x * n.x * weight; q.ab = n.x * n.y * weight; q.ac = n.x * n.z * weight; q.ad = n.x * d * weight;
+		q.b2 = n.y * n.y * weight; q.bc = n.y * n.z * weight; q.bd = n.y * d * weight;
+		q.c2 = n.z * n.z * weight; q.cd = n.z * d * weight;
+		q.d2 = d * d * weight;
+		q.weight = weight;
+		return q;
+	}
+
+	void add(const Quadric & q)
+	{
+		a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+		b2 += q.b2; bc += q.bc; bd += q.bd;
+		c2 += q.c2; cd += q.cd;
+		d2 += q.d2;
+		weight += q.weight;
+	}
+
+	double evaluate(const glm::vec3 & p) const
+	{
+		const double x = p.x, y = p.y, z = p.z;
+		double error = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+			+ b2 * y * y + 2 * bc * y * z + 2 * bd * y
+			+ c2 * z * z + 2 * cd * z
+			+ d2;
+		return std::max(error, 0.0);
+	}
+};
+
+enum class VertexKind : unsigned char {
+	Manifold,	// may collapse onto any neighbor
+	Border,		// may only collapse along a border edge onto another border vertex
+	Locked		// never collapses (seams)
+};
+
+struct Collapse {
+	GLuint source;
+	GLuint target;
+	double error;
+	unsigned int source_version;
+	unsigned int target_version;
+
+	bool operator>(const Collapse & other) const { return error > other.error; }
+};
+
+}
+
+static glm::dvec3 toDouble(const glm::vec3 & v)
+{
+	return glm::dvec3(v.x, v.y, v.z);
+}
+
+std::vector<GLuint> mygl::simplifyIndices(const std::vector<GLuint> & indices, const std::vector<glm::vec3> & positions,
+	const SimplificationOptions & options, float * result_error)
+{
+	const size_t vertex_count = positions.size();
+	const size_t triangle_count = indices.size() / 3;
+	if (result_error) *result_error = 0.f;
+	if (triangle_count == 0 || triangle_count <= options.target_triangle_count) return indices;
+
+	// the error is measured relative to the extent of the mesh
+	glm::vec3 min_position = positions[indices[0]], max_position = positions[indices[0]];
+	for (GLuint index : indices) {
+		min_position = glm::min(min_position, positions[index]);
+		max_position = glm::max(max_position, positions[index]);
+	}
+	const double extent = std::max<double>(glm::length(max_position - min_position), 1e-12);
+	const double max_error = static_cast<double>(options.target_error) * extent;
+	const double max_error_squared = max_error * max_error;
+
+	// vertices that share a position with another vertex lie on an attribute seam
+	std::vector<VertexKind> kinds(vertex_count, VertexKind::Manifold);
+	{
+		std::unordered_map<std::string, GLuint> first_vertex_at_position;
+		first_vertex_at_position.reserve(vertex_count);
+		for (size_t v = 0; v < vertex_count; v++) {
+			std::string key(reinterpret_cast<const char *>(&positions[v]), sizeof(glm::vec3));
+			auto it = first_vertex_at_position.emplace(key, static_cast<GLuint>(v));
+			if (!it.second) {
+				kinds[v] = VertexKind::Locked;
+				kinds[it.first->second] = VertexKind::Locked;
+			}
+		}
+	}
+
+	std::vector<GLuint> triangles(indices.begin(), indices.begin() + triangle_count * 3);
+	std::vector<bool> triangle_alive(triangle_count, true);
+	size_t alive_count = triangle_count;
+
+	std::vector<std::vector<unsigned int>> vertex_triangles(vertex_count);
+	for (size_t t = 0; t < triangle_count; t++) {
+		for (size_t k = 0; k < 3; k++) vertex_triangles[triangles[t * 3 + k]].push_back(static_cast<unsigned int>(t));
+	}
+
+	// border edges are used by exactly one triangle
+	std::unordered_map<unsigned long long, unsigned int> edge_use;
+	edge_use.reserve(indices.size());
+	auto edgeKey = [](GLuint a, GLuint b) {
+		return (static_cast<unsigned long long>(std::min(a, b)) << 32) | std::max(a, b);
+	};
+	for (size_t t = 0; t < triangle_count; t++) {
+		for (size_t k = 0; k < 3; k++) edge_use[edgeKey(triangles[t * 3 + k], triangles[t * 3 + (k + 1) % 3])]++;
+	}
+	auto isBorderEdge = [&](GLuint a, GLuint b) {
+		auto it = edge_use.find(edgeKey(a, b));
+		return it != edge_use.end() && it->second == 1;
+	};
+
+	// quadrics from the planes of the triangles and border constraint planes
+	std::vector<Quadric> quadrics(vertex_count);
+	for (size_t t = 0; t < triangle_count; t++) {
+		const GLuint * tri = &triangles[t * 3];
+		glm::dvec3 p0 = toDouble(positions[tri[0]]), p1 = toDouble(positions[tri[1]]), p2 = toDouble(positions[tri[2]]);
+		glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+		double length = glm::length(n);
+		if (length <= 0.0) continue;
+		n /= length;
+		Quadric q = Quadric::fromPlane(n, -glm::dot(n, p0), length * 0.5);
+		for (size_t k = 0; k < 3; k++) quadrics[tri[k]].add(q);
+
+		for (size_t k = 0; k < 3; k++) {
+			GLuint a = tri[k], b = tri[(k + 1) % 3];
+			if (!isBorderEdge(a, b)) continue;
+			if (kinds[a] == VertexKind::Manifold) kinds[a] = options.lock_border ? VertexKind::Locked : VertexKind::Border;
+			if (kinds[b] == VertexKind::Manifold) kinds[b] = options.lock_border ? VertexKind::Locked : VertexKind::Border;
+
+			// a plane perpendicular to the triangle through the border edge keeps the border in place
+			glm::dvec3 pa = toDouble(positions[a]), pb = toDouble(positions[b]);
+			glm::dvec3 edge = pb - pa;
+			double edge_length = glm::length(edge);
+			if (edge_length <= 0.0) continue;
+			glm::dvec3 border_normal = glm::normalize(glm::cross(edge, n));
+			Quadric border = Quadric::fromPlane(border_normal, -glm::dot(border_normal, pa), edge_length * edge_length);
+			border.weight = 0.0; // constraint planes do not count towards the surface area
+			quadrics[a].add(border);
+			quadrics[b].add(border);
+		}
+	}
+
+	std::vector<unsigned int> versions(vertex_count, 0);
+	std::vector<bool> removed(vertex_count, false);
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+
+	auto canCollapse = [&](GLuint source, GLuint target) {
+		if (kinds[source] == VertexKind::Locked) return false;
+		if (kinds[source] == VertexKind::Border) return kinds[target] != VertexKind::Manifold && isBorderEdge(source, target);
+		return true;
+	};
+
+	auto collapseError = [&](GLuint source, GLuint target) {
+		Quadric q = quadrics[source];
+		q.add(quadrics[target]);
+		return q.weight > 0.0 ? q.evaluate(positions[target]) / q.weight : q.evaluate(positions[target]);
+	};
+
+	auto pushEdge = [&](GLuint a, GLuint b) {
+		bool a_to_b = canCollapse(a, b);
+		bool b_to_a = canCollapse(b, a);
+		if (!a_to_b && !b_to_a) return;
+		double error_ab = a_to_b ? collapseError(a, b) : 0.0;
+		double error_ba = b_to_a ? collapseError(b, a) : 0.0;
+		if (a_to_b && (!b_to_a || error_ab <= error_ba)) {
+			heap.push({ a, b, error_ab, versions[a], versions[b] });
+		} else {
+			heap.push({ b, a, error_ba, versions[b], versions[a] });
+		}
+	};
+
+	for (size_t t = 0; t < triangle_count; t++) {
+		for (size_t k = 0; k < 3; k++) {
+			GLuint a = triangles[t * 3 + k], b = triangles[t * 3 + (k + 1) % 3];
+			if (a < b || isBorderEdge(a, b)) pushEdge(a, b);
+		}
+	}
+
+	std::vector<GLuint> source_neighbors, target_neighbors;
+	auto collectNeighbors = [&](GLuint v, std::vector<GLuint> & out) {
+		out.clear();
+		for (unsigned int t : vertex_triangles[v]) {
+			if (!triangle_alive[t]) continue;
+			for (size_t k = 0; k < 3; k++) {
+				GLuint n = triangles[t * 3 + k];
+				if (n != v) out.push_back(n);
+			}
+		}
+		std::sort(out.begin(), out.end());
+		out.erase(std::unique(out.begin(), out.end()), out.end());
+	};
+
+	double reached_error = 0.0;
+	while (!heap.empty() && alive_count > options.target_triangle_count) {
+		Collapse collapse = heap.top();
+		heap.pop();
+
+		if (removed[collapse.source] || removed[collapse.target]) continue;
+		if (versions[collapse.source] != collapse.source_version || versions[collapse.target] != collapse.target_version) continue;
+		if (collapse.error > max_error_squared) break;
+
+		const GLuint source = collapse.source, target = collapse.target;
+
+		// link condition: the edge may only share as many neighbors as it has adjacent triangles,
+		// otherwise the collapse would create non-manifold geometry
+		collectNeighbors(source, source_neighbors);
+		collectNeighbors(target, target_neighbors);
+		size_t shared_neighbors = 0, shared_triangles = 0;
+		for (GLuint n : source_neighbors) {
+			if (std::binary_search(target_neighbors.begin(), target_neighbors.end(), n)) shared_neighbors++;
+		}
+		for (unsigned int t : vertex_triangles[source]) {
+			if (!triangle_alive[t]) continue;
+			const GLuint * tri = &triangles[t * 3];
+			if (tri[0] == target || tri[1] == target || tri[2] == target) shared_triangles++;
+		}
+		if (shared_triangles == 0 || shared_neighbors != shared_triangles) continue;
+
+		// reject collapses that flip a triangle
+		bool flips = false;
+		for (unsigned int t : vertex_triangles[source]) {
+			if (!triangle_alive[t]) continue;
+			const GLuint * tri = &triangles[t * 3];
+			if (tri[0] == target || tri[1] == target || tri[2] == target) continue;
+
+			glm::vec3 p[3], q[3];
+			for (size_t k = 0; k < 3; k++) {
+				p[k] = positions[tri[k]];
+				q[k] = tri[k] == source ? positions[target] : p[k];
+			}
+			glm::vec3 n_old = glm::cross(p[1] - p[0], p[2] - p[0]);
+			glm::vec3 n_new = glm::cross(q[1] - q[0], q[2] - q[0]);
+			if (glm::dot(n_old, n_new) <= 0.25f * glm::length(n_old) * glm::length(n_new)) {
+				flips = true;
+				break;
+			}
+		}
+		if (flips) continue;
+
+		// collapse: triangles that contain both vertices disappear, all others move to the target
+		for (unsigned int t : vertex_triangles[source]) {
+			if (!triangle_alive[t]) continue;
+			GLuint * tri = &triangles[t * 3];
+			if (tri[0] == target || tri[1] == target || tri[2] == target) {
+				triangle_alive[t] = false;
+				alive_count--;
+				continue;
+			}
+			for (size_t k = 0; k < 3; k++) {
+				if (tri[k] == source) tri[k] = target;
+			}
+			vertex_triangles[target].push_back(t);
+		}
+
+		// edges of the source move to the target, edges to shared neighbors merge and lose the removed triangles
+		for (GLuint n : source_neighbors) {
+			if (n == target) continue;
+			unsigned int uses = edge_use[edgeKey(source, n)];
+			if (std::binary_search(target_neighbors.begin(), target_neighbors.end(), n)) {
+				uses = uses + edge_use[edgeKey(target, n)] - 2;
+			}
+			edge_use[edgeKey(target, n)] = uses;
+			edge_use.erase(edgeKey(source, n));
+		}
+		edge_use.erase(edgeKey(source, target));
+		vertex_triangles[source].clear();
+		removed[source] = true;
+		quadrics[target].add(quadrics[source]);
+		versions[target]++;
+		reached_error = std::max(reached_error, collapse.error);
+
+		// compact the triangle list of the target and schedule its edges again
+		auto & target_triangles = vertex_triangles[target];
+		target_triangles.erase(std::remove_if(target_triangles.begin(), target_triangles.end(),
+			[&triangle_alive](unsigned int t) { return !triangle_alive[t]; }), target_triangles.end());
+		collectNeighbors(target, target_neighbors);
+		for (GLuint n : target_neighbors) pushEdge(target, n);
+	}
+
+	std::vector<GLuint> result;
+	result.reserve(alive_count * 3);
+	for (size_t t = 0; t < triangle_count; t++) {
+		if (triangle_alive[t]) result.insert(result.end(), triangles.begin() + t * 3, triangles.begin() + t * 3 + 3);
+	}
+
+	if (result_error) *result_error = static_cast<float>(std::sqrt(reached_error) / extent);
+	return result;
+}
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <mygl/Meshlet.hpp>
+#include <mygl/Parallel.hpp>
+
+using namespace mygl;
+
+static const unsigned char MESHLET_UNUSED = 0xFF;
+
+/**
+ * @brief Calculates the bounding sphere and the normal cone of a single meshlet.
+ */
+static void calculateMeshletBounds(Meshlet & meshlet, const MeshletData & data, const std::vector<glm::vec3> & positions)
+{
+	const GLuint * vertices = &data.vertices[meshlet.vertex_offset];
+	const unsigned char * triangles = &data.triangles[meshlet.triangle_offset];
+
+	glm::vec3 center(0.f);
+	for (unsigned int v = 0; v < meshlet.vertex_count; v++) center += positions[vertices[v]];
+	center /= static_cast<float>(std::max(meshlet.vertex_count, 1u));
+
+	float radius = 0.f;
+	for (unsigned int v = 0; v < meshlet.vertex_count; v++) radius = std::max(radius, glm::length(positions[vertices[v]] - center));
+	meshlet.center = center;
+	meshlet.radius = radius;
+
+	std::vector<glm::vec3> normals;
+	normals.reserve(meshlet.triangle_count);
+	glm::vec3 axis(0.f);
+	for (unsigned int t = 0; t < meshlet.triangle_count; t++) {
+		const glm::vec3 & p0 = positions[vertices[triangles[t * 3 + 0]]];
+		const glm::vec3 & p1 = positions[vertices[triangles[t * 3 + 1]]];
+		const glm::vec3 & p2 = positions[vertices[triangles[t * 3 + 2]]];
+		glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+		float length = glm::length(normal);
+		if (length <= 0.f) continue;
+		normals.push_back(normal / length);
+		axis += normals.back();
+	}
+
+	meshlet.cone_axis = glm::vec3(0.f, 0.f, 1.f);
+	meshlet.cone_cutoff = 1.f;
+	float axis_length = glm::length(axis);
+	if (normals.empty() || axis_length <= 0.f) return;
+	axis /= axis_length;
+
+	float min_dot = 1.f;
+	for (const glm::vec3 & normal : normals) min_dot = std::min(min_dot, glm::dot(normal, axis));
+
+	meshlet.cone_axis = axis;
+	// cones that are wider than ~84 degrees are never back-facing as a whole
+	if (min_dot > 0.1f) meshlet.cone_cutoff = std::sqrt(1.f - min_dot * min_dot);
+}
+
+MeshletData mygl::buildMeshlets(const std::vector<GLuint> & indices, const std::vector<glm::vec3> & positions,
+	unsigned int max_vertices, unsigned int max_triangles)
+{
+	max_vertices = std::min(std::max(max_vertices, 3u), static_cast<unsigned int>(MESHLET_UNUSED));
+	max_triangles = std::max(max_triangles, 1u);
+
+	MeshletData data;
+	const size_t triangle_count = indices.size() / 3;
+	data.triangles.reserve(triangle_count * 3);
+	data.vertices.reserve(triangle_count);
+
+	// local index of every mesh vertex inside of the current meshlet
+	std::vector<unsigned char> local(positions.size(), MESHLET_UNUSED);
+	Meshlet current;
+
+	auto finishMeshlet = [&]() {
+		if (current.triangle_count == 0) return;
+		for (size_t v = current.vertex_offset; v < data.vertices.size(); v++) local[data.vertices[v]] = MESHLET_UNUSED;
+		data.meshlets.push_back(current);
+		current = Meshlet();
+		current.vertex_offset = data.vertices.size();
+		current.triangle_offset = data.triangles.size();
+	};
+
+	for (size_t t = 0; t < triangle_count; t++) {
+		const GLuint * triangle = &indices[t * 3];
+		unsigned int new_vertices = 0;
+		for (int c = 0; c < 3; c++) {
+			if (local[triangle[c]] == MESHLET_UNUSED) new_vertices++;
+		}
+		// repeated corners of degenerate triangles are counted twice, which only makes the test more conservative
+		if (current.vertex_count + new_vertices > max_vertices || current.triangle_count + 1 > max_triangles) finishMeshlet();
+
+		for (int c = 0; c < 3; c++) {
+			unsigned char & slot = local[triangle[c]];
+			if (slot == MESHLET_UNUSED) {
+				slot = static_cast<unsigned char>(current.vertex_count++);
+				data.vertices.push_back(triangle[c]);
+			}
+			data.triangles.push_back(slot);
+		}
+		current.triangle_count++;
+	}
+	finishMeshlet();
+
+	parallelFor(0, data.meshlets.size(), [&](size_t begin, size_t end) {
+		for (size_t m = begin; m < end; m++) calculateMeshletBounds(data.meshlets[m], data, positions);
+	}, 256);
+	return data;
+}
+
+std::vector<glm::vec4> mygl::extractFrustumPlanes(const glm::mat4 & view_projection)
+{
+	auto row = [&view_projection](int r) {
+		return glm::vec4(view_projection[0][r], view_projection[1][r], view_projection[2][r], view_projection[3][r]);
+	};
+	std::vector<glm::vec4> planes = {
+		row(3) + row(0), row(3) - row(0),
+		row(3) + row(1), row(3) - row(1),
+		row(3) + row(2), row(3) - row(2)
+	};
+	for (glm::vec4 & plane : planes) {
+		float length = glm::length(glm::vec3(plane));
+		if (length > 0.f) plane /= length;
+	}
+	return planes;
+}
+
+bool mygl::isMeshletVisible(const Meshlet & meshlet, const std::vector<glm::vec4> & planes, const glm::vec3 & camera_position)
+{
+	for (const glm::vec4 & plane : planes) {
+		if (glm::dot(glm::vec3(plane), meshlet.center) + plane.w < -meshlet.radius) return false;
+	}
+
+	// all triangles face away if the view direction stays inside of the (widened) normal cone
+	glm::vec3 view = meshlet.center - camera_position;
+	return glm::dot(view, meshlet.cone_axis) < meshlet.cone_cutoff * glm::length(view) + meshlet.radius;
+}
+
+size_t mygl::cullMeshlets(const MeshletData & data, const glm::mat4 & model_view_projection, const glm::vec3 & camera_position,
+	GLuint * out_indices, size_t * out_visible_meshlets)
+{
+	const std::vector<glm::vec4> planes = extractFrustumPlanes(model_view_projection);
+	const size_t meshlet_count = data.meshlets.size();
+
+	// 1. test the meshlets and count the indices they contribute
+	std::vector<size_t> offsets(meshlet_count + 1, 0);
+	parallelFor(0, meshlet_count, [&](size_t begin, size_t end) {
+		for (size_t m = begin; m < end; m++) {
+			const Meshlet & meshlet = data.meshlets[m];
+			offsets[m + 1] = isMeshletVisible(meshlet, planes, camera_position) ? meshlet.triangle_count * 3 : 0;
+		}
+	}, 256);
+
+	size_t visible_meshlets = 0;
+	for (size_t m = 0; m < meshlet_count; m++) {
+		if (offsets[m + 1] > 0) visible_meshlets++;
+		offsets[m + 1] += offsets[m];
+	}
+	if (out_visible_meshlets) *out_visible_meshlets = visible_meshlets;
+
+	// 2. expand the local indices of the visible meshlets
+	parallelFor(0, meshlet_count, [&](size_t begin, size_t end) {
+		for (size_t m = begin; m < end; m++) {
+			if (offsets[m + 1] == offsets[m]) continue;
+			const Meshlet & meshlet = data.meshlets[m];
+			const GLuint * vertices = &data.vertices[meshlet.vertex_offset];
+			const unsigned char * triangles = &data.triangles[meshlet.triangle_offset];
+			GLuint * target = out_indices + offsets[m];
+			for (unsigned int i = 0; i < meshlet.triangle_count * 3; i++) target[i] = vertices[triangles[i]];
+		}
+	}, 256);
+	return offsets[meshlet_count];
+}
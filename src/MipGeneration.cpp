@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mygl/MipGeneration.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MYGL_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace mygl;
+
+namespace {
+	// one texel with 4 channels per register, the scalar fallback has the same interface
+#ifdef MYGL_SSE2
+	typedef __m128 float4;
+
+	inline float4 load4(const float * p) { return _mm_loadu_ps(p); }
+	inline void store4(float * p, float4 v) { _mm_storeu_ps(p, v); }
+	inline float4 set4(float v) { return _mm_set1_ps(v); }
+	inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+	inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+	inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+	inline float4 min4(float4 a, float4 b) { return _mm_min_ps(a, b); }
+	inline float4 max4(float4 a, float4 b) { return _mm_max_ps(a, b); }
+	inline float lane4(float4 v, int lane) { alignas(16) float lanes[4]; _mm_store_ps(lanes, v); return lanes[lane]; }
+	inline float4 broadcastW(float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+
+	// the color channels of a and the alpha channel of b
+	inline float4 withAlpha(float4 a, float4 b)
+	{
+		const float4 alpha = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 3, 2, 2));
+		return _mm_shuffle_ps(a, alpha, _MM_SHUFFLE(2, 0, 1, 0));
+	}
+
+	inline float4 loadBytes4(const unsigned char * p)
+	{
+		int32_t bytes;
+		std::memcpy(&bytes, p, 4);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+		return _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+	}
+
+	// rounds to nearest and saturates to [0, 255]
+	inline void storeBytes4(unsigned char * p, float4 v)
+	{
+		const __m128i words = _mm_packs_epi32(_mm_cvtps_epi32(v), _mm_setzero_si128());
+		const int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+		std::memcpy(p, &bytes, 4);
+	}
+#else
+	struct float4 {
+		float v[4];
+	};
+
+	inline float4 load4(const float * p) { float4 r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+	inline void store4(float * p, float4 v) { std::memcpy(p, v.v, sizeof(v.v)); }
+	inline float4 set4(float v) { return { { v, v, v, v } }; }
+	inline float4 add4(float4 a, float4 b) { for (int c = 0; c < 4; c++) a.v[c] += b.v[c]; return a; }
+	inline float4 sub4(float4 a, float4 b) { for (int c = 0; c < 4; c++) a.v[c] -= b.v[c]; return a; }
+	inline float4 mul4(float4 a, float4 b) { for (int c = 0; c < 4; c++) a.v[c] *= b.v[c]; return a; }
+	inline float4 min4(float4 a, float4 b) { for (int c = 0; c < 4; c++) a.v[c] = std::min(a.v[c], b.v[c]); return a; }
+	inline float4 max4(float4 a, float4 b) { for (int c = 0; c < 4; c++) a.v[c] = std::max(a.v[c], b.v[c]); return a; }
+	inline float lane4(float4 v, int lane) { return v.v[lane]; }
+	inline float4 broadcastW(float4 v) { return set4(v.v[3]); }
+	inline float4 withAlpha(float4 a, float4 b) { a.v[3] = b.v[3]; return a; }
+
+	inline float4 loadBytes4(const unsigned char * p) { return { { float(p[0]), float(p[1]), float(p[2]), float(p[3]) } }; }
+
+	inline void storeBytes4(unsigned char * p, float4 v)
+	{
+		for (int c = 0; c < 4; c++) p[c] = static_cast<unsigned char>(std::clamp(std::nearbyint(v.v[c]), 0.f, 255.f));
+	}
+#endif
+
+	float decodeSrgb(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float encodeSrgb(float value)
+	{
+		value = std::clamp(value, 0.f, 1.f);
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+	}
+
+	const float * getDecodeTable()
+	{
+		static const std::vector<float> table = []() {
+			std::vector<float> values(256);
+			for (int v = 0; v < 256; v++) values[v] = decodeSrgb(v / 255.f);
+			return values;
+		}();
+		return table.data();
+	}
+
+	// the encoded byte of every linear value in [2^-13, 1), indexed by its exponent and the upper 8 bits of its mantissa;
+	// smaller values encode to 0
+	const uint32_t ENCODE_MIN_BITS = 0x39000000;	// 2^-13
+	const uint32_t ENCODE_MAX_BITS = 0x3f7fffff;	// the largest float below 1
+	const int ENCODE_SHIFT = 15;
+
+	const unsigned char * getEncodeTable()
+	{
+		static const std::vector<unsigned char> table = []() {
+			std::vector<unsigned char> values(((ENCODE_MAX_BITS - ENCODE_MIN_BITS) >> ENCODE_SHIFT) + 1);
+			for (uint32_t i = 0; i < values.size(); i++) {
+				// the value in the middle of the bucket
+				const uint32_t bits = ENCODE_MIN_BITS + (i << ENCODE_SHIFT) + (1u << (ENCODE_SHIFT - 1));
+				float value;
+				std::memcpy(&value, &bits, 4);
+				values[i] = static_cast<unsigned char>(encodeSrgb(value) * 255.f + 0.5f);
+			}
+			return values;
+		}();
+		return table.data();
+	}
+
+	struct Tap {
+		uint32_t index;
+		float weight;
+	};
+
+	// the zeroth order modified Bessel function of the first kind
+	double besselI0(double x)
+	{
+		double sum = 1.0, term = 1.0;
+		for (int k = 1; k < 32; k++) {
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+			if (term < sum * 1e-12) break;
+		}
+		return sum;
+	}
+
+	double kaiser(double t)
+	{
+		// the width in texels of the smaller level and the shape of the window, as in common texture tools
+		const double WIDTH = 2.0, ALPHA = 4.0;
+		if (std::abs(t) >= WIDTH) return 0.0;
+		const double sinc = t == 0.0 ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+		const double r = t / WIDTH;
+		return sinc * besselI0(ALPHA * std::sqrt(1.0 - r * r)) / besselI0(ALPHA);
+	}
+
+	// the source texels that contribute to every texel of the smaller extent, with weights that sum up to 1
+	std::vector<std::vector<Tap>> computeTaps(uint32_t source, uint32_t target, MipFilter filter)
+	{
+		std::vector<std::vector<Tap>> taps(target);
+		const double scale = static_cast<double>(source) / target;
+		for (uint32_t x = 0; x < target; x++) {
+			if (filter == MipFilter::Box) {
+				// partially covered texels of odd extents contribute with their covered fraction
+				const double low = x * scale;
+				const double high = (x + 1) * scale;
+				for (uint32_t i = static_cast<uint32_t>(low); i < source && i < high; i++) {
+					const double covered = std::min<double>(high, i + 1) - std::max<double>(low, i);
+					if (covered > 0.0) taps[x].push_back({ i, static_cast<float>(covered / scale) });
+				}
+				continue;
+			}
+
+			// the window is measured in texels of the smaller extent, texels beyond the edges repeat the edge texels
+			const double center = (x + 0.5) * scale;
+			const int64_t first = static_cast<int64_t>(std::floor(center - 2.0 * scale));
+			const int64_t last = static_cast<int64_t>(std::ceil(center + 2.0 * scale));
+			double sum = 0.0;
+			for (int64_t i = first; i <= last; i++) {
+				const double weight = kaiser((i + 0.5 - center) / scale);
+				if (weight == 0.0) continue;
+				const uint32_t index = static_cast<uint32_t>(std::clamp<int64_t>(i, 0, source - 1));
+				if (!taps[x].empty() && taps[x].back().index == index) taps[x].back().weight += static_cast<float>(weight);
+				else taps[x].push_back({ index, static_cast<float>(weight) });
+				sum += weight;
+			}
+			for (Tap & tap : taps[x]) tap.weight = static_cast<float>(tap.weight / sum);
+		}
+		return taps;
+	}
+
+	void renormalize(float * rgba, size_t texel_count)
+	{
+		for (size_t t = 0; t < texel_count; t++) {
+			float * texel = rgba + t * 4;
+			const float length = std::sqrt(texel[0] * texel[0] + texel[1] * texel[1] + texel[2] * texel[2]);
+			if (length > 0.f) {
+				const float4 scale = set4(1.f / length);
+				store4(texel, withAlpha(mul4(load4(texel), scale), load4(texel)));
+			}
+			else {
+				texel[0] = 0.f;
+				texel[1] = 0.f;
+				texel[2] = 1.f;
+			}
+		}
+	}
+
+	// the space in which texels are filtered: linear light premultiplied by alpha for colors, vectors in [-1, 1] for normals
+	void toFilterSpace(const unsigned char * rgba, float * filtered, size_t texel_count, TextureContent content)
+	{
+		if (content == TextureContent::Color) {
+			convertSrgbToLinear(rgba, filtered, texel_count);
+			premultiplyAlpha(filtered, texel_count);
+			return;
+		}
+		const float4 scale = content == TextureContent::Normal ? withAlpha(set4(2.f / 255.f), set4(1.f / 255.f)) : set4(1.f / 255.f);
+		const float4 offset = content == TextureContent::Normal ? withAlpha(set4(-1.f), set4(0.f)) : set4(0.f);
+		for (size_t t = 0; t < texel_count; t++) store4(filtered + t * 4, add4(mul4(loadBytes4(rgba + t * 4), scale), offset));
+	}
+
+	void fromFilterSpace(float * filtered, unsigned char * rgba, size_t texel_count, TextureContent content)
+	{
+		if (content == TextureContent::Color) {
+			unpremultiplyAlpha(filtered, texel_count);
+			convertLinearToSrgb(filtered, rgba, texel_count);
+			return;
+		}
+		const float4 scale = content == TextureContent::Normal ? withAlpha(set4(127.5f), set4(255.f)) : set4(255.f);
+		const float4 offset = content == TextureContent::Normal ? withAlpha(set4(127.5f), set4(0.f)) : set4(0.f);
+		for (size_t t = 0; t < texel_count; t++) storeBytes4(rgba + t * 4, add4(mul4(load4(filtered + t * 4), scale), offset));
+	}
+}
+
+void mygl::convertSrgbToLinear(const unsigned char * srgb, float * linear, size_t texel_count)
+{
+	const float * table = getDecodeTable();
+	for (size_t t = 0; t < texel_count; t++) {
+		const unsigned char * texel = srgb + t * 4;
+		float * result = linear + t * 4;
+		result[0] = table[texel[0]];
+		result[1] = table[texel[1]];
+		result[2] = table[texel[2]];
+		result[3] = texel[3] / 255.f;
+	}
+}
+
+void mygl::convertLinearToSrgb(const float * linear, unsigned char * srgb, size_t texel_count)
+{
+	const unsigned char * table = getEncodeTable();
+	float min_value, max_value;
+	std::memcpy(&min_value, &ENCODE_MIN_BITS, 4);
+	std::memcpy(&max_value, &ENCODE_MAX_BITS, 4);
+	for (size_t t = 0; t < texel_count; t++) {
+		const float * texel = linear + t * 4;
+		unsigned char * result = srgb + t * 4;
+#ifdef MYGL_SSE2
+		// the table indices of all channels at once, values below the table encode to 0
+		const __m128 value = _mm_loadu_ps(texel);
+		const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(min_value)), _mm_set1_ps(max_value));
+		alignas(16) int32_t indices[4];
+		_mm_store_si128(reinterpret_cast<__m128i *>(indices),
+			_mm_srli_epi32(_mm_sub_epi32(_mm_castps_si128(clamped), _mm_set1_epi32(static_cast<int32_t>(ENCODE_MIN_BITS))), ENCODE_SHIFT));
+		const int mask = _mm_movemask_ps(_mm_cmplt_ps(value, _mm_set1_ps(min_value)));
+		for (int c = 0; c < 3; c++) result[c] = (mask >> c) & 1 ? 0 : table[indices[c]];
+#else
+		for (int c = 0; c < 3; c++) {
+			if (!(texel[c] >= min_value)) {
+				result[c] = 0;
+				continue;
+			}
+			const float clamped = std::min(texel[c], max_value);
+			uint32_t bits;
+			std::memcpy(&bits, &clamped, 4);
+			result[c] = table[(bits - ENCODE_MIN_BITS) >> ENCODE_SHIFT];
+		}
+#endif
+		result[3] = static_cast<unsigned char>(std::clamp(texel[3], 0.f, 1.f) * 255.f + 0.5f);
+	}
+}
+
+void mygl::premultiplyAlpha(float * rgba, size_t texel_count)
+{
+	for (size_t t = 0; t < texel_count; t++) {
+		const float4 texel = load4(rgba + t * 4);
+		store4(rgba + t * 4, withAlpha(mul4(texel, broadcastW(texel)), texel));
+	}
+}
+
+void mygl::unpremultiplyAlpha(float * rgba, size_t texel_count)
+{
+	for (size_t t = 0; t < texel_count; t++) {
+		const float4 texel = load4(rgba + t * 4);
+		const float alpha = lane4(texel, 3);
+		const float4 scale = set4(alpha > 0.f ? 1.f / alpha : 0.f);
+		store4(rgba + t * 4, withAlpha(mul4(texel, scale), texel));
+	}
+}
+
+void mygl::downsample(const float * source, uint32_t width, uint32_t height, float * target, uint32_t target_width, uint32_t target_height, MipFilter filter)
+{
+	// halving both extents with the box is the common case, every target texel averages a 2 x 2 quad
+	if (filter == MipFilter::Box && width == target_width * 2 && height == target_height * 2) {
+		const float4 quarter = set4(0.25f);
+		for (uint32_t y = 0; y < target_height; y++) {
+			const float * row0 = source + static_cast<size_t>(y) * 2 * width * 4;
+			const float * row1 = row0 + static_cast<size_t>(width) * 4;
+			float * result = target + static_cast<size_t>(y) * target_width * 4;
+			for (uint32_t x = 0; x < target_width; x++) {
+				const float4 top = add4(load4(row0 + x * 8), load4(row0 + x * 8 + 4));
+				const float4 bottom = add4(load4(row1 + x * 8), load4(row1 + x * 8 + 4));
+				store4(result + x * 4, mul4(add4(top, bottom), quarter));
+			}
+		}
+		return;
+	}
+
+	// separable, first along the rows into the target width, then along the columns
+	const std::vector<std::vector<Tap>> taps_x = computeTaps(width, target_width, filter);
+	const std::vector<std::vector<Tap>> taps_y = computeTaps(height, target_height, filter);
+	std::vector<float> rows(static_cast<size_t>(target_width) * height * 4);
+	for (uint32_t y = 0; y < height; y++) {
+		const float * row = source + static_cast<size_t>(y) * width * 4;
+		for (uint32_t x = 0; x < target_width; x++) {
+			float4 sum = set4(0.f);
+			for (const Tap & tap : taps_x[x]) sum = add4(sum, mul4(load4(row + static_cast<size_t>(tap.index) * 4), set4(tap.weight)));
+			store4(&rows[(static_cast<size_t>(y) * target_width + x) * 4], sum);
+		}
+	}
+	for (uint32_t y = 0; y < target_height; y++) {
+		float * result = target + static_cast<size_t>(y) * target_width * 4;
+		for (uint32_t x = 0; x < target_width; x++) {
+			float4 sum = set4(0.f);
+			for (const Tap & tap : taps_y[y]) sum = add4(sum, mul4(load4(&rows[(static_cast<size_t>(tap.index) * target_width + x) * 4]), set4(tap.weight)));
+			store4(result + x * 4, sum);
+		}
+	}
+}
+
+std::vector<MipLevel> mygl::generateMipLevels(const unsigned char * rgba, uint32_t width, uint32_t height, TextureContent content, MipFilter filter)
+{
+	std::vector<MipLevel> levels;
+	levels.push_back({ width, height, std::vector<unsigned char>(rgba, rgba + static_cast<size_t>(width) * height * 4) });
+
+	std::vector<float> filtered(static_cast<size_t>(width) * height * 4);
+	toFilterSpace(rgba, filtered.data(), static_cast<size_t>(width) * height, content);
+	std::vector<float> next;
+	std::vector<float> encoded;
+	while (width > 1 || height > 1) {
+		const uint32_t next_width = std::max(width / 2, 1u);
+		const uint32_t next_height = std::max(height / 2, 1u);
+		const size_t texel_count = static_cast<size_t>(next_width) * next_height;
+		next.resize(texel_count * 4);
+		downsample(filtered.data(), width, height, next.data(), next_width, next_height, filter);
+
+		// the negative lobes of the Kaiser filter can overshoot
+		if (content != TextureContent::Normal) {
+			const float4 zero = set4(0.f), one = set4(1.f);
+			for (size_t t = 0; t < texel_count; t++) {
+				float4 texel = max4(load4(&next[t * 4]), zero);
+				store4(&next[t * 4], withAlpha(texel, min4(texel, one)));
+			}
+		}
+		// normals are filtered as unit vectors again on the next level
+		else {
+			renormalize(next.data(), texel_count);
+		}
+
+		MipLevel level = { next_width, next_height, std::vector<unsigned char>(texel_count * 4) };
+		encoded.assign(next.begin(), next.end());
+		fromFilterSpace(encoded.data(), level.rgba.data(), texel_count, content);
+		levels.push_back(std::move(level));
+
+		std::swap(filtered, next);
+		width = next_width;
+		height = next_height;
+	}
+	return levels;
+}
@@ -0,0 +1,898 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <glm/gtc/matrix_transform.hpp>
+#include <mygl/ModelImporter.hpp>
+#include <mygl/ChannelPacking.hpp>
+#include <mygl/MeshAttributes.hpp>
+#include <mygl/Parallel.hpp>
+#include <mygl/Json.hpp>
+#include <mygl/TextureManager.hpp>
+
+using namespace mygl;
+
+namespace fs = std::filesystem;
+
+// === common helpers ===
+
+static std::vector<char> readWholeFile(const std::string & path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		std::cerr << "ERROR::cannot open model file " << path << std::endl;
+		throw std::runtime_error("cannot open model file " + path);
+	}
+	std::vector<char> content(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(content.data(), static_cast<std::streamsize>(content.size()));
+	return content;
+}
+
+/**
+ * @brief Returns the directory of a file with a trailing separator, as expected by the texture library path.
+ */
+static std::string getDirectory(const std::string & path)
+{
+	fs::path directory = fs::path(path).parent_path();
+	return directory.empty() ? std::string("./") : directory.generic_string() + "/";
+}
+
+// the color of a normal map without displacement
+static const glm::vec4 NORMAL_PLACEHOLDER(0.5f, 0.5f, 1.f, 1.f);
+
+static std::optional<std::shared_ptr<Texture>> loadTexture(const std::string & directory, const std::string & relative_path, const ImportOptions & options,
+	const glm::vec4 & placeholder = glm::vec4(1.f), TextureContent content = TextureContent::Linear)
+{
+	if (!options.load_textures || relative_path.empty()) return std::nullopt;
+	std::shared_ptr<Texture> texture = TextureManager::getInstance().acquireTexture(directory + relative_path, options.texture_loader, placeholder, content);
+	if (!options.texture_loader && !texture->isSuccessfullyLoaded()) return std::nullopt;
+	return texture;
+}
+
+/**
+ * @brief Loads an image that is embedded into a model, identical images are shared by their content.
+ */
+static std::optional<std::shared_ptr<Texture>> loadEncodedTexture(const unsigned char * encoded, size_t size, const std::string & name,
+	const ImportOptions & options, const glm::vec4 & placeholder, TextureContent content)
+{
+	std::shared_ptr<Texture> texture = TextureManager::getInstance().acquireTexture(encoded, size, name, options.texture_loader, placeholder, content);
+	if (!options.texture_loader && !texture->isSuccessfullyLoaded()) return std::nullopt;
+	return texture;
+}
+
+static void generateMissingAttributes(MeshData<VertexFormat> & data, bool has_normals, bool has_tangents, bool has_uvs, const ImportOptions & options)
+{
+	if (!options.generate_attributes) return;
+	AttributeOptions attribute_options;
+	attribute_options.normals = !has_normals;
+	attribute_options.tangents = !has_tangents && has_uvs;
+	if (attribute_options.normals || attribute_options.tangents) generateNormalsAndTangents(data, attribute_options);
+}
+
+// === OBJ ===
+
+namespace {
+	/**
+	 * @brief The zero based references of a face corner, -1 if the corner has no such attribute.
+	 */
+	struct ObjCorner {
+		int position = -1;
+		int uv = -1;
+		int normal = -1;
+	};
+
+	struct ObjChunk {
+		size_t begin = 0, end = 0;
+		size_t positions = 0, uvs = 0, normals = 0, corners = 0;
+		// material switches as (corner offset inside of the chunk, material name)
+		std::vector<std::pair<size_t, std::string>> materials;
+		std::vector<std::string> libraries;
+	};
+
+	struct ObjMaterialRange {
+		size_t begin = 0, end = 0;
+	};
+}
+
+static inline bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline const char * skipSpaces(const char * p, const char * end)
+{
+	while (p < end && isSpace(*p)) p++;
+	return p;
+}
+
+static inline const char * findLineEnd(const char * p, const char * end)
+{
+	const void * found = std::memchr(p, '\n', static_cast<size_t>(end - p));
+	return found ? static_cast<const char *>(found) : end;
+}
+
+static inline const char * parseFloat(const char * p, const char * end, float & value)
+{
+	p = skipSpaces(p, end);
+	if (p < end && *p == '+') p++;
+	auto result = std::from_chars(p, end, value);
+	if (result.ec != std::errc()) value = 0.f;
+	return result.ptr;
+}
+
+static std::string readRestOfLine(const char * p, const char * end)
+{
+	p = skipSpaces(p, end);
+	while (end > p && isSpace(end[-1])) end--;
+	return std::string(p, end);
+}
+
+/**
+ * @brief Counts the vertices of a face line ("f 1/2/3 4/5/6 ...").
+ */
+static unsigned int countFaceVertices(const char * p, const char * end)
+{
+	unsigned int count = 0;
+	while (true) {
+		p = skipSpaces(p, end);
+		if (p >= end) break;
+		count++;
+		while (p < end && !isSpace(*p)) p++;
+	}
+	return count;
+}
+
+/**
+ * @brief Resolves a one based or negative (relative) OBJ reference into a zero based index.
+ */
+static inline int resolveReference(long long reference, size_t current_count)
+{
+	if (reference > 0) return static_cast<int>(reference - 1);
+	if (reference < 0) return static_cast<int>(static_cast<long long>(current_count) + reference);
+	return -1;
+}
+
+static void loadMtl(const std::string & path, const std::string & directory, const ImportOptions & options,
+	std::map<std::string, std::shared_ptr<Material>> & materials)
+{
+	std::vector<char> content;
+	try {
+		content = readWholeFile(path);
+	} catch (const std::runtime_error &) {
+		return;
+	}
+
+	const char * p = content.data();
+	const char * end = content.data() + content.size();
+	std::shared_ptr<Material> material;
+	while (p < end) {
+		const char * line_end = findLineEnd(p, end);
+		const char * q = skipSpaces(p, line_end);
+		const char * keyword_end = q;
+		while (keyword_end < line_end && !isSpace(*keyword_end)) keyword_end++;
+		std::string keyword(q, keyword_end);
+		// texture statements may contain options like "-bm 1.0", the file name is the last token
+		std::string argument = readRestOfLine(keyword_end, line_end);
+		std::string file_name = argument.substr(argument.find_last_of(" \t") == std::string::npos ? 0 : argument.find_last_of(" \t") + 1);
+
+		if (keyword == "newmtl") {
+			material = std::shared_ptr<Material>(new Material());
+			materials[argument] = material;
+		}
+		else if (material) {
+			float a = 0.f, b = 0.f, c = 0.f;
+			if (keyword == "Kd") {
+				parseFloat(parseFloat(parseFloat(keyword_end, line_end, a), line_end, b), line_end, c);
+				material->albedo.value_default = glm::vec3(a, b, c);
+			}
+			else if (keyword == "d") {
+				parseFloat(keyword_end, line_end, a);
+				material->opacity.value_default = a;
+			}
+			else if (keyword == "Tr") {
+				parseFloat(keyword_end, line_end, a);
+				material->opacity.value_default = 1.f - a;
+			}
+			else if (keyword == "Ns") {
+				// maps the Blinn-Phong exponent onto a perceptual roughness
+				parseFloat(keyword_end, line_end, a);
+				material->roughness.value_default = std::sqrt(2.f / (std::max(a, 0.f) + 2.f));
+			}
+			else if (keyword == "Pr") {
+				parseFloat(keyword_end, line_end, a);
+				material->roughness.value_default = a;
+			}
+			else if (keyword == "Pm") {
+				parseFloat(keyword_end, line_end, a);
+				material->metallic.value_default = a;
+			}
+			else if (keyword == "map_Kd") material->albedo.texture = loadTexture(directory, file_name, options, glm::vec4(1.f), TextureContent::Color);
+			else if (keyword == "map_Bump" || keyword == "map_bump" || keyword == "bump" || keyword == "norm") material->normal.texture = loadTexture(directory, file_name, options, NORMAL_PLACEHOLDER, TextureContent::Normal);
+			else if (keyword == "map_Pr") material->roughness.texture = loadTexture(directory, file_name, options);
+			else if (keyword == "map_Pm") material->metallic.texture = loadTexture(directory, file_name, options);
+			else if (keyword == "map_d") material->opacity.texture = loadTexture(directory, file_name, options);
+			else if (keyword == "map_Ka" || keyword == "map_ao") material->ao.texture = loadTexture(directory, file_name, options);
+			else if (keyword == "disp" || keyword == "map_disp") material->height.texture = loadTexture(directory, file_name, options);
+		}
+		p = line_end + 1;
+	}
+}
+
+/**
+ * @brief Builds an indexed mesh from face corners by merging corners with identical references.
+ */
+static std::shared_ptr<MeshData<VertexFormat>> buildObjMesh(const std::vector<ObjCorner> & corners, const std::vector<ObjMaterialRange> & ranges,
+	const std::vector<glm::vec3> & positions, const std::vector<glm::vec2> & uvs, const std::vector<glm::vec3> & normals,
+	const ImportOptions & options)
+{
+	std::vector<size_t> range_offsets(ranges.size() + 1, 0);
+	for (size_t r = 0; r < ranges.size(); r++) range_offsets[r + 1] = range_offsets[r] + ranges[r].end - ranges[r].begin;
+	const size_t corner_count = range_offsets.back();
+
+	// the local corner list of this mesh
+	std::vector<const ObjCorner *> local(corner_count);
+	for (size_t r = 0; r < ranges.size(); r++) {
+		for (size_t c = ranges[r].begin; c < ranges[r].end; c++) local[range_offsets[r] + c - ranges[r].begin] = &corners[c];
+	}
+
+	auto less = [&local](GLuint a, GLuint b) {
+		const ObjCorner & ca = *local[a];
+		const ObjCorner & cb = *local[b];
+		if (ca.position != cb.position) return ca.position < cb.position;
+		if (ca.uv != cb.uv) return ca.uv < cb.uv;
+		if (ca.normal != cb.normal) return ca.normal < cb.normal;
+		return a < b;
+	};
+	auto same = [&local](GLuint a, GLuint b) {
+		return local[a]->position == local[b]->position && local[a]->uv == local[b]->uv && local[a]->normal == local[b]->normal;
+	};
+
+	std::vector<GLuint> order(corner_count);
+	std::iota(order.begin(), order.end(), 0);
+	parallelSort(order.begin(), order.end(), less);
+
+	// every corner refers to the first corner with the same references, vertices keep the order of first use
+	std::vector<GLuint> first(corner_count);
+	for (size_t i = 0; i < corner_count; i++) {
+		first[order[i]] = (i > 0 && same(order[i - 1], order[i])) ? first[order[i - 1]] : order[i];
+	}
+	std::vector<GLuint> vertex_of(corner_count);
+	GLuint vertex_count = 0;
+	for (size_t c = 0; c < corner_count; c++) {
+		if (first[c] == c) vertex_of[c] = vertex_count++;
+	}
+
+	bool has_uvs = true, has_normals = true;
+	for (size_t c = 0; c < corner_count && (has_uvs || has_normals); c++) {
+		has_uvs = has_uvs && local[c]->uv >= 0;
+		has_normals = has_normals && local[c]->normal >= 0;
+	}
+
+	std::shared_ptr<MeshData<VertexFormat>> data(new MeshData<VertexFormat>());
+	data->vertices.resize(vertex_count, VertexFormat(glm::vec3(0.f), glm::vec3(0.f, 0.f, 1.f), glm::vec2(0.f), glm::vec3(1.f, 0.f, 0.f)));
+	data->indices = std::vector<GLuint>(corner_count);
+	std::vector<GLuint> & indices = data->indices.value();
+	parallelFor(0, corner_count, [&](size_t begin, size_t end) {
+		for (size_t c = begin; c < end; c++) {
+			indices[c] = first[c] == c ? vertex_of[c] : vertex_of[first[c]];
+			if (first[c] != c) continue;
+			const ObjCorner & corner = *local[c];
+			VertexFormat & vertex = data->vertices[vertex_of[c]];
+			if (corner.position >= 0 && static_cast<size_t>(corner.position) < positions.size()) vertex.position = positions[corner.position];
+			if (corner.uv >= 0 && static_cast<size_t>(corner.uv) < uvs.size()) vertex.uv = uvs[corner.uv];
+			if (corner.normal >= 0 && static_cast<size_t>(corner.normal) < normals.size()) vertex.normal = normals[corner.normal];
+		}
+	});
+
+	generateMissingAttributes(*data, has_normals, false, has_uvs, options);
+	return data;
+}
+
+ImportedModel mygl::importObj(const std::string & path, const ImportOptions & options)
+{
+	const std::vector<char> content = readWholeFile(path);
+	const char * text = content.data();
+	const char * text_end = content.data() + content.size();
+	const std::string directory = getDirectory(path);
+
+	// split into chunks at line boundaries
+	const size_t chunk_target = std::max<size_t>(1 << 20, content.size() / (getWorkerCount() * 4) + 1);
+	std::vector<ObjChunk> chunks;
+	for (size_t begin = 0; begin < content.size();) {
+		size_t end = std::min(content.size(), begin + chunk_target);
+		end = static_cast<size_t>(findLineEnd(text + end, text_end) - text);
+		end = std::min(content.size(), end + 1);
+		ObjChunk chunk;
+		chunk.begin = begin;
+		chunk.end = end;
+		chunks.push_back(chunk);
+		begin = end;
+	}
+
+	// 1. count the elements of every chunk
+	parallelFor(0, chunks.size(), [&](size_t begin, size_t end) {
+		for (size_t k = begin; k < end; k++) {
+			ObjChunk & chunk = chunks[k];
+			const char * p = text + chunk.begin;
+			const char * chunk_end = text + chunk.end;
+			while (p < chunk_end) {
+				const char * line_end = findLineEnd(p, chunk_end);
+				const char * q = skipSpaces(p, line_end);
+				if (line_end - q >= 2) {
+					if (q[0] == 'v' && isSpace(q[1])) chunk.positions++;
+					else if (q[0] == 'v' && q[1] == 't') chunk.uvs++;
+					else if (q[0] == 'v' && q[1] == 'n') chunk.normals++;
+					else if (q[0] == 'f' && isSpace(q[1])) {
+						unsigned int count = countFaceVertices(q + 1, line_end);
+						if (count >= 3) chunk.corners += (count - 2) * 3;
+					}
+					else if (line_end - q > 7 && std::strncmp(q, "usemtl", 6) == 0 && isSpace(q[6])) {
+						chunk.materials.push_back({ chunk.corners, readRestOfLine(q + 6, line_end) });
+					}
+					else if (line_end - q > 7 && std::strncmp(q, "mtllib", 6) == 0 && isSpace(q[6])) {
+						chunk.libraries.push_back(readRestOfLine(q + 6, line_end));
+					}
+				}
+				p = line_end + 1;
+			}
+		}
+	}, 1);
+
+	std::vector<size_t> position_offsets(chunks.size() + 1, 0), uv_offsets(chunks.size() + 1, 0);
+	std::vector<size_t> normal_offsets(chunks.size() + 1, 0), corner_offsets(chunks.size() + 1, 0);
+	for (size_t k = 0; k < chunks.size(); k++) {
+		position_offsets[k + 1] = position_offsets[k] + chunks[k].positions;
+		uv_offsets[k + 1] = uv_offsets[k] + chunks[k].uvs;
+		normal_offsets[k + 1] = normal_offsets[k] + chunks[k].normals;
+		corner_offsets[k + 1] = corner_offsets[k] + chunks[k].corners;
+	}
+
+	std::vector<glm::vec3> positions(position_offsets.back());
+	std::vector<glm::vec2> uvs(uv_offsets.back());
+	std::vector<glm::vec3> normals(normal_offsets.back());
+	std::vector<ObjCorner> corners(corner_offsets.back());
+
+	// 2. parse every chunk directly into its part of the arrays
+	parallelFor(0, chunks.size(), [&](size_t begin, size_t end) {
+		std::vector<ObjCorner> polygon;
+		for (size_t k = begin; k < end; k++) {
+			const ObjChunk & chunk = chunks[k];
+			size_t position = position_offsets[k], uv = uv_offsets[k], normal = normal_offsets[k], corner = corner_offsets[k];
+			const char * p = text + chunk.begin;
+			const char * chunk_end = text + chunk.end;
+			while (p < chunk_end) {
+				const char * line_end = findLineEnd(p, chunk_end);
+				const char * q = skipSpaces(p, line_end);
+				if (line_end - q >= 2) {
+					if (q[0] == 'v' && isSpace(q[1])) {
+						glm::vec3 & target = positions[position++];
+						parseFloat(parseFloat(parseFloat(q + 1, line_end, target.x), line_end, target.y), line_end, target.z);
+					}
+					else if (q[0] == 'v' && q[1] == 't') {
+						glm::vec2 & target = uvs[uv++];
+						parseFloat(parseFloat(q + 2, line_end, target.x), line_end, target.y);
+					}
+					else if (q[0] == 'v' && q[1] == 'n') {
+						glm::vec3 & target = normals[normal++];
+						parseFloat(parseFloat(parseFloat(q + 2, line_end, target.x), line_end, target.y), line_end, target.z);
+					}
+					else if (q[0] == 'f' && isSpace(q[1])) {
+						polygon.clear();
+						const char * r = q + 1;
+						while (true) {
+							r = skipSpaces(r, line_end);
+							if (r >= line_end) break;
+							long long references[3] = { 0, 0, 0 };
+							for (int slot = 0; slot < 3 && r < line_end && !isSpace(*r); slot++) {
+								if (*r != '/') {
+									if (*r == '+') r++;
+									r = std::from_chars(r, line_end, references[slot]).ptr;
+								}
+								if (r < line_end && *r == '/') r++;
+								else break;
+							}
+							while (r < line_end && !isSpace(*r)) r++;
+							ObjCorner c;
+							c.position = resolveReference(references[0], position);
+							c.uv = resolveReference(references[1], uv);
+							c.normal = resolveReference(references[2], normal);
+							polygon.push_back(c);
+						}
+						// triangulate as a fan
+						for (size_t v = 2; v < polygon.size(); v++) {
+							corners[corner++] = polygon[0];
+							corners[corner++] = polygon[v - 1];
+							corners[corner++] = polygon[v];
+						}
+					}
+				}
+				p = line_end + 1;
+			}
+		}
+	}, 1);
+
+	// materials
+	std::map<std::string, std::shared_ptr<Material>> materials;
+	for (const ObjChunk & chunk : chunks) {
+		for (const std::string & library : chunk.libraries) loadMtl(directory + library, directory, options, materials);
+	}
+
+	// group the corner ranges by material, in the order of their first use
+	std::vector<std::string> material_order;
+	std::map<std::string, std::vector<ObjMaterialRange>> material_ranges;
+	std::string current_material;
+	size_t range_begin = 0;
+	auto closeRange = [&](size_t range_end) {
+		if (range_end <= range_begin) return;
+		if (material_ranges.find(current_material) == material_ranges.end()) material_order.push_back(current_material);
+		material_ranges[current_material].push_back({ range_begin, range_end });
+	};
+	for (size_t k = 0; k < chunks.size(); k++) {
+		for (const auto & change : chunks[k].materials) {
+			closeRange(corner_offsets[k] + change.first);
+			current_material = change.second;
+			range_begin = corner_offsets[k] + change.first;
+		}
+	}
+	closeRange(corners.size());
+
+	ImportedModel model;
+	std::map<std::string, std::shared_ptr<Material>> used_materials;
+	for (const std::string & name : material_order) {
+		ImportedMesh mesh;
+		mesh.name = fs::path(path).stem().string() + (name.empty() ? "" : "_" + name);
+		mesh.data = buildObjMesh(corners, material_ranges[name], positions, uvs, normals, options);
+		auto it = materials.find(name);
+		mesh.material = it != materials.end() ? it->second : std::shared_ptr<Material>(new Material());
+		if (used_materials.insert({ name, mesh.material }).second) model.materials.push_back(mesh.material);
+		model.meshes.push_back(mesh);
+	}
+	return model;
+}
+
+// === glTF ===
+
+namespace {
+	struct GltfBufferView {
+		const unsigned char * data = nullptr;
+		size_t size = 0;
+		size_t stride = 0;
+	};
+
+	/**
+	 * @brief The memory layout of an accessor, resolved against its buffer view.
+	 */
+	struct GltfAccessor {
+		const unsigned char * data = nullptr;
+		size_t count = 0;
+		size_t stride = 0;
+		int component_type = 0;
+		int components = 0;
+		bool normalized = false;
+	};
+}
+
+static const uint32_t GLB_MAGIC = 0x46546C67;
+static const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+static const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+
+static std::vector<unsigned char> decodeBase64(const std::string & text)
+{
+	// initialized once in a thread safe way, importers may run on multiple threads
+	static const std::array<int, 256> table = []() {
+		std::array<int, 256> values;
+		values.fill(-1);
+		const char * alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		for (int i = 0; i < 64; i++) values[static_cast<unsigned char>(alphabet[i])] = i;
+		return values;
+	}();
+	std::vector<unsigned char> result;
+	result.reserve(text.size() / 4 * 3);
+	unsigned int buffer = 0;
+	int bits = 0;
+	for (char c : text) {
+		int value = table[static_cast<unsigned char>(c)];
+		if (value < 0) continue;
+		buffer = (buffer << 6) | static_cast<unsigned int>(value);
+		bits += 6;
+		if (bits >= 8) {
+			bits -= 8;
+			result.push_back(static_cast<unsigned char>((buffer >> bits) & 0xFF));
+		}
+	}
+	return result;
+}
+
+static int getComponentCount(const std::string & type)
+{
+	if (type == "SCALAR") return 1;
+	if (type == "VEC2") return 2;
+	if (type == "VEC3") return 3;
+	if (type == "VEC4") return 4;
+	if (type == "MAT2") return 4;
+	if (type == "MAT3") return 9;
+	if (type == "MAT4") return 16;
+	return 0;
+}
+
+static size_t getComponentSize(int component_type)
+{
+	switch (component_type) {
+	case GL_BYTE: case GL_UNSIGNED_BYTE: return 1;
+	case GL_SHORT: case GL_UNSIGNED_SHORT: return 2;
+	case GL_UNSIGNED_INT: case GL_FLOAT: return 4;
+	default: return 0;
+	}
+}
+
+static inline float readComponent(const unsigned char * source, int component_type, bool normalized)
+{
+	switch (component_type) {
+	case GL_FLOAT: { float v; std::memcpy(&v, source, 4); return v; }
+	case GL_UNSIGNED_BYTE: return normalized ? source[0] / 255.f : source[0];
+	case GL_BYTE: { signed char v = static_cast<signed char>(source[0]); return normalized ? std::max(v / 127.f, -1.f) : v; }
+	case GL_UNSIGNED_SHORT: { unsigned short v; std::memcpy(&v, source, 2); return normalized ? v / 65535.f : v; }
+	case GL_SHORT: { short v; std::memcpy(&v, source, 2); return normalized ? std::max(v / 32767.f, -1.f) : v; }
+	case GL_UNSIGNED_INT: { GLuint v; std::memcpy(&v, source, 4); return static_cast<float>(v); }
+	default: return 0.f;
+	}
+}
+
+static inline void readElement(const GltfAccessor & accessor, size_t element, float * target, int components)
+{
+	const unsigned char * source = accessor.data + element * accessor.stride;
+	const size_t component_size = getComponentSize(accessor.component_type);
+	for (int c = 0; c < components; c++) {
+		target[c] = c < accessor.components ? readComponent(source + c * component_size, accessor.component_type, accessor.normalized) : 0.f;
+	}
+}
+
+static glm::mat4 getNodeTransform(const JsonValue & node)
+{
+	const JsonValue & matrix = node["matrix"];
+	if (matrix.size() == 16) {
+		glm::mat4 result(1.f);
+		for (int c = 0; c < 4; c++) {
+			for (int r = 0; r < 4; r++) result[c][r] = static_cast<float>(matrix[static_cast<size_t>(c * 4 + r)].asNumber());
+		}
+		return result;
+	}
+
+	const JsonValue & t = node["translation"];
+	const JsonValue & r = node["rotation"];
+	const JsonValue & s = node["scale"];
+	glm::vec3 translation(t[size_t(0)].asNumber(0.0), t[size_t(1)].asNumber(0.0), t[size_t(2)].asNumber(0.0));
+	float x = static_cast<float>(r[size_t(0)].asNumber(0.0)), y = static_cast<float>(r[size_t(1)].asNumber(0.0));
+	float z = static_cast<float>(r[size_t(2)].asNumber(0.0)), w = static_cast<float>(r[size_t(3)].asNumber(1.0));
+	glm::vec3 scale(s[size_t(0)].asNumber(1.0), s[size_t(1)].asNumber(1.0), s[size_t(2)].asNumber(1.0));
+
+	// rotation matrix of the unit quaternion (x, y, z, w)
+	glm::mat4 rotation(1.f);
+	rotation[0] = glm::vec4(1.f - 2.f * (y * y + z * z), 2.f * (x * y + z * w), 2.f * (x * z - y * w), 0.f);
+	rotation[1] = glm::vec4(2.f * (x * y - z * w), 1.f - 2.f * (x * x + z * z), 2.f * (y * z + x * w), 0.f);
+	rotation[2] = glm::vec4(2.f * (x * z + y * w), 2.f * (y * z - x * w), 1.f - 2.f * (x * x + y * y), 0.f);
+	return glm::translate(glm::mat4(1.f), translation) * rotation * glm::scale(glm::mat4(1.f), scale);
+}
+
+namespace {
+	/**
+	 * @brief The state of a glTF import.
+	 */
+	class GltfImporter {
+	public:
+		GltfImporter(const std::string & path, const ImportOptions & options) : path(path), options(options)
+		{
+			this->directory = getDirectory(path);
+			this->file = readWholeFile(path);
+			parseContainer();
+			loadBuffers();
+		}
+
+		ImportedModel import()
+		{
+			loadMaterials();
+
+			ImportedModel model;
+			model.materials = this->materials;
+			const JsonValue & scenes = this->json["scenes"];
+			if (scenes.size() > 0) {
+				const JsonValue & scene = scenes[static_cast<size_t>(this->json["scene"].asInt(0))];
+				for (size_t n = 0; n < scene["nodes"].size(); n++) {
+					addNode(model, scene["nodes"][n].asInt(-1), glm::mat4(1.f), 0);
+				}
+			}
+			else {
+				// assets without scenes only provide their meshes
+				for (size_t m = 0; m < this->json["meshes"].size(); m++) addMesh(model, static_cast<int>(m), glm::mat4(1.f));
+			}
+			return model;
+		}
+
+	private:
+		std::string path;
+		std::string directory;
+		ImportOptions options;
+		std::vector<char> file;
+		JsonValue json;
+		const unsigned char * glb_binary = nullptr;
+		size_t glb_binary_size = 0;
+		std::vector<std::vector<unsigned char>> buffer_storage;
+		std::vector<std::pair<const unsigned char *, size_t>> buffers;
+		std::vector<std::shared_ptr<Material>> materials;
+		std::map<int, std::vector<ImportedMesh>> mesh_cache;
+
+		static const int MAX_NODE_DEPTH = 256;
+
+		[[noreturn]] void fail(const std::string & reason)
+		{
+			std::cerr << "ERROR::cannot import " << this->path << ": " << reason << std::endl;
+			throw std::runtime_error("cannot import " + this->path + ": " + reason);
+		}
+
+		void parseContainer()
+		{
+			uint32_t magic = 0;
+			if (this->file.size() >= 12) std::memcpy(&magic, this->file.data(), 4);
+			if (magic != GLB_MAGIC) {
+				this->json = JsonValue::parse(this->file.data(), this->file.size());
+				return;
+			}
+
+			// binary container: header, JSON chunk, optional BIN chunk
+			size_t offset = 12;
+			while (offset + 8 <= this->file.size()) {
+				uint32_t chunk_length = 0, chunk_type = 0;
+				std::memcpy(&chunk_length, this->file.data() + offset, 4);
+				std::memcpy(&chunk_type, this->file.data() + offset + 4, 4);
+				offset += 8;
+				if (offset + chunk_length > this->file.size()) fail("truncated chunk");
+				if (chunk_type == GLB_CHUNK_JSON) this->json = JsonValue::parse(this->file.data() + offset, chunk_length);
+				else if (chunk_type == GLB_CHUNK_BIN && !this->glb_binary) {
+					this->glb_binary = reinterpret_cast<const unsigned char *>(this->file.data() + offset);
+					this->glb_binary_size = chunk_length;
+				}
+				offset += (chunk_length + 3) & ~3u;
+			}
+			if (!this->json.isObject()) fail("missing JSON chunk");
+		}
+
+		void loadBuffers()
+		{
+			const JsonValue & buffers = this->json["buffers"];
+			this->buffer_storage.resize(buffers.size());
+			this->buffers.resize(buffers.size(), { nullptr, 0 });
+			for (size_t b = 0; b < buffers.size(); b++) {
+				const std::string uri = buffers[b]["uri"].asString();
+				if (uri.empty()) {
+					if (!this->glb_binary) fail("buffer without data");
+					this->buffers[b] = { this->glb_binary, this->glb_binary_size };
+					continue;
+				}
+				if (uri.compare(0, 5, "data:") == 0) {
+					size_t comma = uri.find(',');
+					if (comma == std::string::npos) fail("invalid data uri");
+					this->buffer_storage[b] = decodeBase64(uri.substr(comma + 1));
+				}
+				else {
+					std::vector<char> content = readWholeFile(this->directory + uri);
+					this->buffer_storage[b].assign(content.begin(), content.end());
+				}
+				this->buffers[b] = { this->buffer_storage[b].data(), this->buffer_storage[b].size() };
+			}
+		}
+
+		GltfBufferView getBufferView(int index)
+		{
+			const JsonValue & view = this->json["bufferViews"][static_cast<size_t>(index)];
+			const int buffer = view["buffer"].asInt(-1);
+			if (!view.isObject() || buffer < 0 || static_cast<size_t>(buffer) >= this->buffers.size()) fail("invalid buffer view");
+			const size_t offset = static_cast<size_t>(view["byteOffset"].asNumber(0));
+			const size_t length = static_cast<size_t>(view["byteLength"].asNumber(0));
+			if (offset + length > this->buffers[buffer].second) fail("buffer view out of range");
+			GltfBufferView result;
+			result.data = this->buffers[buffer].first + offset;
+			result.size = length;
+			result.stride = static_cast<size_t>(view["byteStride"].asNumber(0));
+			return result;
+		}
+
+		GltfAccessor getAccessor(int index)
+		{
+			const JsonValue & accessor = this->json["accessors"][static_cast<size_t>(index)];
+			if (!accessor.isObject()) fail("invalid accessor");
+			if (accessor.has("sparse")) std::cout << "WARNING::sparse accessors are not supported, " << this->path << std::endl;
+
+			GltfAccessor result;
+			result.count = static_cast<size_t>(accessor["count"].asNumber(0));
+			result.component_type = accessor["componentType"].asInt();
+			result.components = getComponentCount(accessor["type"].asString());
+			result.normalized = accessor["normalized"].asBool();
+			const size_t element_size = getComponentSize(result.component_type) * result.components;
+			if (element_size == 0) fail("invalid accessor type");
+			if (!accessor.has("bufferView")) return result;
+
+			GltfBufferView view = getBufferView(accessor["bufferView"].asInt());
+			const size_t offset = static_cast<size_t>(accessor["byteOffset"].asNumber(0));
+			result.stride = view.stride > 0 ? view.stride : element_size;
+			if (result.count > 0 && offset + (result.count - 1) * result.stride + element_size > view.size) fail("accessor out of range");
+			result.data = view.data + offset;
+			return result;
+		}
+
+		std::optional<std::shared_ptr<Texture>> loadTextureReference(const JsonValue & reference, const glm::vec4 & placeholder = glm::vec4(1.f),
+			TextureContent content = TextureContent::Linear)
+		{
+			if (!this->options.load_textures || !reference.isObject()) return std::nullopt;
+			const JsonValue & texture = this->json["textures"][static_cast<size_t>(reference["index"].asInt(-1))];
+			const JsonValue & image = this->json["images"][static_cast<size_t>(texture["source"].asInt(-1))];
+			if (!image.isObject()) return std::nullopt;
+
+			if (image.has("bufferView")) {
+				GltfBufferView view = getBufferView(image["bufferView"].asInt());
+				return loadEncodedTexture(view.data, view.size, this->path + "#" + image["name"].asString("image"), this->options, placeholder, content);
+			}
+			const std::string uri = image["uri"].asString();
+			if (uri.compare(0, 5, "data:") == 0) {
+				std::vector<unsigned char> encoded = decodeBase64(uri.substr(uri.find(',') + 1));
+				return loadEncodedTexture(encoded.data(), encoded.size(), this->path + "#" + image["name"].asString("image"), this->options, placeholder, content);
+			}
+			return loadTexture(this->directory, uri, this->options, placeholder, content);
+		}
+
+		void loadMaterials()
+		{
+			const JsonValue & materials = this->json["materials"];
+			for (size_t m = 0; m < materials.size(); m++) {
+				const JsonValue & source = materials[m];
+				const JsonValue & pbr = source["pbrMetallicRoughness"];
+				std::shared_ptr<Material> material(new Material());
+
+				const JsonValue & color = pbr["baseColorFactor"];
+				material->albedo.value_default = glm::vec3(color[size_t(0)].asNumber(1.0), color[size_t(1)].asNumber(1.0), color[size_t(2)].asNumber(1.0));
+				// opaque materials ignore the alpha channel
+				if (source["alphaMode"].asString("OPAQUE") != "OPAQUE") {
+					material->opacity.value_default = static_cast<float>(color[size_t(3)].asNumber(1.0));
+				}
+				material->metallic.value_default = static_cast<float>(pbr["metallicFactor"].asNumber(1.0));
+				material->roughness.value_default = static_cast<float>(pbr["roughnessFactor"].asNumber(1.0));
+
+				material->albedo.texture = loadTextureReference(pbr["baseColorTexture"], glm::vec4(1.f), TextureContent::Color);
+				// glTF packs roughness (G) and metallic (B) into one texture
+				material->roughness.texture = loadTextureReference(pbr["metallicRoughnessTexture"]);
+				material->metallic.texture = material->roughness.texture;
+				material->roughness.channel = PACKED_ROUGHNESS_CHANNEL;
+				material->metallic.channel = PACKED_METALLIC_CHANNEL;
+				material->normal.texture = loadTextureReference(source["normalTexture"], NORMAL_PLACEHOLDER, TextureContent::Normal);
+				material->ao.texture = loadTextureReference(source["occlusionTexture"]);
+				material->ao.channel = PACKED_AO_CHANNEL;
+				// and the opacity of blended and masked materials into the alpha of the base color
+				if (source["alphaMode"].asString("OPAQUE") != "OPAQUE" && material->albedo.texture.has_value()) {
+					material->opacity.texture = material->albedo.texture;
+					material->opacity.channel = 3;
+				}
+				this->materials.push_back(material);
+			}
+		}
+
+		ImportedMesh loadPrimitive(const JsonValue & primitive)
+		{
+			ImportedMesh mesh;
+			mesh.geometry_type = static_cast<GLenum>(primitive["mode"].asInt(GL_TRIANGLES));
+			const int material = primitive["material"].asInt(-1);
+			mesh.material = material >= 0 && static_cast<size_t>(material) < this->materials.size()
+				? this->materials[material] : std::shared_ptr<Material>(new Material());
+
+			const JsonValue & attributes = primitive["attributes"];
+			if (!attributes.has("POSITION")) fail("primitive without positions");
+			GltfAccessor positions = getAccessor(attributes["POSITION"].asInt());
+			std::optional<GltfAccessor> normals, uvs, tangents;
+			if (attributes.has("NORMAL")) normals = getAccessor(attributes["NORMAL"].asInt());
+			if (attributes.has("TEXCOORD_0")) uvs = getAccessor(attributes["TEXCOORD_0"].asInt());
+			if (attributes.has("TANGENT")) tangents = getAccessor(attributes["TANGENT"].asInt());
+
+			const size_t vertex_count = positions.count;
+			mesh.data = std::shared_ptr<MeshData<VertexFormat>>(new MeshData<VertexFormat>());
+			MeshData<VertexFormat> & data = *mesh.data;
+			data.vertices.resize(vertex_count, VertexFormat(glm::vec3(0.f), glm::vec3(0.f, 0.f, 1.f), glm::vec2(0.f), glm::vec3(1.f, 0.f, 0.f)));
+			if (!positions.data) return mesh;
+
+			parallelFor(0, vertex_count, [&](size_t begin, size_t end) {
+				float values[4];
+				for (size_t v = begin; v < end; v++) {
+					VertexFormat & vertex = data.vertices[v];
+					readElement(positions, v, values, 3);
+					vertex.position = glm::vec3(values[0], values[1], values[2]);
+					if (normals && normals->data && v < normals->count) {
+						readElement(*normals, v, values, 3);
+						vertex.normal = glm::vec3(values[0], values[1], values[2]);
+					}
+					if (uvs && uvs->data && v < uvs->count) {
+						readElement(*uvs, v, values, 2);
+						vertex.uv = glm::vec2(values[0], values[1]);
+					}
+					if (tangents && tangents->data && v < tangents->count) {
+						readElement(*tangents, v, values, 4);
+						vertex.tangent = glm::vec3(values[0], values[1], values[2]);
+					}
+				}
+			});
+
+			if (primitive.has("indices")) {
+				GltfAccessor indices = getAccessor(primitive["indices"].asInt());
+				data.indices = std::vector<GLuint>(indices.count);
+				std::vector<GLuint> & target = data.indices.value();
+				const size_t component_size = getComponentSize(indices.component_type);
+				const GLuint restart = indices.component_type == GL_UNSIGNED_BYTE ? 0xFF : indices.component_type == GL_UNSIGNED_SHORT ? 0xFFFF : RESTART_INDEX;
+				parallelFor(0, indices.count, [&](size_t begin, size_t end) {
+					for (size_t i = begin; i < end; i++) {
+						GLuint index = 0;
+						std::memcpy(&index, indices.data + i * indices.stride, component_size);
+						// out of range references would be read by the GPU, they are mapped to the first vertex
+						target[i] = index == restart && isStripGeometry(mesh.geometry_type) ? RESTART_INDEX : (index < vertex_count ? index : 0);
+					}
+				});
+				data.primitive_restart = isStripGeometry(mesh.geometry_type)
+					&& std::find(target.begin(), target.end(), RESTART_INDEX) != target.end();
+			}
+
+			if (mesh.geometry_type == GL_TRIANGLES) {
+				generateMissingAttributes(data, normals.has_value(), tangents.has_value(), uvs.has_value(), this->options);
+			}
+			return mesh;
+		}
+
+		void addMesh(ImportedModel & model, int index, const glm::mat4 & transform)
+		{
+			auto cached = this->mesh_cache.find(index);
+			if (cached == this->mesh_cache.end()) {
+				const JsonValue & mesh = this->json["meshes"][static_cast<size_t>(index)];
+				std::vector<ImportedMesh> primitives;
+				for (size_t p = 0; p < mesh["primitives"].size(); p++) {
+					ImportedMesh primitive = loadPrimitive(mesh["primitives"][p]);
+					primitive.name = mesh["name"].asString("mesh" + std::to_string(index)) + (p > 0 ? "_" + std::to_string(p) : "");
+					primitives.push_back(primitive);
+				}
+				cached = this->mesh_cache.insert({ index, primitives }).first;
+			}
+			for (ImportedMesh primitive : cached->second) {
+				primitive.transform = transform;
+				model.meshes.push_back(primitive);
+			}
+		}
+
+		void addNode(ImportedModel & model, int index, const glm::mat4 & parent, int depth)
+		{
+			const JsonValue & node = this->json["nodes"][static_cast<size_t>(index)];
+			if (!node.isObject() || depth > MAX_NODE_DEPTH) return;
+			const glm::mat4 transform = parent * getNodeTransform(node);
+			if (node.has("mesh")) addMesh(model, node["mesh"].asInt(), transform);
+			for (size_t c = 0; c < node["children"].size(); c++) addNode(model, node["children"][c].asInt(-1), transform, depth + 1);
+		}
+	};
+}
+
+ImportedModel mygl::importGltf(const std::string & path, const ImportOptions & options)
+{
+	GltfImporter importer(path, options);
+	return importer.import();
+}
+
+ImportedModel mygl::importModel(const std::string & path, const ImportOptions & options)
+{
+	std::string extension = fs::path(path).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	if (extension == ".obj") return importObj(path, options);
+	if (extension == ".gltf" || extension == ".glb") return importGltf(path, options);
+	std::cerr << "ERROR::unsupported model format " << path << std::endl;
+	throw std::runtime_error("unsupported model format " + path);
+}
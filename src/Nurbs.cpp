@@ -0,0 +1,409 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <mygl/Nurbs.hpp>
+#include <mygl/Parallel.hpp>
+
+using namespace mygl;
+
+static const int MAX_DEGREE = 16;
+
+static void checkBasis(int degree, const std::vector<double> & knots, size_t control_point_count)
+{
+	if (degree < 1 || degree > MAX_DEGREE || control_point_count <= static_cast<size_t>(degree)
+		|| knots.size() != control_point_count + degree + 1) {
+		std::cerr << "ERROR::invalid NURBS basis (degree " << degree << ", " << control_point_count << " control points, "
+			<< knots.size() << " knots)" << std::endl;
+		throw std::runtime_error("invalid NURBS basis");
+	}
+}
+
+/**
+ * @brief Evaluates the degree + 1 non-zero basis functions and their first derivatives at a parameter.
+ */
+static void evaluateBasis(int degree, const std::vector<double> & knots, size_t span, double t, double * values, double * derivatives)
+{
+	// the triangular table of basis functions (upper part) and knot differences (lower part)
+	double ndu[MAX_DEGREE + 1][MAX_DEGREE + 1];
+	double left[MAX_DEGREE + 1], right[MAX_DEGREE + 1];
+	ndu[0][0] = 1.0;
+	for (int j = 1; j <= degree; j++) {
+		left[j] = t - knots[span + 1 - j];
+		right[j] = knots[span + j] - t;
+		double saved = 0.0;
+		for (int r = 0; r < j; r++) {
+			ndu[j][r] = right[r + 1] + left[j - r];
+			const double temp = ndu[r][j - 1] / ndu[j][r];
+			ndu[r][j] = saved + right[r + 1] * temp;
+			saved = left[j - r] * temp;
+		}
+		ndu[j][j] = saved;
+	}
+
+	for (int r = 0; r <= degree; r++) {
+		values[r] = ndu[r][degree];
+		if (!derivatives) continue;
+		double d = 0.0;
+		if (r >= 1) d += ndu[r - 1][degree - 1] / ndu[degree][r - 1];
+		if (r < degree) d -= ndu[r][degree - 1] / ndu[degree][r];
+		derivatives[r] = d * degree;
+	}
+}
+
+size_t mygl::findKnotSpan(int degree, const std::vector<double> & knots, size_t control_point_count, double t)
+{
+	const size_t n = control_point_count - 1;
+	if (t >= knots[n + 1]) return n;
+	if (t <= knots[degree]) return static_cast<size_t>(degree);
+	// the last span whose first knot is <= t
+	auto it = std::upper_bound(knots.begin() + degree, knots.begin() + n + 1, t);
+	return static_cast<size_t>(it - knots.begin()) - 1;
+}
+
+BasisBatch mygl::evaluateBasisBatch(int degree, const std::vector<double> & knots, size_t control_point_count, std::span<const double> parameters)
+{
+	checkBasis(degree, knots, control_point_count);
+	const size_t width = static_cast<size_t>(degree) + 1;
+	const double domain_begin = knots[degree];
+	const double domain_end = knots[control_point_count];
+
+	BasisBatch batch;
+	batch.degree = degree;
+	batch.spans.resize(parameters.size());
+	batch.values.resize(parameters.size() * width);
+	batch.derivatives.resize(parameters.size() * width);
+	parallelFor(0, parameters.size(), [&](size_t begin, size_t end) {
+		size_t span = findKnotSpan(degree, knots, control_point_count, begin < end ? std::clamp(parameters[begin], domain_begin, domain_end) : domain_begin);
+		for (size_t k = begin; k < end; k++) {
+			const double t = std::clamp(parameters[k], domain_begin, domain_end);
+			// ascending parameters mostly stay in the span of their predecessor
+			if (!(knots[span] <= t && (t < knots[span + 1] || span == control_point_count - 1))) {
+				span = findKnotSpan(degree, knots, control_point_count, t);
+			}
+			batch.spans[k] = span;
+			evaluateBasis(degree, knots, span, t, &batch.values[k * width], &batch.derivatives[k * width]);
+		}
+	}, 256);
+	return batch;
+}
+
+std::vector<glm::dvec3> mygl::evaluateCurve(const NurbsCurve & curve, std::span<const double> parameters)
+{
+	const BasisBatch basis = evaluateBasisBatch(curve.degree, curve.knots, curve.control_points.size(), parameters);
+	const size_t width = static_cast<size_t>(curve.degree) + 1;
+	std::vector<glm::dvec3> points(parameters.size());
+	parallelFor(0, parameters.size(), [&](size_t begin, size_t end) {
+		for (size_t k = begin; k < end; k++) {
+			glm::dvec4 point(0.0);
+			const size_t first = basis.spans[k] - curve.degree;
+			for (size_t r = 0; r < width; r++) point += basis.values[k * width + r] * curve.control_points[first + r];
+			points[k] = glm::dvec3(point) / point.w;
+		}
+	}, 1024);
+	return points;
+}
+
+glm::dvec3 mygl::evaluateSurface(const NurbsSurface & surface, double u, double v)
+{
+	const size_t span_u = findKnotSpan(surface.degree_u, surface.knots_u, surface.count_u, u);
+	const size_t span_v = findKnotSpan(surface.degree_v, surface.knots_v, surface.count_v, v);
+	double basis_u[MAX_DEGREE + 1], basis_v[MAX_DEGREE + 1];
+	evaluateBasis(surface.degree_u, surface.knots_u, span_u, std::clamp(u, surface.knots_u[surface.degree_u], surface.knots_u[surface.count_u]), basis_u, nullptr);
+	evaluateBasis(surface.degree_v, surface.knots_v, span_v, std::clamp(v, surface.knots_v[surface.degree_v], surface.knots_v[surface.count_v]), basis_v, nullptr);
+
+	glm::dvec4 point(0.0);
+	for (int k = 0; k <= surface.degree_u; k++) {
+		const glm::dvec4 * row = &surface.control_points[(span_u - surface.degree_u + k) * surface.count_v + span_v - surface.degree_v];
+		glm::dvec4 partial(0.0);
+		for (int l = 0; l <= surface.degree_v; l++) partial += basis_v[l] * row[l];
+		point += basis_u[k] * partial;
+	}
+	return glm::dvec3(point) / point.w;
+}
+
+void mygl::evaluateSurfaceGrid(const NurbsSurface & surface, std::span<const double> us, std::span<const double> vs,
+	std::vector<glm::dvec3> & positions, std::vector<glm::dvec3> * normals, std::vector<glm::dvec3> * tangents)
+{
+	if (surface.control_points.size() != surface.count_u * surface.count_v) {
+		std::cerr << "ERROR::the NURBS surface has " << surface.control_points.size() << " instead of "
+			<< surface.count_u * surface.count_v << " control points" << std::endl;
+		throw std::runtime_error("invalid NURBS surface");
+	}
+	const BasisBatch basis_u = evaluateBasisBatch(surface.degree_u, surface.knots_u, surface.count_u, us);
+	const BasisBatch basis_v = evaluateBasisBatch(surface.degree_v, surface.knots_v, surface.count_v, vs);
+	const size_t width_u = static_cast<size_t>(surface.degree_u) + 1;
+	const size_t width_v = static_cast<size_t>(surface.degree_v) + 1;
+	const size_t columns = vs.size();
+
+	positions.resize(us.size() * columns);
+	if (normals) normals->resize(us.size() * columns);
+	if (tangents) tangents->resize(us.size() * columns);
+
+	parallelFor(0, us.size(), [&](size_t begin, size_t end) {
+		// the control net contracted along u, one homogeneous point (and its u-derivative) per column of control points
+		std::vector<glm::dvec4> contracted(surface.count_v), contracted_du(surface.count_v);
+		for (size_t i = begin; i < end; i++) {
+			const size_t first_u = basis_u.spans[i] - surface.degree_u;
+			const double * nu = &basis_u.values[i * width_u];
+			const double * du = &basis_u.derivatives[i * width_u];
+			for (size_t c = 0; c < surface.count_v; c++) {
+				glm::dvec4 point(0.0), derivative(0.0);
+				for (size_t k = 0; k < width_u; k++) {
+					const glm::dvec4 & control = surface.control_points[(first_u + k) * surface.count_v + c];
+					point += nu[k] * control;
+					derivative += du[k] * control;
+				}
+				contracted[c] = point;
+				contracted_du[c] = derivative;
+			}
+
+			for (size_t j = 0; j < columns; j++) {
+				const size_t first_v = basis_v.spans[j] - surface.degree_v;
+				const double * nv = &basis_v.values[j * width_v];
+				const double * dv = &basis_v.derivatives[j * width_v];
+				glm::dvec4 a(0.0), a_u(0.0), a_v(0.0);
+				for (size_t l = 0; l < width_v; l++) {
+					a += nv[l] * contracted[first_v + l];
+					a_u += nv[l] * contracted_du[first_v + l];
+					a_v += dv[l] * contracted[first_v + l];
+				}
+				// derivatives of the rational surface by the quotient rule
+				const glm::dvec3 position = glm::dvec3(a) / a.w;
+				positions[i * columns + j] = position;
+				if (!normals && !tangents) continue;
+				const glm::dvec3 s_u = (glm::dvec3(a_u) - a_u.w * position) / a.w;
+				const glm::dvec3 s_v = (glm::dvec3(a_v) - a_v.w * position) / a.w;
+				if (normals) {
+					const glm::dvec3 normal = glm::cross(s_u, s_v);
+					const double length = glm::length(normal);
+					(*normals)[i * columns + j] = length > 1e-12 ? normal / length : glm::dvec3(0.0);
+				}
+				if (tangents) {
+					const double length = glm::length(s_u);
+					(*tangents)[i * columns + j] = length > 1e-12 ? s_u / length : glm::dvec3(0.0);
+				}
+			}
+		}
+	}, std::max<size_t>(1, 1024 / std::max<size_t>(columns, 1)));
+
+	if (!normals) return;
+	// degenerate edges (e.g. the poles of a sphere) have no normal, the neighbor towards the interior is used instead
+	const size_t rows = us.size();
+	for (size_t i = 0; i < rows; i++) {
+		for (size_t j = 0; j < columns; j++) {
+			glm::dvec3 & normal = (*normals)[i * columns + j];
+			if (normal != glm::dvec3(0.0)) continue;
+			const size_t ni = i == 0 ? std::min<size_t>(1, rows - 1) : (i + 1 == rows ? i - 1 : i);
+			const size_t nj = j == 0 ? std::min<size_t>(1, columns - 1) : (j + 1 == columns ? j - 1 : j);
+			normal = (*normals)[ni * columns + j] != glm::dvec3(0.0) ? (*normals)[ni * columns + j] : (*normals)[i * columns + nj];
+		}
+	}
+}
+
+/**
+ * @brief Returns the distinct knots inside of the domain of a basis.
+ */
+static std::vector<double> getDomainKnots(int degree, const std::vector<double> & knots, size_t control_point_count)
+{
+	std::vector<double> result(knots.begin() + degree, knots.begin() + control_point_count + 1);
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+static double distanceToSegment(const glm::dvec3 & point, const glm::dvec3 & a, const glm::dvec3 & b)
+{
+	const glm::dvec3 ab = b - a;
+	const double length_squared = glm::dot(ab, ab);
+	const double t = length_squared > 0.0 ? std::clamp(glm::dot(point - a, ab) / length_squared, 0.0, 1.0) : 0.0;
+	return glm::length(point - (a + t * ab));
+}
+
+/**
+ * @brief Refines the parameters of one direction.
+ *
+ * Every knot span is split into degree parts first, so that spans that curve back to their start are not missed.
+ * Each part is then halved while the chord error of any of the probes exceeds the tolerance.
+ *
+ * @param evaluate returns the point of a probe at a parameter
+ */
+template <typename F>
+static std::vector<double> refineParameters(const std::vector<double> & domain_knots, int degree, size_t probe_count,
+	const NurbsTessellationOptions & options, F evaluate)
+{
+	std::vector<std::pair<double, double>> intervals;
+	for (size_t k = 0; k + 1 < domain_knots.size(); k++) {
+		const double step = (domain_knots[k + 1] - domain_knots[k]) / degree;
+		for (int part = 0; part < degree; part++) {
+			const double a = domain_knots[k] + part * step;
+			intervals.push_back({ a, part + 1 == degree ? domain_knots[k + 1] : a + step });
+		}
+	}
+
+	// every interval is refined on its own, the results are concatenated in order
+	std::vector<std::vector<double>> refined(intervals.size());
+	parallelFor(0, intervals.size(), [&](size_t begin, size_t end) {
+		struct Task { double a, b; unsigned int depth; };
+		std::vector<Task> stack;
+		for (size_t k = begin; k < end; k++) {
+			std::vector<double> & target = refined[k];
+			stack.assign(1, { intervals[k].first, intervals[k].second, 0 });
+			while (!stack.empty()) {
+				Task task = stack.back();
+				stack.pop_back();
+				const double middle = 0.5 * (task.a + task.b);
+				bool split = false;
+				if (task.depth < options.max_depth) {
+					for (size_t p = 0; p < probe_count && !split; p++) {
+						split = distanceToSegment(evaluate(p, middle), evaluate(p, task.a), evaluate(p, task.b)) > options.tolerance;
+					}
+				}
+				if (split) {
+					// the right half is processed after the left one, so the parameters stay ascending
+					stack.push_back({ middle, task.b, task.depth + 1 });
+					stack.push_back({ task.a, middle, task.depth + 1 });
+				}
+				else {
+					target.push_back(task.a);
+				}
+			}
+		}
+	}, 1);
+
+	std::vector<double> parameters;
+	for (const std::vector<double> & part : refined) parameters.insert(parameters.end(), part.begin(), part.end());
+	parameters.push_back(domain_knots.back());
+	return parameters;
+}
+
+static glm::dvec3 evaluateCurvePoint(const NurbsCurve & curve, double t)
+{
+	const size_t count = curve.control_points.size();
+	t = std::clamp(t, curve.knots[curve.degree], curve.knots[count]);
+	const size_t span = findKnotSpan(curve.degree, curve.knots, count, t);
+	double basis[MAX_DEGREE + 1];
+	evaluateBasis(curve.degree, curve.knots, span, t, basis, nullptr);
+	glm::dvec4 point(0.0);
+	for (int r = 0; r <= curve.degree; r++) point += basis[r] * curve.control_points[span - curve.degree + r];
+	return glm::dvec3(point) / point.w;
+}
+
+std::vector<double> mygl::refineCurveParameters(const NurbsCurve & curve, const NurbsTessellationOptions & options)
+{
+	checkBasis(curve.degree, curve.knots, curve.control_points.size());
+	const std::vector<double> domain_knots = getDomainKnots(curve.degree, curve.knots, curve.control_points.size());
+	return refineParameters(domain_knots, curve.degree, 1, options, [&curve](size_t, double t) {
+		return evaluateCurvePoint(curve, t);
+	});
+}
+
+std::shared_ptr<MeshData<VertexFormat>> mygl::tessellateCurve(const NurbsCurve & curve, const NurbsTessellationOptions & options)
+{
+	const std::vector<double> parameters = refineCurveParameters(curve, options);
+	const std::vector<glm::dvec3> points = evaluateCurve(curve, parameters);
+	const double domain_begin = parameters.front();
+	const double domain_length = std::max(parameters.back() - domain_begin, 1e-300);
+
+	std::shared_ptr<MeshData<VertexFormat>> data(new MeshData<VertexFormat>());
+	data->vertices.reserve(points.size());
+	for (size_t k = 0; k < points.size(); k++) {
+		const glm::dvec3 direction = points[std::min(k + 1, points.size() - 1)] - points[k > 0 ? k - 1 : 0];
+		const double length = glm::length(direction);
+		data->vertices.push_back(VertexFormat(glm::vec3(points[k]), glm::vec3(0.f, 0.f, 1.f),
+			glm::vec2(static_cast<float>((parameters[k] - domain_begin) / domain_length), 0.f),
+			length > 0.0 ? glm::vec3(direction / length) : glm::vec3(1.f, 0.f, 0.f)));
+	}
+	return data;
+}
+
+std::shared_ptr<MeshData<VertexFormat>> mygl::tessellateSurface(const NurbsSurface & surface, const NurbsTessellationOptions & options)
+{
+	checkBasis(surface.degree_u, surface.knots_u, surface.count_u);
+	checkBasis(surface.degree_v, surface.knots_v, surface.count_v);
+	const std::vector<double> knots_u = getDomainKnots(surface.degree_u, surface.knots_u, surface.count_u);
+	const std::vector<double> knots_v = getDomainKnots(surface.degree_v, surface.knots_v, surface.count_v);
+
+	// iso curves of the other direction probe the chord error: at every knot and in the middle of every span
+	auto getProbes = [](const std::vector<double> & knots) {
+		std::vector<double> probes;
+		for (size_t k = 0; k < knots.size(); k++) {
+			probes.push_back(knots[k]);
+			if (k + 1 < knots.size()) probes.push_back(0.5 * (knots[k] + knots[k + 1]));
+		}
+		return probes;
+	};
+	const std::vector<double> probes_u = getProbes(knots_u);
+	const std::vector<double> probes_v = getProbes(knots_v);
+
+	const std::vector<double> us = refineParameters(knots_u, surface.degree_u, probes_v.size(), options, [&](size_t p, double u) {
+		return evaluateSurface(surface, u, probes_v[p]);
+	});
+	const std::vector<double> vs = refineParameters(knots_v, surface.degree_v, probes_u.size(), options, [&](size_t p, double v) {
+		return evaluateSurface(surface, probes_u[p], v);
+	});
+
+	std::vector<glm::dvec3> positions, normals, tangents;
+	evaluateSurfaceGrid(surface, us, vs, positions, &normals, &tangents);
+
+	const size_t rows = us.size();
+	const size_t columns = vs.size();
+	const double u_begin = us.front(), u_length = std::max(us.back() - u_begin, 1e-300);
+	const double v_begin = vs.front(), v_length = std::max(vs.back() - v_begin, 1e-300);
+
+	std::shared_ptr<MeshData<VertexFormat>> data(new MeshData<VertexFormat>());
+	data->vertices.resize(positions.size(), VertexFormat(glm::vec3(0.f), glm::vec3(0.f), glm::vec2(0.f), glm::vec3(0.f)));
+	data->indices = std::vector<GLuint>((rows - 1) * (columns - 1) * 6);
+	std::vector<GLuint> & indices = data->indices.value();
+	parallelFor(0, rows, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			for (size_t j = 0; j < columns; j++) {
+				const size_t k = i * columns + j;
+				const glm::vec2 uv(static_cast<float>((us[i] - u_begin) / u_length), static_cast<float>((vs[j] - v_begin) / v_length));
+				data->vertices[k] = VertexFormat(glm::vec3(positions[k]), glm::vec3(normals[k]), uv, glm::vec3(tangents[k]));
+			}
+			if (i + 1 == rows) continue;
+			// counter-clockwise around the normal, which is the cross product of the u- and v-direction
+			GLuint * target = &indices[i * (columns - 1) * 6];
+			for (size_t j = 0; j + 1 < columns; j++) {
+				const GLuint start = static_cast<GLuint>(i * columns + j);
+				const GLuint next_v = start + 1;
+				const GLuint next_u = static_cast<GLuint>(start + columns);
+				const GLuint next_uv = next_u + 1;
+				target[0] = start;
+				target[1] = next_u;
+				target[2] = next_v;
+				target[3] = next_v;
+				target[4] = next_u;
+				target[5] = next_uv;
+				target += 6;
+			}
+		}
+	}, std::max<size_t>(1, 1024 / std::max<size_t>(columns, 1)));
+	return data;
+}
+
+Bounds mygl::calculateControlBounds(const NurbsSurface & surface)
+{
+	Bounds bounds;
+	if (surface.control_points.empty()) return bounds;
+	glm::dvec3 minimum(std::numeric_limits<double>::max()), maximum(-std::numeric_limits<double>::max());
+	for (const glm::dvec4 & control : surface.control_points) {
+		const glm::dvec3 point = glm::dvec3(control) / control.w;
+		minimum = glm::min(minimum, point);
+		maximum = glm::max(maximum, point);
+	}
+	bounds.min = glm::vec3(minimum);
+	bounds.max = glm::vec3(maximum);
+	bounds.center = 0.5f * (bounds.min + bounds.max);
+	bounds.radius = 0.5f * glm::length(bounds.max - bounds.min);
+	return bounds;
+}
+
+double mygl::calculateScreenTolerance(const Bounds & bounds, const glm::vec3 & camera_position, float fov_y, float viewport_height, float pixel_error)
+{
+	// the nearest point of the bounding sphere determines the finest tolerance that is needed
+	const double distance = std::max(static_cast<double>(glm::length(camera_position - bounds.center) - bounds.radius), 1e-3);
+	const double pixel_size = 2.0 * distance * std::tan(0.5 * fov_y) / std::max(viewport_height, 1.f);
+	return pixel_error * pixel_size;
+}
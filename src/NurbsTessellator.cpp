@@ -0,0 +1,138 @@
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <mygl/NurbsTessellator.hpp>
+
+using namespace mygl;
+
+NurbsTessellator::NurbsTessellator(size_t max_cached_tessellations)
+{
+	this->max_cached_tessellations = std::max<size_t>(max_cached_tessellations, 1);
+	this->worker = std::thread(&NurbsTessellator::run, this);
+}
+
+NurbsTessellator::~NurbsTessellator()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+		this->jobs.clear();
+	}
+	this->condition.notify_all();
+	this->worker.join();
+}
+
+int NurbsTessellator::quantizeTolerance(double tolerance)
+{
+	tolerance = std::max(tolerance, 1e-12);
+	return static_cast<int>(std::floor(2.0 * std::log2(tolerance)));
+}
+
+double NurbsTessellator::getStepTolerance(int step)
+{
+	return std::exp2(0.5 * step);
+}
+
+std::shared_ptr<MeshData<VertexFormat>> NurbsTessellator::request(std::shared_ptr<const NurbsSurface> surface, double tolerance)
+{
+	const Key key(surface.get(), quantizeTolerance(tolerance));
+	std::lock_guard<std::mutex> lock(this->mutex);
+	auto it = this->cache.find(key);
+	if (it != this->cache.end()) {
+		it->second.last_use = ++this->use_counter;
+		return it->second.mesh;
+	}
+
+	if (this->pending.insert(key).second) {
+		this->jobs.push_back({ key, surface });
+		this->condition.notify_one();
+	}
+
+	// the tessellation of the same surface with the nearest tolerance bridges the time until the job is done
+	std::shared_ptr<MeshData<VertexFormat>> nearest;
+	int nearest_distance = std::numeric_limits<int>::max();
+	for (auto entry = this->cache.lower_bound(Key(key.first, std::numeric_limits<int>::min()));
+		entry != this->cache.end() && entry->first.first == key.first; entry++) {
+		const int distance = std::abs(entry->first.second - key.second);
+		if (distance < nearest_distance) {
+			nearest_distance = distance;
+			nearest = entry->second.mesh;
+		}
+	}
+	return nearest;
+}
+
+std::shared_ptr<MeshData<VertexFormat>> NurbsTessellator::tessellate(std::shared_ptr<const NurbsSurface> surface, double tolerance)
+{
+	const Key key(surface.get(), quantizeTolerance(tolerance));
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		auto it = this->cache.find(key);
+		if (it != this->cache.end()) {
+			it->second.last_use = ++this->use_counter;
+			return it->second.mesh;
+		}
+	}
+	NurbsTessellationOptions options;
+	options.tolerance = getStepTolerance(key.second);
+	std::shared_ptr<MeshData<VertexFormat>> mesh = tessellateSurface(*surface, options);
+	insert(key, surface, mesh);
+	return mesh;
+}
+
+void NurbsTessellator::evict(const NurbsSurface * surface)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	auto entry = this->cache.lower_bound(Key(surface, std::numeric_limits<int>::min()));
+	while (entry != this->cache.end() && entry->first.first == surface) entry = this->cache.erase(entry);
+}
+
+size_t NurbsTessellator::getPendingCount()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->pending.size();
+}
+
+void NurbsTessellator::insert(const Key & key, std::shared_ptr<const NurbsSurface> surface, std::shared_ptr<MeshData<VertexFormat>> mesh)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	Entry & entry = this->cache[key];
+	entry.surface = surface;
+	entry.mesh = mesh;
+	entry.last_use = ++this->use_counter;
+
+	while (this->cache.size() > this->max_cached_tessellations) {
+		auto oldest = this->cache.begin();
+		for (auto it = this->cache.begin(); it != this->cache.end(); it++) {
+			if (it->second.last_use < oldest->second.last_use) oldest = it;
+		}
+		this->cache.erase(oldest);
+	}
+}
+
+void NurbsTessellator::run()
+{
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->condition.wait(lock, [this]() { return this->stopping || !this->jobs.empty(); });
+			if (this->stopping) return;
+			job = this->jobs.front();
+			this->jobs.pop_front();
+		}
+
+		std::shared_ptr<MeshData<VertexFormat>> mesh;
+		try {
+			NurbsTessellationOptions options;
+			options.tolerance = getStepTolerance(job.key.second);
+			mesh = tessellateSurface(*job.surface, options);
+		} catch (const std::exception & e) {
+			std::cerr << "ERROR::NURBS tessellation failed: " << e.what() << std::endl;
+		}
+
+		if (mesh) insert(job.key, job.surface, mesh);
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->pending.erase(job.key);
+	}
+}
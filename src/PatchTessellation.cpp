@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <mygl/PatchTessellation.hpp>
+
+using namespace mygl;
+
+/**
+ * @brief Returns the side length of a square grid of control points, or 0 if the count is not a square of at least 3.
+ */
+static GLint getGridSize(GLint patch_vertices)
+{
+	const GLint size = static_cast<GLint>(std::lround(std::sqrt(static_cast<double>(patch_vertices))));
+	return size >= 3 && size * size == patch_vertices ? size : 0;
+}
+
+/**
+ * @brief Returns the control points at the corners of a patch, in the order in which they span the edges of the domain.
+ *
+ * Quads are ordered (0, 0), (1, 0), (1, 1), (0, 1) in the coordinates of the evaluation shader.
+ */
+static std::vector<GLint> getPatchCorners(GLint patch_vertices, PatchDomain domain)
+{
+	if (domain == PatchDomain::Triangles) return { 0, 1, 2 };
+	const GLint size = getGridSize(patch_vertices);
+	if (size == 0) return { 0, 1, 2, 3 };
+	return { 0, size - 1, size * size - 1, size * (size - 1) };
+}
+
+size_t mygl::getPatchCount(size_t vertex_count, size_t index_count, GLint patch_vertices)
+{
+	if (patch_vertices <= 0) return 0;
+	return (index_count > 0 ? index_count : vertex_count) / static_cast<size_t>(patch_vertices);
+}
+
+size_t mygl::calculatePatchTessellationFactors(std::span<const glm::vec3> positions, std::span<const GLuint> indices,
+	GLint patch_vertices, PatchDomain domain, const glm::mat4 & model, const glm::mat4 & view, const glm::mat4 & projection,
+	const glm::vec2 & viewport, const PatchTessellationOptions & options, std::span<PatchTessellationFactors> factors)
+{
+	const size_t patch_count = getPatchCount(positions.size(), indices.size(), patch_vertices);
+	if (factors.size() < patch_count)
+	{
+		std::cerr << "ERROR::PATCH_TESSELLATION::the factors cannot hold " << patch_count << " patches" << std::endl;
+		throw std::runtime_error("the factors cannot hold all patches");
+	}
+
+	const std::vector<GLint> corners = getPatchCorners(patch_vertices, domain);
+	const glm::mat4 model_view = view * model;
+	const glm::mat4 model_view_projection = projection * model_view;
+	// perspective projections divide by the depth, orthographic ones keep w = 1
+	const bool perspective = projection[2][3] != 0.f;
+	const float pixels_per_unit = projection[1][1] * 0.5f * viewport.y / std::max(options.pixels_per_segment, 1e-3f);
+	const float max_level = std::max(options.max_level, options.min_level);
+
+	auto getLevel = [&](const glm::vec3 & a, const glm::vec3 & b) {
+		const float diameter = glm::length(b - a);
+		const float distance = perspective ? std::max(glm::length(0.5f * (a + b)), 1e-6f) : 1.f;
+		return std::clamp(diameter * pixels_per_unit / distance, options.min_level, max_level);
+	};
+
+	std::vector<size_t> culled_per_patch(options.cull ? patch_count : 0);
+	parallelFor(0, patch_count, [&](size_t begin, size_t end) {
+		glm::vec3 corner_positions[4];
+		for (size_t p = begin; p < end; p++) {
+			const size_t first = p * static_cast<size_t>(patch_vertices);
+			auto getVertex = [&](size_t i) -> size_t { return indices.empty() ? first + i : indices[first + i]; };
+			PatchTessellationFactors & result = factors[p];
+
+			if (options.cull) {
+				// the patch lies inside of the convex hull of its control points
+				unsigned int outside_all = 0x3f;
+				for (GLint i = 0; i < patch_vertices && outside_all != 0; i++) {
+					const glm::vec4 clip = model_view_projection * glm::vec4(positions[getVertex(i)], 1.f);
+					unsigned int outside = 0;
+					if (clip.x < -clip.w) outside |= 0x01;
+					if (clip.x > clip.w) outside |= 0x02;
+					if (clip.y < -clip.w) outside |= 0x04;
+					if (clip.y > clip.w) outside |= 0x08;
+					if (clip.z < -clip.w) outside |= 0x10;
+					if (clip.z > clip.w) outside |= 0x20;
+					outside_all &= outside;
+				}
+				if (outside_all != 0) {
+					result.outer = glm::vec4(0.f);
+					result.inner = glm::vec2(0.f);
+					culled_per_patch[p] = 1;
+					continue;
+				}
+			}
+
+			// the levels are measured in view space, where the camera sits at the origin
+			for (size_t c = 0; c < corners.size(); c++) {
+				corner_positions[c] = glm::vec3(model_view * glm::vec4(positions[getVertex(corners[c])], 1.f));
+			}
+
+			if (domain == PatchDomain::Triangles) {
+				// outer level i belongs to the edge opposite of corner i
+				result.outer = glm::vec4(getLevel(corner_positions[1], corner_positions[2]),
+					getLevel(corner_positions[2], corner_positions[0]),
+					getLevel(corner_positions[0], corner_positions[1]), 0.f);
+				const float inner = std::max({ result.outer.x, result.outer.y, result.outer.z });
+				result.inner = glm::vec2(inner, 0.f);
+			}
+			else {
+				// outer levels of the edges u = 0, v = 0, u = 1 and v = 1
+				result.outer = glm::vec4(getLevel(corner_positions[0], corner_positions[3]),
+					getLevel(corner_positions[0], corner_positions[1]),
+					getLevel(corner_positions[1], corner_positions[2]),
+					getLevel(corner_positions[3], corner_positions[2]));
+				result.inner = glm::vec2(std::max(result.outer.y, result.outer.w), std::max(result.outer.x, result.outer.z));
+			}
+			result.padding = glm::vec2(0.f);
+		}
+	}, 256);
+
+	size_t culled = 0;
+	for (size_t value : culled_per_patch) culled += value;
+	return culled;
+}
+
+PatchTessellator::PatchTessellator(size_t patch_capacity, const PatchTessellationOptions & options)
+{
+	this->options = options;
+	this->patch_capacity = std::max<size_t>(patch_capacity, 1);
+	this->buffer = std::make_unique<StreamBuffer>(sizeof(PatchTessellationFactors) * this->patch_capacity);
+}
+
+void PatchTessellator::update(std::span<const glm::vec3> positions, std::span<const GLuint> indices, GLint patch_vertices,
+	PatchDomain domain, const glm::mat4 & model, const glm::mat4 & view, const glm::mat4 & projection, const glm::vec2 & viewport)
+{
+	checkPatchVertices(patch_vertices, domain);
+	const size_t patch_count = mygl::getPatchCount(positions.size(), indices.size(), patch_vertices);
+	if (patch_count > this->patch_capacity) {
+		// regions that are still in use are waited for by the destructor of the old buffer
+		while (this->patch_capacity < patch_count) this->patch_capacity *= 2;
+		this->buffer.reset();
+		this->buffer = std::make_unique<StreamBuffer>(sizeof(PatchTessellationFactors) * this->patch_capacity);
+	}
+
+	PatchTessellationFactors * target = static_cast<PatchTessellationFactors *>(this->buffer->beginWrite());
+	this->patch_count = patch_count;
+	this->culled_count = calculatePatchTessellationFactors(positions, indices, patch_vertices, domain, model, view, projection,
+		viewport, this->options, std::span<PatchTessellationFactors>(target, patch_count));
+}
+
+void PatchTessellator::bind(GLuint binding)
+{
+	if (this->patch_count == 0) return;
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, this->buffer->getID(),
+		static_cast<GLintptr>(this->buffer->getCurrentOffset()),
+		static_cast<GLsizeiptr>(sizeof(PatchTessellationFactors) * this->patch_count));
+}
+
+void PatchTessellator::fence()
+{
+	this->buffer->fenceCurrentRegion();
+}
+
+size_t PatchTessellator::getPatchCount()
+{
+	return this->patch_count;
+}
+
+size_t PatchTessellator::getCulledCount()
+{
+	return this->culled_count;
+}
+
+void PatchTessellator::setOptions(const PatchTessellationOptions & options)
+{
+	this->options = options;
+}
+
+PatchTessellationOptions PatchTessellator::getOptions()
+{
+	return this->options;
+}
+
+void PatchTessellator::checkPatchVertices(GLint patch_vertices, PatchDomain domain)
+{
+	const bool valid = domain == PatchDomain::Triangles ? patch_vertices == 3 : (patch_vertices == 4 || getGridSize(patch_vertices) > 0);
+	if (!valid)
+	{
+		std::cerr << "ERROR::PATCH_TESSELLATION::unsupported number of control points " << patch_vertices << std::endl;
+		throw std::runtime_error("unsupported number of patch control points");
+	}
+}
+
+// === built-in shaders ===
+
+static const char * PATCH_VERTEX_SHADER = R"(#version 460 core
+layout (location = 0) in vec3 vertex_position;
+layout (location = 1) in vec3 vertex_normal;
+layout (location = 2) in vec2 vertex_uv;
+layout (location = 3) in vec3 vertex_tangent;
+
+uniform mat4 model;
+
+out vec3 control_normal;
+out vec2 control_uv;
+out vec3 control_tangent;
+
+void main()
+{
+	gl_Position = model * vec4(vertex_position, 1.0);
+	control_normal = transpose(inverse(mat3(model))) * vertex_normal;
+	control_uv = vertex_uv;
+	control_tangent = mat3(model) * vertex_tangent;
+}
+)";
+
+static const char * PATCH_CONTROL_SHADER_BODY = R"(
+struct PatchFactors {
+	vec4 outer;
+	vec2 inner;
+};
+
+layout (std430, binding = PATCH_BINDING) readonly buffer PatchTessellationFactors {
+	PatchFactors factors[];
+};
+
+in vec3 control_normal[];
+in vec2 control_uv[];
+in vec3 control_tangent[];
+
+out vec3 evaluation_normal[];
+out vec2 evaluation_uv[];
+out vec3 evaluation_tangent[];
+
+void main()
+{
+	gl_out[gl_InvocationID].gl_Position = gl_in[gl_InvocationID].gl_Position;
+	evaluation_normal[gl_InvocationID] = control_normal[gl_InvocationID];
+	evaluation_uv[gl_InvocationID] = control_uv[gl_InvocationID];
+	evaluation_tangent[gl_InvocationID] = control_tangent[gl_InvocationID];
+
+	if (gl_InvocationID == 0) {
+		PatchFactors patch_factors = factors[gl_PrimitiveID];
+		gl_TessLevelOuter[0] = patch_factors.outer.x;
+		gl_TessLevelOuter[1] = patch_factors.outer.y;
+		gl_TessLevelOuter[2] = patch_factors.outer.z;
+		gl_TessLevelOuter[3] = patch_factors.outer.w;
+		gl_TessLevelInner[0] = patch_factors.inner.x;
+		gl_TessLevelInner[1] = patch_factors.inner.y;
+	}
+}
+)";
+
+static const char * PATCH_EVALUATION_SHADER_HEADER = R"(
+in vec3 evaluation_normal[];
+in vec2 evaluation_uv[];
+in vec3 evaluation_tangent[];
+
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec3 position;
+out vec3 normal;
+out vec2 uv;
+out vec3 tangent;
+)";
+
+static const char * PATCH_EVALUATION_SHADER_TRIANGLES = R"(
+void main()
+{
+	const vec3 b = gl_TessCoord;
+	vec4 world = b.x * gl_in[0].gl_Position + b.y * gl_in[1].gl_Position + b.z * gl_in[2].gl_Position;
+	position = world.xyz;
+	normal = normalize(b.x * evaluation_normal[0] + b.y * evaluation_normal[1] + b.z * evaluation_normal[2]);
+	uv = b.x * evaluation_uv[0] + b.y * evaluation_uv[1] + b.z * evaluation_uv[2];
+	tangent = normalize(b.x * evaluation_tangent[0] + b.y * evaluation_tangent[1] + b.z * evaluation_tangent[2]);
+	gl_Position = projection * view * world;
+}
+)";
+
+static const char * PATCH_EVALUATION_SHADER_QUADS = R"(
+void main()
+{
+	const float u = gl_TessCoord.x;
+	const float v = gl_TessCoord.y;
+	const float w[4] = float[4]((1.0 - u) * (1.0 - v), u * (1.0 - v), u * v, (1.0 - u) * v);
+	vec4 world = vec4(0.0);
+	vec3 n = vec3(0.0);
+	vec2 t = vec2(0.0);
+	vec3 s = vec3(0.0);
+	for (int i = 0; i < 4; i++) {
+		world += w[i] * gl_in[i].gl_Position;
+		n += w[i] * evaluation_normal[i];
+		t += w[i] * evaluation_uv[i];
+		s += w[i] * evaluation_tangent[i];
+	}
+	position = world.xyz;
+	normal = normalize(n);
+	uv = t;
+	tangent = normalize(s);
+	gl_Position = projection * view * world;
+}
+)";
+
+static const char * PATCH_EVALUATION_SHADER_BEZIER = R"(
+void bernstein(float t, out float b[PATCH_SIZE])
+{
+	// de Casteljau style recursion, avoids pow(0, 0)
+	b[0] = 1.0;
+	for (int degree = 1; degree < PATCH_SIZE; degree++) {
+		float carry = 0.0;
+		for (int i = 0; i < degree; i++) {
+			const float value = b[i];
+			b[i] = carry + (1.0 - t) * value;
+			carry = t * value;
+		}
+		b[degree] = carry;
+	}
+}
+
+void main()
+{
+	float bu[PATCH_SIZE];
+	float bv[PATCH_SIZE];
+	bernstein(gl_TessCoord.x, bu);
+	bernstein(gl_TessCoord.y, bv);
+	vec4 world = vec4(0.0);
+	vec3 n = vec3(0.0);
+	vec2 t = vec2(0.0);
+	vec3 s = vec3(0.0);
+	for (int j = 0; j < PATCH_SIZE; j++) {
+		for (int i = 0; i < PATCH_SIZE; i++) {
+			const int k = j * PATCH_SIZE + i;
+			const float w = bu[i] * bv[j];
+			world += w * gl_in[k].gl_Position;
+			n += w * evaluation_normal[k];
+			t += w * evaluation_uv[k];
+			s += w * evaluation_tangent[k];
+		}
+	}
+	position = world.xyz;
+	normal = normalize(n);
+	uv = t;
+	tangent = normalize(s);
+	gl_Position = projection * view * world;
+}
+)";
+
+std::string PatchTessellator::getVertexShaderSource()
+{
+	return PATCH_VERTEX_SHADER;
+}
+
+std::string PatchTessellator::getControlShaderSource(GLint patch_vertices, GLuint binding)
+{
+	return "#version 460 core\n"
+		"#define PATCH_BINDING " + std::to_string(binding) + "\n"
+		"layout (vertices = " + std::to_string(patch_vertices) + ") out;\n"
+		+ PATCH_CONTROL_SHADER_BODY;
+}
+
+std::string PatchTessellator::getEvaluationShaderSource(GLint patch_vertices, PatchDomain domain)
+{
+	checkPatchVertices(patch_vertices, domain);
+	// fractional spacing lets the levels change continuously while the camera moves
+	std::string source = "#version 460 core\n";
+	if (domain == PatchDomain::Triangles) {
+		return source + "layout (triangles, fractional_odd_spacing, ccw) in;\n" + PATCH_EVALUATION_SHADER_HEADER + PATCH_EVALUATION_SHADER_TRIANGLES;
+	}
+	source += "layout (quads, fractional_odd_spacing, ccw) in;\n";
+	const GLint size = getGridSize(patch_vertices);
+	if (size == 0) return source + PATCH_EVALUATION_SHADER_HEADER + PATCH_EVALUATION_SHADER_QUADS;
+	return source + "#define PATCH_SIZE " + std::to_string(size) + "\n" + PATCH_EVALUATION_SHADER_HEADER + PATCH_EVALUATION_SHADER_BEZIER;
+}
+
+std::shared_ptr<Shader> PatchTessellator::createShader(const std::string & fragment_source, GLint patch_vertices, PatchDomain domain,
+	eBuildinTargetShaderMode mode)
+{
+	return std::make_shared<Shader>(std::map<GLenum, std::string>{
+		{ GL_VERTEX_SHADER, getVertexShaderSource() },
+		{ GL_TESS_CONTROL_SHADER, getControlShaderSource(patch_vertices) },
+		{ GL_TESS_EVALUATION_SHADER, getEvaluationShaderSource(patch_vertices, domain) },
+		{ GL_FRAGMENT_SHADER, fragment_source }
+	}, mode);
+}
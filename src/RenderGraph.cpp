@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <mygl/RenderGraph.hpp>
+#include <mygl/SamplerCache.hpp>
+
+using namespace mygl;
+
+namespace {
+	[[noreturn]] void fail(const std::string & message)
+	{
+		std::cerr << "ERROR::render graph: " << message << std::endl;
+		throw std::runtime_error(message);
+	}
+}
+
+bool RenderTargetDescription::isDepth() const
+{
+	switch (this->internal_format) {
+	case GL_DEPTH_COMPONENT16: case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32: case GL_DEPTH_COMPONENT32F:
+	case GL_DEPTH24_STENCIL8: case GL_DEPTH32F_STENCIL8:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool RenderTargetDescription::operator < (const RenderTargetDescription & other) const
+{
+	return std::tie(this->width, this->height, this->internal_format) < std::tie(other.width, other.height, other.internal_format);
+}
+
+bool RenderTargetDescription::operator == (const RenderTargetDescription & other) const
+{
+	return this->width == other.width && this->height == other.height && this->internal_format == other.internal_format;
+}
+
+GLuint RenderPassContext::getTexture(size_t resource) const
+{
+	return this->graph.getTexture(resource);
+}
+
+void RenderPassContext::bindTexture(size_t resource, GLenum textureUnit) const
+{
+	// the targets have a single level and are sampled without repetition
+	SamplerDescription sampler;
+	sampler.min_filter = GL_LINEAR;
+	sampler.wrap_s = GL_CLAMP_TO_EDGE;
+	sampler.wrap_t = GL_CLAMP_TO_EDGE;
+	sampler.max_anisotropy = 1.f;
+	glBindTextureUnit(textureUnit - GL_TEXTURE0, this->graph.getTexture(resource));
+	glBindSampler(textureUnit - GL_TEXTURE0, SamplerCache::getInstance().getSampler(sampler));
+}
+
+FrameBuffer * RenderPassContext::getFrameBuffer() const
+{
+	return this->frame_buffer;
+}
+
+RenderGraph::~RenderGraph()
+{
+	// the framebuffers reference the textures, so they are deleted first
+	this->frame_buffers.clear();
+	for (Allocation & allocation : this->allocations) glDeleteTextures(1, &allocation.texture);
+}
+
+size_t RenderGraph::createTexture(const std::string & name, const RenderTargetDescription & description)
+{
+	Resource resource;
+	resource.name = name;
+	resource.description = description;
+	this->resources.push_back(resource);
+	this->compiled = false;
+	return this->resources.size() - 1;
+}
+
+size_t RenderGraph::importTexture(const std::string & name, GLuint texture, const RenderTargetDescription & description)
+{
+	Resource resource;
+	resource.name = name;
+	resource.description = description;
+	resource.imported = texture;
+	this->resources.push_back(resource);
+	this->compiled = false;
+	return this->resources.size() - 1;
+}
+
+void RenderGraph::markOutput(size_t resource)
+{
+	checkResource(resource);
+	this->resources[resource].output = true;
+	this->compiled = false;
+}
+
+size_t RenderGraph::addPass(const std::string & name, const std::vector<size_t> & reads, const std::vector<size_t> & writes, execute_t execute,
+	bool side_effect)
+{
+	const size_t index = this->passes.size();
+	size_t depth_count = 0;
+	for (size_t w = 0; w < writes.size(); w++) {
+		const size_t resource = writes[w];
+		checkResource(resource);
+		const Resource & target = this->resources[resource];
+		if (std::find(writes.begin(), writes.begin() + w, resource) != writes.begin() + w) fail("pass " + name + " writes " + target.name + " twice");
+		if (target.writer != NONE) fail("pass " + name + " writes " + target.name + ", which is already written by " + this->passes[target.writer].name);
+		if (std::find(reads.begin(), reads.end(), resource) != reads.end()) fail("pass " + name + " reads and writes " + target.name);
+		if (!(target.description.width == this->resources[writes[0]].description.width
+			&& target.description.height == this->resources[writes[0]].description.height)) fail("the targets of pass " + name + " differ in size");
+		if (target.description.isDepth()) depth_count++;
+	}
+	if (depth_count > 1) fail("pass " + name + " writes more than one depth target");
+	for (size_t resource : reads) checkResource(resource);
+
+	Pass pass;
+	pass.name = name;
+	pass.reads = reads;
+	pass.writes = writes;
+	pass.execute = std::move(execute);
+	pass.side_effect = side_effect;
+	for (size_t resource : writes) this->resources[resource].writer = index;
+	for (size_t resource : reads) this->resources[resource].readers.push_back(index);
+	this->passes.push_back(std::move(pass));
+	this->compiled = false;
+	return index;
+}
+
+void RenderGraph::compile()
+{
+	cull();
+	for (const Pass & pass : this->passes) {
+		if (pass.culled) continue;
+		for (size_t resource : pass.reads) {
+			const Resource & source = this->resources[resource];
+			if (!source.imported.has_value() && source.writer == NONE) fail("pass " + pass.name + " reads " + source.name + ", which is never written");
+		}
+	}
+	sort();
+	allocate();
+	createFrameBuffers();
+	this->compiled = true;
+}
+
+void RenderGraph::cull()
+{
+	// a resource is used by its readers and by the application if it is kept after the frame, a pass by the resources
+	// it writes; passes whose resources are all unused are culled, which may leave their own inputs unused
+	std::vector<size_t> pass_references(this->passes.size());
+	std::vector<size_t> resource_references(this->resources.size());
+	std::vector<size_t> unused;
+	for (size_t r = 0; r < this->resources.size(); r++) {
+		const Resource & resource = this->resources[r];
+		resource_references[r] = resource.readers.size() + (resource.output || resource.imported.has_value() ? 1 : 0);
+		if (resource_references[r] == 0) unused.push_back(r);
+	}
+
+	auto cullPass = [&](size_t p) {
+		this->passes[p].culled = true;
+		for (size_t resource : this->passes[p].reads) {
+			if (--resource_references[resource] == 0) unused.push_back(resource);
+		}
+	};
+	for (size_t p = 0; p < this->passes.size(); p++) {
+		this->passes[p].culled = false;
+		pass_references[p] = this->passes[p].writes.size();
+	}
+	for (size_t p = 0; p < this->passes.size(); p++) {
+		if (pass_references[p] == 0 && !this->passes[p].side_effect) cullPass(p);
+	}
+
+	while (!unused.empty()) {
+		const size_t writer = this->resources[unused.back()].writer;
+		unused.pop_back();
+		if (writer == NONE || this->passes[writer].culled) continue;
+		if (--pass_references[writer] == 0 && !this->passes[writer].side_effect) cullPass(writer);
+	}
+}
+
+void RenderGraph::sort()
+{
+	// passes run after the writers of their inputs, otherwise in the order they were added
+	std::vector<size_t> pending(this->passes.size(), 0);
+	std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+	size_t live_count = 0;
+	for (size_t p = 0; p < this->passes.size(); p++) {
+		if (this->passes[p].culled) continue;
+		live_count++;
+		for (size_t resource : this->passes[p].reads) {
+			if (this->resources[resource].writer != NONE) pending[p]++;
+		}
+		if (pending[p] == 0) ready.push(p);
+	}
+
+	this->order.clear();
+	while (!ready.empty()) {
+		const size_t p = ready.top();
+		ready.pop();
+		this->order.push_back(p);
+		for (size_t resource : this->passes[p].writes) {
+			for (size_t reader : this->resources[resource].readers) {
+				if (!this->passes[reader].culled && --pending[reader] == 0) ready.push(reader);
+			}
+		}
+	}
+	if (this->order.size() != live_count) fail("the passes depend on each other in a cycle");
+}
+
+void RenderGraph::allocate()
+{
+	std::vector<size_t> position(this->passes.size(), NONE);
+	for (size_t i = 0; i < this->order.size(); i++) position[this->order[i]] = i;
+
+	// the lifetime of a transient resource spans from its writer to its last reader, outputs live until the end
+	struct Lifetime {
+		size_t resource;
+		size_t first;
+		size_t last;
+	};
+	std::vector<Lifetime> lifetimes;
+	for (size_t r = 0; r < this->resources.size(); r++) {
+		Resource & resource = this->resources[r];
+		resource.allocation = NONE;
+		if (resource.imported.has_value() || resource.writer == NONE || this->passes[resource.writer].culled) continue;
+		Lifetime lifetime = { r, position[resource.writer], position[resource.writer] };
+		for (size_t reader : resource.readers) {
+			if (!this->passes[reader].culled) lifetime.last = std::max(lifetime.last, position[reader]);
+		}
+		if (resource.output) lifetime.last = this->order.size();
+		lifetimes.push_back(lifetime);
+	}
+	std::sort(lifetimes.begin(), lifetimes.end(), [](const Lifetime & a, const Lifetime & b) {
+		return a.first < b.first || (a.first == b.first && a.resource < b.resource);
+	});
+
+	// a texture is free for a resource that is written after the last use of the previous one
+	for (Allocation & allocation : this->allocations) allocation.last_use = NONE;
+	for (const Lifetime & lifetime : lifetimes) {
+		Resource & resource = this->resources[lifetime.resource];
+		size_t found = NONE;
+		for (size_t a = 0; a < this->allocations.size() && found == NONE; a++) {
+			const Allocation & allocation = this->allocations[a];
+			if (allocation.description == resource.description && (allocation.last_use == NONE || allocation.last_use < lifetime.first)) found = a;
+		}
+		if (found == NONE) {
+			Allocation allocation;
+			allocation.description = resource.description;
+			glCreateTextures(GL_TEXTURE_2D, 1, &allocation.texture);
+			glTextureStorage2D(allocation.texture, 1, resource.description.internal_format, resource.description.width, resource.description.height);
+			// the default state would sample missing mipmaps and repeat when an output is read without bindTexture
+			glTextureParameteri(allocation.texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTextureParameteri(allocation.texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(allocation.texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(allocation.texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			this->allocations.push_back(allocation);
+			found = this->allocations.size() - 1;
+		}
+		this->allocations[found].last_use = lifetime.last;
+		resource.allocation = found;
+	}
+
+	// textures of an earlier compilation that are not needed anymore are released
+	std::vector<size_t> remap(this->allocations.size(), NONE);
+	std::vector<Allocation> kept;
+	for (size_t a = 0; a < this->allocations.size(); a++) {
+		if (this->allocations[a].last_use == NONE) {
+			for (auto it = this->frame_buffers.begin(); it != this->frame_buffers.end();) {
+				if (std::find(it->first.begin(), it->first.end(), this->allocations[a].texture) != it->first.end()) it = this->frame_buffers.erase(it);
+				else ++it;
+			}
+			glDeleteTextures(1, &this->allocations[a].texture);
+			continue;
+		}
+		remap[a] = kept.size();
+		kept.push_back(this->allocations[a]);
+	}
+	this->allocations = std::move(kept);
+	for (Resource & resource : this->resources) {
+		if (resource.allocation != NONE) resource.allocation = remap[resource.allocation];
+	}
+}
+
+void RenderGraph::createFrameBuffers()
+{
+	std::map<std::vector<GLuint>, std::unique_ptr<FrameBuffer>> used;
+	for (size_t p : this->order) {
+		Pass & pass = this->passes[p];
+		pass.frame_buffer = nullptr;
+		if (pass.writes.empty()) continue;
+
+		// the key lists the color textures in attachment order followed by the depth texture (or 0)
+		std::vector<GLuint> colors;
+		std::optional<GLuint> depth;
+		GLenum depth_attachment = GL_DEPTH_ATTACHMENT;
+		for (size_t resource : pass.writes) {
+			const RenderTargetDescription & description = this->resources[resource].description;
+			if (!description.isDepth()) {
+				colors.push_back(getTexture(resource));
+				continue;
+			}
+			depth = getTexture(resource);
+			const bool stencil = description.internal_format == GL_DEPTH24_STENCIL8 || description.internal_format == GL_DEPTH32F_STENCIL8;
+			depth_attachment = stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+		}
+		std::vector<GLuint> key = colors;
+		key.push_back(depth.value_or(0));
+
+		auto found = used.find(key);
+		if (found == used.end()) {
+			auto cached = this->frame_buffers.find(key);
+			if (cached != this->frame_buffers.end()) found = used.emplace(key, std::move(cached->second)).first;
+			else found = used.emplace(key, std::make_unique<FrameBuffer>(colors, depth, depth_attachment)).first;
+			found->second->setDebugName(pass.name);
+		}
+		pass.frame_buffer = found->second.get();
+		pass.viewport = this->resources[pass.writes[0]].description;
+	}
+	this->frame_buffers = std::move(used);
+}
+
+void RenderGraph::execute(const ScreenResolution & screen_res)
+{
+	if (!this->compiled) compile();
+	for (size_t p : this->order) {
+		Pass & pass = this->passes[p];
+		if (pass.frame_buffer) {
+			pass.frame_buffer->use();
+			glViewport(0, 0, pass.viewport.width, pass.viewport.height);
+			// the targets may hold the results of other resources that share their textures, which the pass replaces
+			std::vector<GLenum> attachments;
+			GLenum color = GL_COLOR_ATTACHMENT0;
+			for (size_t resource : pass.writes) {
+				const RenderTargetDescription & description = this->resources[resource].description;
+				const GLenum attachment = description.isDepth() ? GL_NONE : color++;
+				if (this->resources[resource].imported.has_value()) continue;
+				if (attachment != GL_NONE) attachments.push_back(attachment);
+				else if (description.internal_format == GL_DEPTH24_STENCIL8 || description.internal_format == GL_DEPTH32F_STENCIL8) attachments.push_back(GL_DEPTH_STENCIL_ATTACHMENT);
+				else attachments.push_back(GL_DEPTH_ATTACHMENT);
+			}
+			if (!attachments.empty()) glInvalidateNamedFramebufferData(pass.frame_buffer->getID(), static_cast<GLsizei>(attachments.size()), attachments.data());
+		}
+		else {
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glViewport(0, 0, static_cast<GLsizei>(screen_res.width), static_cast<GLsizei>(screen_res.height));
+		}
+		RenderPassContext context(*this, pass.frame_buffer);
+		if (pass.execute) pass.execute(context);
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderGraph::reset()
+{
+	this->resources.clear();
+	this->passes.clear();
+	this->order.clear();
+	this->compiled = false;
+}
+
+GLuint RenderGraph::getTexture(size_t resource) const
+{
+	checkResource(resource);
+	const Resource & source = this->resources[resource];
+	if (source.imported.has_value()) return source.imported.value();
+	return source.allocation == NONE ? 0 : this->allocations[source.allocation].texture;
+}
+
+bool RenderGraph::isCulled(size_t pass) const
+{
+	return this->passes.at(pass).culled;
+}
+
+const std::vector<size_t> & RenderGraph::getPassOrder() const
+{
+	return this->order;
+}
+
+size_t RenderGraph::getTransientCount() const
+{
+	size_t count = 0;
+	for (const Resource & resource : this->resources) {
+		if (resource.allocation != NONE) count++;
+	}
+	return count;
+}
+
+size_t RenderGraph::getAllocatedTextureCount() const
+{
+	return this->allocations.size();
+}
+
+void RenderGraph::checkResource(size_t resource) const
+{
+	if (resource >= this->resources.size()) fail("unknown resource " + std::to_string(resource));
+}
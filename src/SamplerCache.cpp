@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <tuple>
+#include <mygl/SamplerCache.hpp>
+
+using namespace mygl;
+
+bool SamplerDescription::operator < (const SamplerDescription & other) const
+{
+	return std::tie(this->min_filter, this->mag_filter, this->wrap_s, this->wrap_t, this->max_anisotropy)
+		< std::tie(other.min_filter, other.mag_filter, other.wrap_s, other.wrap_t, other.max_anisotropy);
+}
+
+void SamplerCache::release()
+{
+	for (auto & pair : this->samplers) glDeleteSamplers(1, &pair.second);
+	this->samplers.clear();
+	this->generation++;
+}
+
+GLuint SamplerCache::getSampler(const SamplerDescription & description)
+{
+	auto found = this->samplers.find(description);
+	if (found != this->samplers.end()) return found->second;
+
+	GLuint sampler;
+	glCreateSamplers(1, &sampler);
+	glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(description.min_filter));
+	glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(description.mag_filter));
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, static_cast<GLint>(description.wrap_s));
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, static_cast<GLint>(description.wrap_t));
+	glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY, getAnisotropy(description));
+	this->samplers[description] = sampler;
+	return sampler;
+}
+
+void SamplerCache::setDefaultAnisotropy(float anisotropy)
+{
+	GLfloat supported = 1.f;
+	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &supported);
+	this->default_anisotropy = std::clamp(anisotropy, 1.f, std::max(supported, 1.f));
+	for (auto & pair : this->samplers) {
+		if (pair.first.max_anisotropy == 0.f) glSamplerParameterf(pair.second, GL_TEXTURE_MAX_ANISOTROPY, this->default_anisotropy);
+	}
+}
+
+float SamplerCache::getDefaultAnisotropy()
+{
+	return this->default_anisotropy;
+}
+
+size_t SamplerCache::getSamplerCount()
+{
+	return this->samplers.size();
+}
+
+size_t SamplerCache::getGeneration()
+{
+	return this->generation;
+}
+
+float SamplerCache::getAnisotropy(const SamplerDescription & description)
+{
+	return description.max_anisotropy == 0.f ? this->default_anisotropy : std::max(description.max_anisotropy, 1.f);
+}
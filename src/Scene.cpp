@@ -1,4 +1,5 @@
 #include <mygl/Scene.hpp>
+#include <mygl/Meshlet.hpp>
 
 using namespace mygl;
 
@@ -88,6 +89,39 @@ void Scene::draw(ShaderConfiguration * configuration, std::map<GLuint, FrameBuff
 	}
 }
 
+void Scene::requestTextures(TextureStreamer & streamer, const glm::mat4 & projection, const glm::vec2 & viewport) {
+	const glm::mat4 view = this->activeCamera->getViewMatrix();
+	const std::vector<glm::vec4> planes = extractFrustumPlanes(projection * view);
+	const glm::vec3 camera_position = this->activeCamera->getPosition();
+	// perspective projections divide by the depth, orthographic ones keep w = 1
+	const bool perspective = projection[2][3] != 0.f;
+	const float pixels_per_unit = projection[1][1] * 0.5f * viewport.y;
+
+	for (unsigned int i = 0; i < this->objectNodes.size(); i++) {
+		auto obj = this->objectNodes[i]->getObject();
+		std::shared_ptr<Material> material = obj->getMaterial();
+		if (!material) continue;
+
+		const Bounds bounds = obj->getBounds();
+		if (bounds.radius <= 0.f) {
+			streamer.requestMaterial(*material, std::max(viewport.x, viewport.y));
+			continue;
+		}
+
+		const glm::mat4 model = this->objectNodes[i]->calculateModelMatrix();
+		const glm::vec3 center = glm::vec3(model * glm::vec4(bounds.center, 1.f));
+		const float scale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+		const float radius = bounds.radius * scale;
+
+		bool visible = true;
+		for (const glm::vec4 & plane : planes) visible = visible && glm::dot(glm::vec3(plane), center) + plane.w >= -radius;
+		if (!visible) continue;
+
+		const float distance = perspective ? std::max(glm::length(center - camera_position) - radius, 1e-4f) : 1.f;
+		streamer.requestMaterial(*material, 2.f * radius * pixels_per_unit / distance);
+	}
+}
+
 void Scene::processInput(GLFWwindow * window) {
 	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
 		activeCamera->translate(	-	activeCamera->getU());
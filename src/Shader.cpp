@@ -285,6 +285,42 @@ Shader::Shader(const std::string shader_lib, const std::string vertex_path,
 	ShaderManager::getInstance().registerShader(this);
 }
 
+Shader::Shader(const std::map<GLenum, std::string> & sources, enum eBuildinTargetShaderMode mode) : eTargetShaderMode(mode)
+{
+	static const std::map<GLenum, std::string> stage_names = {
+		{ GL_VERTEX_SHADER, "VERTEX" },
+		{ GL_TESS_CONTROL_SHADER, "TESS_CONTROL" },
+		{ GL_TESS_EVALUATION_SHADER, "TESS_EVALUATION" },
+		{ GL_GEOMETRY_SHADER, "GEOMETRY" },
+		{ GL_FRAGMENT_SHADER, "FRAGMENT" },
+		{ GL_COMPUTE_SHADER, "COMPUTE" }
+	};
+
+	std::vector<GLuint> shader_ids;
+	for (const auto & [shader_type, source] : sources) {
+		auto name = stage_names.find(shader_type);
+		shader_ids.push_back(createShader(shader_type, source.c_str(), name != stage_names.end() ? name->second : "UNKNOWN"));
+	}
+
+	ID = glCreateProgram();
+	for (GLuint shader_id : shader_ids) glAttachShader(ID, shader_id);
+	glLinkProgram(ID);
+
+	int success;
+	char infoLog[512];
+	glGetProgramiv(ID, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(ID, 512, NULL, infoLog);
+		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+		exit(1);
+	}
+
+	for (GLuint shader_id : shader_ids) glDeleteShader(shader_id);
+
+	ShaderManager::getInstance().registerShader(this);
+}
+
 void Shader::loadShaderFile(const std::string shader_path, std::string* out)
 {
 	std::ifstream file;
@@ -365,21 +401,25 @@ void Shader::setMaterialProperty(const std::string& name, MaterialProperty<glm::
 
 void Shader::setMaterialProperty(const std::string& name, MaterialProperty<float> material_property, GLuint texture_unit) {
 	setFloat(name + period + value_default, material_property.value_default);
+	setInt(name + period + channel, static_cast<GLint>(material_property.channel));
 	setMaterialPropertyCommons(name, material_property, texture_unit);
 }
 
 void Shader::setMaterial(const std::string & name, std::shared_ptr<Material> material) {
 	material->bindTextures(0);
 	if (eTargetShaderMode == eBuildinTargetShaderMode::PBR) {
-		setMaterialProperty(name + period + "albedo",		material->albedo,		0);
-		setMaterialProperty(name + period + "normal",		material->normal,		1);
-		setMaterialProperty(name + period + "roughness",	material->roughness,	2);
-		setMaterialProperty(name + period + "metallic",		material->metallic,		3);
-		setMaterialProperty(name + period + "ao",			material->ao,			4);
-		setMaterialProperty(name + period + "height",		material->height,		5);
-		setMaterialProperty(name + period + "opacity",		material->opacity,		6);
+		// properties that share a packed texture share its unit
+		const std::array<GLuint, 7> units = material->getTextureUnits(0);
+		setMaterialProperty(name + period + "albedo",		material->albedo,		units[0]);
+		setMaterialProperty(name + period + "normal",		material->normal,		units[1]);
+		setMaterialProperty(name + period + "roughness",	material->roughness,	units[2]);
+		setMaterialProperty(name + period + "metallic",		material->metallic,		units[3]);
+		setMaterialProperty(name + period + "ao",			material->ao,			units[4]);
+		setMaterialProperty(name + period + "height",		material->height,		units[5]);
+		setMaterialProperty(name + period + "opacity",		material->opacity,		units[6]);
 
 		setFloat(name + period + "height_scale", material->height_scale);
+		setVec4(name + period + "uv_transform", material->uv_transform);
 	}
 }
 
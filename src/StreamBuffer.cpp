@@ -0,0 +1,97 @@
+#include <iostream>
+#include <stdexcept>
+#include <mygl/StreamBuffer.hpp>
+
+using namespace mygl;
+
+StreamBuffer::StreamBuffer(size_t region_size, unsigned int region_count)
+{
+	this->region_size = region_size;
+	this->region_count = region_count == 0 ? 1 : region_count;
+	this->fences.assign(this->region_count, nullptr);
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	const GLsizeiptr size = static_cast<GLsizeiptr>(this->region_size * this->region_count);
+	glCreateBuffers(1, &(this->ID));
+	glNamedBufferStorage(this->ID, size, NULL, flags);
+	this->mapped = static_cast<unsigned char *>(glMapNamedBufferRange(this->ID, 0, size, flags));
+	if (!this->mapped)
+	{
+		std::cerr << "ERROR::cannot map stream buffer" << std::endl;
+		throw std::runtime_error("cannot map stream buffer");
+	}
+	// the first call to beginWrite advances to region 0
+	this->current_region = this->region_count - 1;
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	for (GLsync fence : this->fences)
+	{
+		if (fence) glDeleteSync(fence);
+	}
+	glUnmapNamedBuffer(this->ID);
+	glDeleteBuffers(1, &(this->ID));
+}
+
+void * StreamBuffer::beginWrite()
+{
+	this->current_region = (this->current_region + 1) % this->region_count;
+	waitForRegion(this->current_region);
+	return getCurrentRegion();
+}
+
+void * StreamBuffer::getCurrentRegion()
+{
+	return this->mapped + getCurrentOffset();
+}
+
+void StreamBuffer::fenceCurrentRegion()
+{
+	GLsync & fence = this->fences[this->current_region];
+	if (fence) glDeleteSync(fence);
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void StreamBuffer::waitForRegion(unsigned int region)
+{
+	GLsync & fence = this->fences[region];
+	if (!fence) return;
+
+	// flush once, then keep waiting until the GPU has consumed the region
+	GLbitfield wait_flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	const GLuint64 timeout_ns = 1000000;
+	while (true)
+	{
+		GLenum result = glClientWaitSync(fence, wait_flags, timeout_ns);
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) break;
+		wait_flags = 0;
+	}
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+GLuint StreamBuffer::getID()
+{
+	return this->ID;
+}
+
+unsigned int StreamBuffer::getCurrentRegionIndex()
+{
+	return this->current_region;
+}
+
+size_t StreamBuffer::getCurrentOffset()
+{
+	return this->region_size * this->current_region;
+}
+
+size_t StreamBuffer::getRegionSize()
+{
+	return this->region_size;
+}
+
+unsigned int StreamBuffer::getRegionCount()
+{
+	return this->region_count;
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <mygl/Texture.hpp>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -5,7 +6,8 @@
 
 using namespace mygl;
 
-Texture::Texture(std::string library, std::string relativePath) {
+Texture::Texture(std::string library, std::string relativePath, TextureContent content) {
+	this->content = content;
 	create(library, relativePath);
 }
 
@@ -17,42 +19,175 @@ Texture::Texture() {
 	create(defaultLibrary, defaultRelativePath);
 }
 
+Texture::Texture(const unsigned char * encoded, size_t size, std::string name, TextureContent content) {
+	this->relativePath = name;
+	this->content = content;
+	this->data = stbi_load_from_memory(encoded, static_cast<int>(size), &(this->width), &(this->height), &(this->nrChannels), STBI_rgb_alpha);
+	upload(name);
+}
+
+Texture::Texture(const unsigned char * rgba, int width, int height, std::string name, GLsizei level_count, TextureContent content) {
+	this->relativePath = name;
+	this->content = content;
+	this->width = width;
+	this->height = height;
+	this->nrChannels = 4;
+	this->data = nullptr;
+	level_count = level_count > 0 ? std::min(level_count, getLevelCount(width, height)) : getLevelCount(width, height);
+	uploadLevels(generateMipLevels(rgba, static_cast<uint32_t>(width), static_cast<uint32_t>(height), content), level_count);
+	this->successfullyLoaded = true;
+}
+
+Texture::Texture(std::string name, const glm::vec4 & placeholder) {
+	this->relativePath = name;
+	this->width = 1;
+	this->height = 1;
+	this->nrChannels = 4;
+	this->data = nullptr;
+
+	unsigned char texel[4];
+	for (int c = 0; c < 4; c++) texel[c] = static_cast<unsigned char>(glm::clamp(placeholder[c], 0.f, 1.f) * 255.f + 0.5f);
+	allocate(GL_RGBA8, 1, 1, 1);
+	glTextureSubImage2D(this->ID, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+	this->memorySize = 4;
+}
+
+Texture::Texture(const CompressedTexture & texture, std::string name) {
+	this->relativePath = name;
+	this->nrChannels = 4;
+	this->data = nullptr;
+	uploadCompressed(texture);
+}
+
+Texture::~Texture() {
+	glDeleteTextures(1, &(this->ID));
+}
+
 void Texture::create(std::string library, std::string relativePath) {
 	this->library = library;
 	this->relativePath = relativePath;
-	glGenTextures(1, &(this->ID));
-	glBindTexture(GL_TEXTURE_2D, this->ID);
+	load();
+}
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+void Texture::allocate(GLenum internal_format, GLsizei width, GLsizei height, GLsizei level_count) {
+	// immutable storage cannot change its size, so a new image needs a new texture object
+	if (this->ID != 0) glDeleteTextures(1, &(this->ID));
+	glCreateTextures(GL_TEXTURE_2D, 1, &(this->ID));
+	glTextureStorage2D(this->ID, level_count, internal_format, width, height);
+}
 
-	load();
+GLsizei Texture::getLevelCount(GLsizei width, GLsizei height) {
+	GLsizei count = 1;
+	for (GLsizei extent = std::max(width, height); extent > 1; extent /= 2) count++;
+	return count;
 }
 
 void Texture::load() {
 	std::string fullPath_string = this->library + this->relativePath;
+	if (isTextureFile(fullPath_string)) {
+		try {
+			uploadCompressed(readTextureFile(fullPath_string));
+		} catch (const std::runtime_error &) {
+			std::cout << "Failed to load texture \"" << fullPath_string << "\"" << std::endl;
+			this->successfullyLoaded = false;
+		}
+		return;
+	}
 	const char * fullPath = (fullPath_string).data();
 	this->data = stbi_load(fullPath, &(this->width), &(this->height), &(this->nrChannels), STBI_rgb_alpha);
+	upload(fullPath_string);
+}
 
+void Texture::upload(std::string name) {
 	if (data) {
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->width, this->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, this->data);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		uploadLevels(generateMipLevels(this->data, static_cast<uint32_t>(this->width), static_cast<uint32_t>(this->height), this->content),
+			getLevelCount(this->width, this->height));
 		this->successfullyLoaded = true;
 	} else {
-		std::cout << "Failed to load texture \"" << fullPath_string << "\"" << std::endl;
+		std::cout << "Failed to load texture \"" << name << "\"" << std::endl;
 		this->successfullyLoaded = false;
 	}
 
 	stbi_image_free(this->data);
 }
 
+void Texture::uploadLevels(const std::vector<MipLevel> & levels, GLsizei level_count) {
+	// the levels are filtered on the CPU, in linear light for colors, which glGenerateMipmap does not do
+	allocate(GL_RGBA8, this->width, this->height, level_count);
+	this->memorySize = 0;
+	for (GLsizei level = 0; level < level_count; level++) {
+		glTextureSubImage2D(this->ID, level, 0, 0, levels[level].width, levels[level].height, GL_RGBA, GL_UNSIGNED_BYTE, levels[level].rgba.data());
+		this->memorySize += levels[level].rgba.size();
+	}
+}
+
+void Texture::uploadCompressed(const CompressedTexture & texture) {
+	this->memorySize = 0;
+	this->width = texture.levels.empty() ? 0 : texture.levels[0].width;
+	this->height = texture.levels.empty() ? 0 : texture.levels[0].height;
+	this->successfullyLoaded = !texture.levels.empty();
+	if (texture.levels.empty()) return;
+
+	// the file holds the complete chain, so nothing is generated at runtime
+	const GLenum internal_format = getCompressedInternalFormat(texture.format, texture.srgb);
+	allocate(internal_format, this->width, this->height, static_cast<GLsizei>(texture.levels.size()));
+	for (size_t level = 0; level < texture.levels.size(); level++) {
+		const CompressedTextureLevel & data = texture.levels[level];
+		glCompressedTextureSubImage2D(this->ID, static_cast<GLint>(level), 0, 0, data.width, data.height, internal_format,
+			static_cast<GLsizei>(data.blocks.size()), data.blocks.data());
+		this->memorySize += data.blocks.size();
+	}
+}
+
 void Texture::bind(GLenum textureUnit) {
-	glActiveTexture(textureUnit);
-	glBindTexture(GL_TEXTURE_2D, this->ID);
+	SamplerCache & cache = SamplerCache::getInstance();
+	// the cached sampler object is deleted if the cache was released since it was requested
+	if (this->sampler_ID == 0 || this->sampler_generation != cache.getGeneration()) {
+		this->sampler_ID = cache.getSampler(this->sampler);
+		this->sampler_generation = cache.getGeneration();
+	}
+	glBindTextureUnit(textureUnit - GL_TEXTURE0, this->ID);
+	glBindSampler(textureUnit - GL_TEXTURE0, this->sampler_ID);
+}
+
+void Texture::setSampler(const SamplerDescription & sampler) {
+	this->sampler = sampler;
+	this->sampler_ID = 0;
+}
+
+const SamplerDescription & Texture::getSampler() {
+	return this->sampler;
 }
 
 bool Texture::isSuccessfullyLoaded() {
 	return this->successfullyLoaded;
 }
+
+GLuint Texture::getID() {
+	return this->ID;
+}
+
+int Texture::getWidth() {
+	return this->width;
+}
+
+int Texture::getHeight() {
+	return this->height;
+}
+
+size_t Texture::getMemorySize() {
+	return this->memorySize;
+}
+
+std::vector<unsigned char> Texture::readPixels() {
+	if (!this->successfullyLoaded) return {};
+	// streamed textures only keep their coarser levels, so their storage starts below the full size
+	GLint stored_width = 0;
+	glGetTextureLevelParameteriv(this->ID, 0, GL_TEXTURE_WIDTH, &stored_width);
+	if (stored_width != this->width) return {};
+
+	std::vector<unsigned char> pixels(static_cast<size_t>(this->width) * this->height * 4);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glGetTextureImage(this->ID, 0, GL_RGBA, GL_UNSIGNED_BYTE, static_cast<GLsizei>(pixels.size()), pixels.data());
+	return pixels;
+}
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <array>
+#include <map>
+#include <mygl/TextureAtlas.hpp>
+
+using namespace mygl;
+
+namespace {
+	const size_t PROPERTY_COUNT = 7;
+	typedef std::array<std::optional<std::shared_ptr<Texture>> *, PROPERTY_COUNT> texture_slots_t;
+	typedef std::array<Texture *, PROPERTY_COUNT> texture_set_t;
+
+	texture_slots_t getTextureSlots(Material & material)
+	{
+		return { &material.albedo.texture, &material.normal.texture, &material.roughness.texture, &material.metallic.texture,
+			&material.ao.texture, &material.height.texture, &material.opacity.texture };
+	}
+
+	// slots that share a source texture (e.g. a packed orm texture) share the page of the first of them
+	size_t getPageSlot(const texture_set_t & set, size_t p)
+	{
+		return static_cast<size_t>(std::find(set.begin(), set.end(), set[p]) - set.begin());
+	}
+
+	struct AtlasRegion {
+		size_t page = 0;
+		uint32_t x = 0;
+		uint32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	// copies the texture into its region and repeats its edge texels into the padding around it
+	void copyIntoPage(std::vector<unsigned char> & page, uint32_t page_size, const std::vector<unsigned char> & pixels,
+		const AtlasRegion & region, uint32_t padding)
+	{
+		const int64_t first_x = static_cast<int64_t>(region.x) - padding, first_y = static_cast<int64_t>(region.y) - padding;
+		for (int64_t y = std::max<int64_t>(first_y, 0); y < std::min<int64_t>(region.y + region.height + padding, page_size); y++) {
+			const int64_t source_y = std::clamp<int64_t>(y - region.y, 0, region.height - 1);
+			for (int64_t x = std::max<int64_t>(first_x, 0); x < std::min<int64_t>(region.x + region.width + padding, page_size); x++) {
+				const int64_t source_x = std::clamp<int64_t>(x - region.x, 0, region.width - 1);
+				std::copy_n(&pixels[(source_y * region.width + source_x) * 4], 4, &page[(y * page_size + x) * 4]);
+			}
+		}
+	}
+}
+
+SkylinePacker::SkylinePacker(uint32_t width, uint32_t height)
+{
+	this->width = width;
+	this->height = height;
+	this->skyline.push_back({ 0, 0, width });
+}
+
+bool SkylinePacker::fit(size_t segment, uint32_t width, uint32_t height, uint32_t & y)
+{
+	const uint32_t x = this->skyline[segment].x;
+	if (x + width > this->width) return false;
+
+	// the rectangle rests on the highest segment below it
+	y = this->skyline[segment].y;
+	uint32_t covered = 0;
+	for (size_t s = segment; covered < width; s++) {
+		y = std::max(y, this->skyline[s].y);
+		if (y + height > this->height) return false;
+		covered += this->skyline[s].width;
+	}
+	return true;
+}
+
+bool SkylinePacker::insert(uint32_t width, uint32_t height, uint32_t & x, uint32_t & y)
+{
+	size_t best = this->skyline.size();
+	uint32_t best_top = UINT32_MAX, best_width = UINT32_MAX;
+	for (size_t s = 0; s < this->skyline.size(); s++) {
+		uint32_t candidate_y;
+		if (!fit(s, width, height, candidate_y)) continue;
+		const uint32_t top = candidate_y + height;
+		if (top < best_top || (top == best_top && this->skyline[s].width < best_width)) {
+			best = s;
+			best_top = top;
+			best_width = this->skyline[s].width;
+			y = candidate_y;
+		}
+	}
+	if (best == this->skyline.size()) return false;
+	x = this->skyline[best].x;
+
+	// the new segment replaces the parts of the skyline below the rectangle
+	this->skyline.insert(this->skyline.begin() + best, { x, y + height, width });
+	for (size_t s = best + 1; s < this->skyline.size();) {
+		Segment & segment = this->skyline[s];
+		if (segment.x >= x + width) break;
+		const uint32_t shrink = x + width - segment.x;
+		if (shrink >= segment.width) {
+			this->skyline.erase(this->skyline.begin() + s);
+			continue;
+		}
+		segment.x += shrink;
+		segment.width -= shrink;
+		break;
+	}
+	for (size_t s = 1; s < this->skyline.size();) {
+		if (this->skyline[s - 1].y == this->skyline[s].y) {
+			this->skyline[s - 1].width += this->skyline[s].width;
+			this->skyline.erase(this->skyline.begin() + s);
+		}
+		else {
+			s++;
+		}
+	}
+
+	this->used_area += static_cast<uint64_t>(width) * height;
+	return true;
+}
+
+float SkylinePacker::getOccupancy()
+{
+	return static_cast<float>(static_cast<double>(this->used_area) / (static_cast<double>(this->width) * this->height));
+}
+
+TextureAtlasReport mygl::packMaterialTextures(const std::vector<std::shared_ptr<Material>> & materials, const TextureAtlasOptions & options)
+{
+	TextureAtlasReport report;
+	uint32_t padding = 1;
+	while (padding < options.padding) padding *= 2;
+	GLsizei level_count = 1;
+	for (uint32_t p = padding; p > 1; p /= 2) level_count++;
+
+	// materials with the same textures share a region
+	std::map<texture_set_t, std::vector<Material *>> groups;
+	std::vector<texture_set_t> order;
+	std::map<Texture *, std::vector<unsigned char>> pixels;
+	for (const std::shared_ptr<Material> & material : materials) {
+		if (!material) continue;
+		texture_set_t set = {};
+		int width = 0, height = 0;
+		// a scaled or offset uv range usually tiles, which a region cannot
+		bool qualifies = material->uv_transform == glm::vec4(1.f, 1.f, 0.f, 0.f), textured = false;
+		const texture_slots_t slots = getTextureSlots(*material);
+		for (size_t p = 0; p < PROPERTY_COUNT && qualifies; p++) {
+			if (!slots[p]->has_value() || !slots[p]->value()) continue;
+			Texture & texture = *slots[p]->value();
+			// the placeholder of a texture that is still loading would keep being sampled through the atlas transform
+			if (!texture.isSuccessfullyLoaded()) {
+				qualifies = false;
+				break;
+			}
+			if (!textured) {
+				width = texture.getWidth();
+				height = texture.getHeight();
+				textured = true;
+			}
+			qualifies = texture.getWidth() == width && texture.getHeight() == height;
+			set[p] = &texture;
+		}
+		const uint32_t extent = static_cast<uint32_t>(std::max(width, height));
+		qualifies = qualifies && textured && width > 0 && height > 0 && extent <= options.max_texture_size
+			&& (extent + 3 * padding - 1) / padding * padding <= options.page_size;
+
+		// streamed textures without their finest level cannot be read back
+		for (size_t p = 0; p < PROPERTY_COUNT && qualifies; p++) {
+			if (!set[p]) continue;
+			auto found = pixels.find(set[p]);
+			if (found == pixels.end()) found = pixels.emplace(set[p], set[p]->readPixels()).first;
+			qualifies = !found->second.empty();
+		}
+		if (!qualifies) {
+			report.skipped_materials++;
+			continue;
+		}
+		std::vector<Material *> & group = groups[set];
+		if (group.empty()) order.push_back(set);
+		group.push_back(material.get());
+	}
+	if (order.empty()) return report;
+
+	// tall textures first, so that the skyline stays flat
+	std::stable_sort(order.begin(), order.end(), [](const texture_set_t & a, const texture_set_t & b) {
+		auto extent = [](const texture_set_t & set) {
+			for (Texture * texture : set) if (texture) return std::make_pair(texture->getHeight(), texture->getWidth());
+			return std::make_pair(0, 0);
+		};
+		return extent(a) > extent(b);
+	});
+
+	std::vector<SkylinePacker> packers;
+	std::vector<std::array<std::vector<unsigned char>, PROPERTY_COUNT>> pages;
+	std::map<texture_set_t, AtlasRegion> regions;
+	for (const texture_set_t & set : order) {
+		AtlasRegion region;
+		for (Texture * texture : set) {
+			if (!texture) continue;
+			region.width = static_cast<uint32_t>(texture->getWidth());
+			region.height = static_cast<uint32_t>(texture->getHeight());
+			break;
+		}
+
+		// regions start and end on multiples of the padding, so that the kept mipmap levels do not straddle them
+		const uint32_t padded_width = (region.width + 2 * padding + padding - 1) / padding * padding;
+		const uint32_t padded_height = (region.height + 2 * padding + padding - 1) / padding * padding;
+		uint32_t x = 0, y = 0;
+		bool placed = false;
+		for (size_t page = 0; page < packers.size() && !placed; page++) {
+			placed = packers[page].insert(padded_width, padded_height, x, y);
+			region.page = page;
+		}
+		if (!placed) {
+			packers.emplace_back(options.page_size, options.page_size);
+			pages.emplace_back();
+			region.page = packers.size() - 1;
+			packers.back().insert(padded_width, padded_height, x, y);
+		}
+		region.x = x + padding;
+		region.y = y + padding;
+
+		for (size_t p = 0; p < PROPERTY_COUNT; p++) {
+			if (!set[p] || getPageSlot(set, p) != p) continue;
+			std::vector<unsigned char> & page = pages[region.page][p];
+			if (page.empty()) page.assign(static_cast<size_t>(options.page_size) * options.page_size * 4, 0);
+			copyIntoPage(page, options.page_size, pixels[set[p]], region, padding);
+			report.packed_textures++;
+		}
+		regions[set] = region;
+	}
+
+	std::vector<std::array<std::shared_ptr<Texture>, PROPERTY_COUNT>> page_textures(pages.size());
+	for (size_t page = 0; page < pages.size(); page++) {
+		for (size_t p = 0; p < PROPERTY_COUNT; p++) {
+			if (pages[page][p].empty()) continue;
+			std::shared_ptr<Texture> texture(new Texture(pages[page][p].data(), static_cast<int>(options.page_size), static_cast<int>(options.page_size),
+				"atlas_page_" + std::to_string(page) + "_" + std::to_string(p), level_count,
+				p == 0 ? TextureContent::Color : (p == 1 ? TextureContent::Normal : TextureContent::Linear)));
+			SamplerDescription sampler;
+			sampler.wrap_s = GL_CLAMP_TO_EDGE;
+			sampler.wrap_t = GL_CLAMP_TO_EDGE;
+			texture->setSampler(sampler);
+			page_textures[page][p] = texture;
+		}
+	}
+
+	const float page_size = static_cast<float>(options.page_size);
+	for (auto & group : groups) {
+		const AtlasRegion & region = regions[group.first];
+		for (Material * material : group.second) {
+			const texture_slots_t slots = getTextureSlots(*material);
+			for (size_t p = 0; p < PROPERTY_COUNT; p++) {
+				if (group.first[p]) *slots[p] = page_textures[region.page][getPageSlot(group.first, p)];
+			}
+			material->uv_transform = glm::vec4(region.width / page_size, region.height / page_size, region.x / page_size, region.y / page_size);
+			report.packed_materials++;
+		}
+	}
+	report.page_count = pages.size();
+	return report;
+}
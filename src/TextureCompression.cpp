@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <mygl/TextureCompression.hpp>
+#include <mygl/Parallel.hpp>
+
+#include <stb_image.h>
+
+using namespace mygl;
+
+namespace {
+	typedef float Block[16][4];
+
+	void loadBlock(const unsigned char * rgba, uint32_t width, uint32_t height, uint32_t block_x, uint32_t block_y, Block block)
+	{
+		for (uint32_t y = 0; y < 4; y++) {
+			for (uint32_t x = 0; x < 4; x++) {
+				const uint32_t source_x = std::min(block_x * 4 + x, width - 1);
+				const uint32_t source_y = std::min(block_y * 4 + y, height - 1);
+				const unsigned char * texel = rgba + (static_cast<size_t>(source_y) * width + source_x) * 4;
+				for (int c = 0; c < 4; c++) block[y * 4 + x][c] = texel[c];
+			}
+		}
+	}
+
+	// fits a line through the first 'channels' channels of the block along its principal axis
+	void fitEndpoints(const Block block, int channels, float endpoint0[4], float endpoint1[4])
+	{
+		float mean[4] = {};
+		for (int i = 0; i < 16; i++) for (int c = 0; c < channels; c++) mean[c] += block[i][c] / 16.f;
+
+		float covariance[4][4] = {};
+		float axis[4] = {};
+		for (int i = 0; i < 16; i++) {
+			for (int a = 0; a < channels; a++) {
+				for (int b = 0; b < channels; b++) covariance[a][b] += (block[i][a] - mean[a]) * (block[i][b] - mean[b]);
+				axis[a] = std::max(axis[a], std::abs(block[i][a] - mean[a]));
+			}
+		}
+
+		// power iteration, started from the extent of the block
+		float length = 0.f;
+		for (int iteration = 0; iteration < 8; iteration++) {
+			float next[4] = {};
+			for (int a = 0; a < channels; a++) for (int b = 0; b < channels; b++) next[a] += covariance[a][b] * axis[b];
+			length = 0.f;
+			for (int c = 0; c < channels; c++) length = std::max(length, std::abs(next[c]));
+			if (length <= 1e-6f) break;
+			for (int c = 0; c < channels; c++) axis[c] = next[c] / length;
+		}
+
+		float min_t = 0.f, max_t = 0.f;
+		if (length > 1e-6f) {
+			float norm = 0.f;
+			for (int c = 0; c < channels; c++) norm += axis[c] * axis[c];
+			for (int c = 0; c < channels; c++) axis[c] /= std::sqrt(norm);
+			for (int i = 0; i < 16; i++) {
+				float t = 0.f;
+				for (int c = 0; c < channels; c++) t += (block[i][c] - mean[c]) * axis[c];
+				min_t = std::min(min_t, t);
+				max_t = std::max(max_t, t);
+			}
+		}
+		for (int c = 0; c < 4; c++) {
+			endpoint0[c] = c < channels ? glm::clamp(mean[c] + axis[c] * min_t, 0.f, 255.f) : 255.f;
+			endpoint1[c] = c < channels ? glm::clamp(mean[c] + axis[c] * max_t, 0.f, 255.f) : 255.f;
+		}
+	}
+
+	void writeBits(uint64_t bits[2], unsigned int & position, uint64_t value, unsigned int count)
+	{
+		for (unsigned int b = 0; b < count; b++, position++) {
+			if ((value >> b) & 1) bits[position / 64] |= 1ull << (position % 64);
+		}
+	}
+
+	uint16_t packColor565(const float color[4])
+	{
+		const unsigned int r = static_cast<unsigned int>(color[0] * 31.f / 255.f + 0.5f);
+		const unsigned int g = static_cast<unsigned int>(color[1] * 63.f / 255.f + 0.5f);
+		const unsigned int b = static_cast<unsigned int>(color[2] * 31.f / 255.f + 0.5f);
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	void unpackColor565(uint16_t packed, float color[3])
+	{
+		const unsigned int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+		color[0] = static_cast<float>((r << 3) | (r >> 2));
+		color[1] = static_cast<float>((g << 2) | (g >> 4));
+		color[2] = static_cast<float>((b << 3) | (b >> 2));
+	}
+
+	// BC1 color block in the four color mode, which BC3 also uses for its colors
+	void encodeBC1(const Block block, unsigned char * output)
+	{
+		float endpoint0[4], endpoint1[4];
+		fitEndpoints(block, 3, endpoint0, endpoint1);
+		uint16_t color0 = packColor565(endpoint1);
+		uint16_t color1 = packColor565(endpoint0);
+		if (color0 < color1) std::swap(color0, color1);
+
+		uint32_t indices = 0;
+		if (color0 != color1) {
+			float palette[4][3];
+			unpackColor565(color0, palette[0]);
+			unpackColor565(color1, palette[1]);
+			for (int c = 0; c < 3; c++) {
+				palette[2][c] = (2.f * palette[0][c] + palette[1][c]) / 3.f;
+				palette[3][c] = (palette[0][c] + 2.f * palette[1][c]) / 3.f;
+			}
+			for (int i = 0; i < 16; i++) {
+				uint32_t best = 0;
+				float best_error = INFINITY;
+				for (uint32_t p = 0; p < 4; p++) {
+					float error = 0.f;
+					for (int c = 0; c < 3; c++) error += (block[i][c] - palette[p][c]) * (block[i][c] - palette[p][c]);
+					if (error < best_error) {
+						best_error = error;
+						best = p;
+					}
+				}
+				indices |= best << (2 * i);
+			}
+		}
+
+		output[0] = color0 & 0xFF;
+		output[1] = color0 >> 8;
+		output[2] = color1 & 0xFF;
+		output[3] = color1 >> 8;
+		for (int b = 0; b < 4; b++) output[4 + b] = (indices >> (8 * b)) & 0xFF;
+	}
+
+	// BC4 block of a single channel in the eight value mode
+	void encodeBC4(const Block block, int channel, unsigned char * output)
+	{
+		float low = 255.f, high = 0.f;
+		for (int i = 0; i < 16; i++) {
+			low = std::min(low, block[i][channel]);
+			high = std::max(high, block[i][channel]);
+		}
+		const int value0 = static_cast<int>(high + 0.5f);
+		const int value1 = static_cast<int>(low + 0.5f);
+
+		uint64_t indices = 0;
+		if (value0 != value1) {
+			float palette[8] = { static_cast<float>(value0), static_cast<float>(value1) };
+			for (int p = 2; p < 8; p++) palette[p] = ((8 - p) * value0 + (p - 1) * value1) / 7.f;
+			for (int i = 0; i < 16; i++) {
+				uint64_t best = 0;
+				float best_error = INFINITY;
+				for (uint64_t p = 0; p < 8; p++) {
+					const float error = std::abs(block[i][channel] - palette[p]);
+					if (error < best_error) {
+						best_error = error;
+						best = p;
+					}
+				}
+				indices |= best << (3 * i);
+			}
+		}
+
+		output[0] = static_cast<unsigned char>(value0);
+		output[1] = static_cast<unsigned char>(value1);
+		for (int b = 0; b < 6; b++) output[2 + b] = (indices >> (8 * b)) & 0xFF;
+	}
+
+	// BC7 mode 6: a single subset with 7 bit RGBA endpoints, a p-bit per endpoint and 4 bit indices
+	void encodeBC7(const Block block, unsigned char * output)
+	{
+		static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		float fitted[2][4];
+		fitEndpoints(block, 4, fitted[0], fitted[1]);
+
+		unsigned int quantized[2][4];
+		unsigned int p_bits[2];
+		int endpoints[2][4];
+		for (int e = 0; e < 2; e++) {
+			float best_error = INFINITY;
+			for (unsigned int p = 0; p < 2; p++) {
+				unsigned int candidate[4];
+				float error = 0.f;
+				for (int c = 0; c < 4; c++) {
+					candidate[c] = static_cast<unsigned int>(glm::clamp(std::round((fitted[e][c] - p) / 2.f), 0.f, 127.f));
+					const float value = static_cast<float>((candidate[c] << 1) | p);
+					error += (value - fitted[e][c]) * (value - fitted[e][c]);
+				}
+				if (error < best_error) {
+					best_error = error;
+					p_bits[e] = p;
+					std::memcpy(quantized[e], candidate, sizeof(candidate));
+				}
+			}
+			for (int c = 0; c < 4; c++) endpoints[e][c] = static_cast<int>((quantized[e][c] << 1) | p_bits[e]);
+		}
+
+		unsigned int indices[16];
+		for (int i = 0; i < 16; i++) {
+			float best_error = INFINITY;
+			for (unsigned int w = 0; w < 16; w++) {
+				float error = 0.f;
+				for (int c = 0; c < 4; c++) {
+					const float value = static_cast<float>(((64 - weights[w]) * endpoints[0][c] + weights[w] * endpoints[1][c] + 32) >> 6);
+					error += (block[i][c] - value) * (block[i][c] - value);
+				}
+				if (error < best_error) {
+					best_error = error;
+					indices[i] = w;
+				}
+			}
+		}
+
+		// the most significant bit of the first index is implicitly 0
+		if (indices[0] & 8) {
+			std::swap(quantized[0], quantized[1]);
+			std::swap(p_bits[0], p_bits[1]);
+			for (unsigned int & index : indices) index = 15 - index;
+		}
+
+		uint64_t bits[2] = {};
+		unsigned int position = 0;
+		writeBits(bits, position, 1 << 6, 7);
+		for (int c = 0; c < 4; c++) {
+			writeBits(bits, position, quantized[0][c], 7);
+			writeBits(bits, position, quantized[1][c], 7);
+		}
+		writeBits(bits, position, p_bits[0], 1);
+		writeBits(bits, position, p_bits[1], 1);
+		for (int i = 0; i < 16; i++) writeBits(bits, position, indices[i], i == 0 ? 3 : 4);
+
+		for (int b = 0; b < 16; b++) output[b] = (bits[b / 8] >> (8 * (b % 8))) & 0xFF;
+	}
+}
+
+std::vector<unsigned char> mygl::compressBlocks(const unsigned char * rgba, uint32_t width, uint32_t height, TextureBlockFormat format)
+{
+	const uint32_t blocks_x = (width + 3) / 4;
+	const uint32_t blocks_y = (height + 3) / 4;
+	const size_t block_bytes = getBlockBytes(format);
+	std::vector<unsigned char> blocks(static_cast<size_t>(blocks_x) * blocks_y * block_bytes);
+
+	parallelFor(0, blocks_y, [&](size_t begin, size_t end) {
+		Block block;
+		for (size_t y = begin; y < end; y++) {
+			for (uint32_t x = 0; x < blocks_x; x++) {
+				loadBlock(rgba, width, height, x, static_cast<uint32_t>(y), block);
+				unsigned char * output = blocks.data() + (y * blocks_x + x) * block_bytes;
+				switch (format)
+				{
+				case TextureBlockFormat::BC1:
+					encodeBC1(block, output);
+					break;
+				case TextureBlockFormat::BC3:
+					encodeBC4(block, 3, output);
+					encodeBC1(block, output + 8);
+					break;
+				case TextureBlockFormat::BC4:
+					encodeBC4(block, 0, output);
+					break;
+				case TextureBlockFormat::BC5:
+					encodeBC4(block, 0, output);
+					encodeBC4(block, 1, output + 8);
+					break;
+				case TextureBlockFormat::BC7:
+					encodeBC7(block, output);
+					break;
+				}
+			}
+		}
+	}, 4);
+	return blocks;
+}
+
+CompressedTexture mygl::cookTexture(const unsigned char * rgba, uint32_t width, uint32_t height, const TextureCookOptions & options)
+{
+	CompressedTexture texture;
+	texture.format = options.format;
+	texture.srgb = options.srgb && options.format != TextureBlockFormat::BC4 && options.format != TextureBlockFormat::BC5;
+
+	for (const MipLevel & level : generateMipLevels(rgba, width, height, options.content, options.mip_filter)) {
+		texture.levels.push_back({ level.width, level.height, compressBlocks(level.rgba.data(), level.width, level.height, options.format) });
+	}
+	return texture;
+}
+
+void mygl::cookTextureFile(const std::string & input, const std::string & output, const TextureCookOptions & options)
+{
+	int width = 0, height = 0, channels = 0;
+	unsigned char * pixels = stbi_load(input.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+	if (!pixels)
+	{
+		std::cerr << "ERROR::cannot load image " << input << std::endl;
+		throw std::runtime_error("cannot load image " + input);
+	}
+	CompressedTexture texture = cookTexture(pixels, static_cast<uint32_t>(width), static_cast<uint32_t>(height), options);
+	stbi_image_free(pixels);
+	writeTextureFile(output, texture);
+}
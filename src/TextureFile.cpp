@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <mygl/TextureFile.hpp>
+
+using namespace mygl;
+
+static const uint64_t TEXTURE_FILE_ALIGNMENT = 16;
+
+static uint64_t alignOffset(uint64_t offset)
+{
+	return (offset + TEXTURE_FILE_ALIGNMENT - 1) / TEXTURE_FILE_ALIGNMENT * TEXTURE_FILE_ALIGNMENT;
+}
+
+static void fail(const std::string & path, const std::string & reason)
+{
+	std::cerr << "ERROR::invalid texture file " << path << ": " << reason << std::endl;
+	throw std::runtime_error("invalid texture file " + path + ": " + reason);
+}
+
+size_t mygl::getBlockBytes(TextureBlockFormat format)
+{
+	return format == TextureBlockFormat::BC1 || format == TextureBlockFormat::BC4 ? 8 : 16;
+}
+
+size_t mygl::getCompressedLevelBytes(TextureBlockFormat format, uint32_t width, uint32_t height)
+{
+	return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * getBlockBytes(format);
+}
+
+GLenum mygl::getCompressedInternalFormat(TextureBlockFormat format, bool srgb)
+{
+	switch (format)
+	{
+	case TextureBlockFormat::BC1:
+		return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case TextureBlockFormat::BC3:
+		return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case TextureBlockFormat::BC4:
+		return GL_COMPRESSED_RED_RGTC1;
+	case TextureBlockFormat::BC5:
+		return GL_COMPRESSED_RG_RGTC2;
+	case TextureBlockFormat::BC7:
+		return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+	}
+	return 0;
+}
+
+void mygl::writeTextureFile(const std::string & path, const CompressedTexture & texture)
+{
+	TextureFileHeader header;
+	header.format = static_cast<uint32_t>(texture.format);
+	header.flags = texture.srgb ? TextureFileHeader::FLAG_SRGB : 0;
+	header.width = texture.levels.empty() ? 0 : texture.levels[0].width;
+	header.height = texture.levels.empty() ? 0 : texture.levels[0].height;
+	header.level_count = static_cast<uint32_t>(texture.levels.size());
+
+	std::vector<TextureFileLevel> levels(texture.levels.size());
+	uint64_t offset = alignOffset(sizeof(TextureFileHeader) + sizeof(TextureFileLevel) * levels.size());
+	for (size_t l = 0; l < levels.size(); l++) {
+		levels[l].width = texture.levels[l].width;
+		levels[l].height = texture.levels[l].height;
+		levels[l].offset = offset;
+		levels[l].size = texture.levels[l].blocks.size();
+		offset = alignOffset(offset + levels[l].size);
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cerr << "ERROR::cannot write texture file " << path << std::endl;
+		throw std::runtime_error("cannot write texture file " + path);
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(TextureFileHeader));
+	file.write(reinterpret_cast<const char*>(levels.data()), static_cast<std::streamsize>(sizeof(TextureFileLevel) * levels.size()));
+	uint64_t written = sizeof(TextureFileHeader) + sizeof(TextureFileLevel) * levels.size();
+	for (size_t l = 0; l < levels.size(); l++) {
+		static const char padding[TEXTURE_FILE_ALIGNMENT] = {};
+		file.write(padding, static_cast<std::streamsize>(levels[l].offset - written));
+		file.write(reinterpret_cast<const char*>(texture.levels[l].blocks.data()), static_cast<std::streamsize>(levels[l].size));
+		written = levels[l].offset + levels[l].size;
+	}
+
+	if (!file)
+	{
+		std::cerr << "ERROR::cannot write texture file " << path << std::endl;
+		throw std::runtime_error("cannot write texture file " + path);
+	}
+}
+
+static std::ifstream openTextureFile(const std::string & path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		std::cerr << "ERROR::cannot open texture file " << path << std::endl;
+		throw std::runtime_error("cannot open texture file " + path);
+	}
+	return file;
+}
+
+static std::vector<TextureFileLevel> readLayout(std::ifstream & file, const std::string & path, TextureFileHeader & header)
+{
+	const uint64_t file_size = static_cast<uint64_t>(file.tellg());
+	file.seekg(0);
+	if (file_size < sizeof(TextureFileHeader) || !file.read(reinterpret_cast<char*>(&header), sizeof(TextureFileHeader))) fail(path, "truncated header");
+	if (std::memcmp(header.magic, TEXTURE_FILE_MAGIC, sizeof(TEXTURE_FILE_MAGIC)) != 0) fail(path, "wrong magic");
+	if (header.version != TEXTURE_FILE_VERSION) fail(path, "unsupported version");
+	if (header.header_size != sizeof(TextureFileHeader)) fail(path, "unexpected header size");
+
+	const TextureBlockFormat format = static_cast<TextureBlockFormat>(header.format);
+	if (getCompressedInternalFormat(format, (header.flags & TextureFileHeader::FLAG_SRGB) != 0) == 0) fail(path, "unknown block format");
+	// the levels are uploaded into immutable storage, which only holds a full or truncated mipmap chain
+	if (header.width == 0 || header.height == 0) fail(path, "empty texture");
+	uint32_t max_level_count = 1;
+	while (std::max(header.width, header.height) >> max_level_count) max_level_count++;
+	if (header.level_count == 0 || header.level_count > max_level_count) fail(path, "wrong level count");
+	if (file_size < sizeof(TextureFileHeader) + sizeof(TextureFileLevel) * static_cast<uint64_t>(header.level_count)) fail(path, "truncated level table");
+
+	std::vector<TextureFileLevel> levels(header.level_count);
+	file.read(reinterpret_cast<char*>(levels.data()), static_cast<std::streamsize>(sizeof(TextureFileLevel) * levels.size()));
+	for (uint32_t l = 0; l < header.level_count; l++) {
+		const TextureFileLevel & level = levels[l];
+		if (level.width != std::max(header.width >> l, 1u) || level.height != std::max(header.height >> l, 1u)) fail(path, "level extent does not match the mipmap chain");
+		if (level.size != getCompressedLevelBytes(format, level.width, level.height)) fail(path, "level size does not match its extent");
+		if (level.offset > file_size || level.size > file_size - level.offset) fail(path, "level exceeds the file");
+	}
+	return levels;
+}
+
+static std::vector<unsigned char> readLevel(std::ifstream & file, const std::string & path, const TextureFileLevel & level)
+{
+	std::vector<unsigned char> blocks(level.size);
+	file.seekg(static_cast<std::streamoff>(level.offset));
+	if (!file.read(reinterpret_cast<char*>(blocks.data()), static_cast<std::streamsize>(level.size))) fail(path, "cannot read level");
+	return blocks;
+}
+
+CompressedTexture mygl::readTextureFile(const std::string & path)
+{
+	std::ifstream file = openTextureFile(path);
+	TextureFileHeader header;
+	const std::vector<TextureFileLevel> levels = readLayout(file, path, header);
+
+	CompressedTexture texture;
+	texture.format = static_cast<TextureBlockFormat>(header.format);
+	texture.srgb = (header.flags & TextureFileHeader::FLAG_SRGB) != 0;
+	texture.levels.resize(levels.size());
+	for (size_t l = 0; l < levels.size(); l++) {
+		texture.levels[l].width = levels[l].width;
+		texture.levels[l].height = levels[l].height;
+		texture.levels[l].blocks = readLevel(file, path, levels[l]);
+	}
+	return texture;
+}
+
+std::vector<TextureFileLevel> mygl::readTextureFileLayout(const std::string & path, TextureFileHeader & header)
+{
+	std::ifstream file = openTextureFile(path);
+	return readLayout(file, path, header);
+}
+
+std::vector<unsigned char> mygl::readTextureFileLevel(const std::string & path, const TextureFileLevel & level)
+{
+	std::ifstream file = openTextureFile(path);
+	return readLevel(file, path, level);
+}
+
+bool mygl::isTextureFile(const std::string & path)
+{
+	return path.size() >= TEXTURE_FILE_EXTENSION.size()
+		&& path.compare(path.size() - TEXTURE_FILE_EXTENSION.size(), TEXTURE_FILE_EXTENSION.size(), TEXTURE_FILE_EXTENSION) == 0;
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <mygl/TextureLoader.hpp>
+#include <mygl/TextureManager.hpp>
+#include <mygl/Parallel.hpp>
+
+#include <stb_image.h>
+
+using namespace mygl;
+
+TextureLoader::TextureLoader(unsigned int worker_count, size_t staging_size)
+{
+	if (worker_count == 0) worker_count = std::max(getWorkerCount(), 2u) - 1;
+	this->staging = std::make_unique<StreamBuffer>(std::max<size_t>(staging_size / 3, 4));
+	for (unsigned int w = 0; w < worker_count; w++) this->workers.emplace_back(&TextureLoader::run, this);
+}
+
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+		this->jobs.clear();
+	}
+	this->condition.notify_all();
+	for (std::thread & worker : this->workers) worker.join();
+}
+
+std::shared_ptr<Texture> TextureLoader::load(const std::string & library, const std::string & relative_path, const glm::vec4 & placeholder,
+	TextureContent content)
+{
+	std::shared_ptr<Texture> texture(new Texture(library + relative_path, placeholder));
+	texture->library = library;
+	texture->relativePath = relative_path;
+	texture->content = content;
+	schedule({ texture, library + relative_path, {}, content });
+	return texture;
+}
+
+std::shared_ptr<Texture> TextureLoader::load(std::vector<unsigned char> encoded, const std::string & name, const glm::vec4 & placeholder,
+	TextureContent content)
+{
+	std::shared_ptr<Texture> texture(new Texture(name, placeholder));
+	texture->content = content;
+	schedule({ texture, name, std::move(encoded), content });
+	return texture;
+}
+
+void TextureLoader::schedule(Job job)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->jobs.push_back(std::move(job));
+	}
+	this->condition.notify_one();
+}
+
+size_t TextureLoader::update(double budget_milliseconds)
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+	const size_t region_size = this->staging->getRegionSize();
+	unsigned char * region = nullptr;
+	size_t region_used = 0;
+	size_t uploaded = 0;
+
+	while (uploaded == 0 || std::chrono::duration<double, std::milli>(clock::now() - start).count() < budget_milliseconds) {
+		Image image;
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (this->images.empty()) break;
+			image = this->images.front();
+			this->images.pop_front();
+		}
+
+		std::shared_ptr<Texture> texture = image.texture.lock();
+		const size_t size = image.size;
+		if (texture && image.compressed) {
+			texture->uploadCompressed(*image.compressed);
+			uploaded++;
+		}
+		else if (texture) {
+			if (!region) {
+				region = static_cast<unsigned char *>(this->staging->beginWrite());
+				region_used = 0;
+			}
+			if (region_used + size <= region_size) {
+				// the levels are staged back to back, every level is a multiple of 4 bytes
+				size_t offset = region_used;
+				for (const MipLevel & level : *image.levels) {
+					std::memcpy(region + offset, level.rgba.data(), level.rgba.size());
+					offset += level.rgba.size();
+				}
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, this->staging->getID());
+				upload(*texture, image, this->staging->getCurrentOffset() + region_used);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				region_used += size;
+			}
+			else if (region_used == 0) {
+				// larger than a whole region
+				upload(*texture, image, std::nullopt);
+			}
+			else {
+				// the region of this frame is full
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->images.push_front(image);
+				break;
+			}
+			uploaded++;
+		}
+	}
+
+	if (region) this->staging->fenceCurrentRegion();
+	// registered textures were counted with the size of their placeholder until now
+	if (uploaded > 0) TextureManager::getInstance().trimTextures();
+	return uploaded;
+}
+
+void TextureLoader::upload(Texture & texture, const Image & image, std::optional<size_t> staging_offset)
+{
+	// the storage of the placeholder is replaced by the storage of the image
+	const std::vector<MipLevel> & levels = *image.levels;
+	texture.allocate(GL_RGBA8, levels[0].width, levels[0].height, static_cast<GLsizei>(levels.size()));
+	size_t offset = staging_offset.value_or(0);
+	for (size_t level = 0; level < levels.size(); level++) {
+		const void * pixels = staging_offset ? reinterpret_cast<const void *>(offset) : levels[level].rgba.data();
+		glTextureSubImage2D(texture.getID(), static_cast<GLint>(level), 0, 0, levels[level].width, levels[level].height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		offset += levels[level].rgba.size();
+	}
+	texture.width = levels[0].width;
+	texture.height = levels[0].height;
+	texture.memorySize = image.size;
+	texture.successfullyLoaded = true;
+}
+
+void TextureLoader::finish()
+{
+	while (getPendingCount() > 0) {
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->decoded.wait(lock, [this]() { return !this->images.empty() || (this->jobs.empty() && this->decoding_count == 0); });
+		}
+		update(1000.0);
+	}
+}
+
+size_t TextureLoader::getPendingCount()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->jobs.size() + this->decoding_count + this->images.size();
+}
+
+void TextureLoader::run()
+{
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->condition.wait(lock, [this]() { return this->stopping || !this->jobs.empty(); });
+			if (this->stopping) return;
+			job = std::move(this->jobs.front());
+			this->jobs.pop_front();
+			this->decoding_count++;
+		}
+
+		Image image;
+		image.texture = job.texture;
+		if (!job.texture.expired() && job.encoded.empty() && isTextureFile(job.path)) {
+			try {
+				image.compressed = std::make_shared<CompressedTexture>(readTextureFile(job.path));
+			} catch (const std::runtime_error &) {
+				std::cout << "Failed to load texture \"" << job.path << "\"" << std::endl;
+			}
+		}
+		else if (!job.texture.expired()) {
+			int width = 0, height = 0, channels = 0;
+			unsigned char * pixels = nullptr;
+			if (job.encoded.empty()) {
+				pixels = stbi_load(job.path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+			}
+			else {
+				pixels = stbi_load_from_memory(job.encoded.data(), static_cast<int>(job.encoded.size()), &width, &height, &channels, STBI_rgb_alpha);
+			}
+			if (pixels) {
+				// the mipmaps are computed here rather than by the driver on the render thread
+				image.levels = std::make_shared<std::vector<MipLevel>>(
+					generateMipLevels(pixels, static_cast<uint32_t>(width), static_cast<uint32_t>(height), job.content));
+				for (const MipLevel & level : *image.levels) image.size += level.rgba.size();
+				stbi_image_free(pixels);
+			}
+			else {
+				std::cout << "Failed to load texture \"" << job.path << "\"" << std::endl;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->decoding_count--;
+			if (image.levels || image.compressed) this->images.push_back(image);
+		}
+		this->decoded.notify_all();
+	}
+}
@@ -1,61 +1,373 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <tuple>
 #include <mygl/TextureManager.hpp>
+#include <mygl/Parallel.hpp>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+
+static const uint32_t WATCH_EVENTS = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+// the same image is uploaded with different formats and mipmaps per content, so each content is registered separately
+static std::string getRegistryKey(const std::string & key, mygl::TextureContent content) {
+    switch (content) {
+    case mygl::TextureContent::Color: return key + "#color";
+    case mygl::TextureContent::Normal: return key + "#normal";
+    default: return key + "#linear";
+    }
+}
+
+TextureManager::TextureManager() : next_texture_id(0) {
+#ifdef __linux__
+    this->notify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+TextureManager::~TextureManager() {
+    this->textures.clear();
+#ifdef __linux__
+    if (this->notify_fd >= 0) close(this->notify_fd);
+#endif
+}
 
 void TextureManager::registerSource(fs::path path) {
     if (fs::exists(path)) {
-        this->registered_paths.insert(path);
+        if (!this->registered_paths.insert(path).second) return;
+        this->sources.push_back(path);
+        indexSource(this->sources.size() - 1);
     }
     else {
         std::cout << "The specified path '" << path.generic_string() << "' does not exist." << std::endl;
     }
 }
 
-fs::path TextureManager::findTexturePath(std::string filename) {
-    fs::path file = fs::path(filename);
-    // use cached path if possible to reduce search time
-    auto it = this->cached_paths.find(filename);
-    if (it != this->cached_paths.end()) {
-        return it->second;
+fs::path TextureManager::findTexturePath(std::string name) {
+    return findIndexedPath(name, true);
+}
+
+fs::path TextureManager::findAssetPath(std::string filename) {
+    return findIndexedPath(filename, false);
+}
+
+fs::path TextureManager::findIndexedPath(const std::string & name, bool directory) {
+    pollSourceChanges();
+    auto entries = this->path_index.find(name);
+    if (entries == this->path_index.end()) return fs::path();
+
+    const IndexedPath * best = nullptr;
+    for (const IndexedPath & entry : entries->second) {
+        if (entry.directory != directory) continue;
+        if (!best || std::tie(entry.source, entry.depth, entry.path) < std::tie(best->source, best->depth, best->path)) best = &entry;
+    }
+    return best ? best->path : fs::path();
+}
+
+void TextureManager::refreshSources() {
+    this->path_index.clear();
+#ifdef __linux__
+    for (auto & watched : this->watched_directories) inotify_rm_watch(this->notify_fd, watched.first);
+#endif
+    this->watched_directories.clear();
+
+    // sources that no longer exist are dropped, the others keep their order
+    std::vector<fs::path> remaining;
+    for (const fs::path & path : this->sources) {
+        if (fs::exists(path)) remaining.push_back(path);
+        else this->registered_paths.erase(path);
     }
-    else {
-        // path was not cached
-        // search registered paths
-        fs::path target;
-        for (fs::path path : this->registered_paths)
-        {
-            fs::directory_entry dir(path);
-            if (!dir.exists()) {
-                // remove directories that no longer exist
-                this->registered_paths.erase(path);
+    this->sources = std::move(remaining);
+    for (size_t source = 0; source < this->sources.size(); source++) indexSource(source);
+}
+
+size_t TextureManager::getIndexedCount() {
+    pollSourceChanges();
+    size_t count = 0;
+    for (auto & entries : this->path_index) count += entries.second.size();
+    return count;
+}
+
+void TextureManager::indexSource(size_t source) {
+    const fs::path root = this->sources[source];
+    // a source can be the texture directory itself
+    addIndexEntry(root, source, 0, true);
+    watchDirectory(root, source, 0);
+
+    std::error_code error;
+    std::vector<fs::directory_entry> children;
+    for (fs::directory_iterator it(root, fs::directory_options::skip_permission_denied, error), end; !error && it != end; it.increment(error)) {
+        children.push_back(*it);
+    }
+
+    // every subtree of the source is scanned by its own worker
+    std::vector<std::vector<IndexedPath>> found(children.size());
+    mygl::parallelFor(0, children.size(), [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) {
+            std::error_code child_error;
+            const bool directory = children[c].is_directory(child_error);
+            found[c].push_back({ children[c].path(), source, 1, directory });
+            if (!directory) continue;
+            for (fs::recursive_directory_iterator it(children[c].path(), fs::directory_options::skip_permission_denied, child_error), last;
+                !child_error && it != last; it.increment(child_error)) {
+                found[c].push_back({ it->path(), source, static_cast<unsigned int>(it.depth()) + 2, it->is_directory(child_error) });
+            }
+        }
+    }, 1);
+
+    for (const std::vector<IndexedPath> & entries : found) {
+        for (const IndexedPath & entry : entries) {
+            addIndexEntry(entry.path, entry.source, entry.depth, entry.directory);
+            if (entry.directory) watchDirectory(entry.path, entry.source, entry.depth);
+        }
+    }
+}
+
+void TextureManager::indexDirectory(const fs::path & path, size_t source, unsigned int depth) {
+    addIndexEntry(path, source, depth, true);
+    watchDirectory(path, source, depth);
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(path, fs::directory_options::skip_permission_denied, error), end; !error && it != end; it.increment(error)) {
+        const unsigned int entry_depth = depth + 1 + static_cast<unsigned int>(it.depth());
+        const bool directory = it->is_directory(error);
+        addIndexEntry(it->path(), source, entry_depth, directory);
+        if (directory) watchDirectory(it->path(), source, entry_depth);
+    }
+}
+
+void TextureManager::addIndexEntry(const fs::path & path, size_t source, unsigned int depth, bool directory) {
+    std::vector<IndexedPath> & entries = this->path_index[path.filename().generic_string()];
+    for (const IndexedPath & entry : entries) {
+        if (entry.path == path && entry.source == source) return;
+    }
+    entries.push_back({ path, source, depth, directory });
+}
+
+void TextureManager::removeIndexEntries(const fs::path & path) {
+    // removes the path and, if it is a directory, everything below it
+    const std::string prefix = path.generic_string() + "/";
+    auto isRemoved = [&](const fs::path & candidate) {
+        const std::string name = candidate.generic_string();
+        return candidate == path || name.compare(0, prefix.size(), prefix) == 0;
+    };
+
+    for (auto entries = this->path_index.begin(); entries != this->path_index.end();) {
+        std::vector<IndexedPath> & paths = entries->second;
+        paths.erase(std::remove_if(paths.begin(), paths.end(), [&](const IndexedPath & entry) { return isRemoved(entry.path); }), paths.end());
+        if (paths.empty()) entries = this->path_index.erase(entries);
+        else entries++;
+    }
+    for (auto watched = this->watched_directories.begin(); watched != this->watched_directories.end();) {
+        if (isRemoved(watched->second.path)) {
+#ifdef __linux__
+            inotify_rm_watch(this->notify_fd, watched->first);
+#endif
+            watched = this->watched_directories.erase(watched);
+        }
+        else {
+            watched++;
+        }
+    }
+}
+
+void TextureManager::watchDirectory(const fs::path & path, size_t source, unsigned int depth) {
+#ifdef __linux__
+    if (this->notify_fd < 0) return;
+    const int watch = inotify_add_watch(this->notify_fd, path.c_str(), WATCH_EVENTS);
+    if (watch >= 0) this->watched_directories[watch] = { path, source, depth };
+#endif
+}
+
+void TextureManager::pollSourceChanges() {
+#ifdef __linux__
+    if (this->notify_fd < 0) return;
+    bool rebuild = false;
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    while (true) {
+        const ssize_t length = read(this->notify_fd, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        for (ssize_t offset = 0; offset < length;) {
+            const struct inotify_event * event = reinterpret_cast<const struct inotify_event *>(buffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                rebuild = true;
+                continue;
+            }
+            auto watched = this->watched_directories.find(event->wd);
+            if (watched == this->watched_directories.end()) continue;
+            if (event->mask & IN_IGNORED) {
+                this->watched_directories.erase(watched);
+                continue;
+            }
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                // a moved or deleted source is dropped, subdirectories are handled by the event of their parent
+                if (watched->second.depth == 0) rebuild = true;
                 continue;
             }
-            // registered path may be target
-            if (findPathLocally(dir, filename, &target)) {
-                break;
+            if (event->len == 0) continue;
+
+            const WatchedDirectory directory = watched->second;
+            const fs::path path = directory.path / event->name;
+            if (event->mask & (IN_DELETE | IN_MOVED_FROM)) removeIndexEntries(path);
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                if (event->mask & IN_ISDIR) indexDirectory(path, directory.source, directory.depth + 1);
+                else addIndexEntry(path, directory.source, directory.depth + 1, false);
             }
-            bool is_found = false;
-            for (auto& subdir : fs::directory_iterator(path))
-            {
-                // registered path may contain target
-                if (findPathLocally(subdir, filename, &target)) {
-                    is_found = true;
-                    break;
-                }
+        }
+    }
+    if (rebuild) refreshSources();
+#endif
+}
+
+std::shared_ptr<mygl::Texture> TextureManager::acquireTexture(const fs::path & path, mygl::TextureLoader * loader, const glm::vec4 & placeholder,
+    mygl::TextureContent content) {
+    std::error_code error;
+    fs::path resolved = fs::weakly_canonical(path, error);
+    const std::string key = (error ? path : resolved).generic_string();
+    const std::string registry_key = getRegistryKey(key, content);
+    std::shared_ptr<mygl::Texture> texture = findTexture(registry_key);
+    if (texture) return texture;
+
+    std::string content_key;
+    if (this->content_hashing) {
+        std::ifstream file(key, std::ios::binary);
+        std::vector<unsigned char> encoded((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (!encoded.empty()) {
+            content_key = getRegistryKey(hashContent(encoded.data(), encoded.size()), content);
+            texture = findTexture(content_key);
+            if (texture) {
+                // another path with the same content
+                this->texture_aliases[registry_key] = content_key;
+                return texture;
             }
-            if (is_found) {
-                break;
+            // compressed texture files are not decoded from memory but loaded from their path below
+            if (!mygl::isTextureFile(key)) {
+                if (loader) texture = loader->load(std::move(encoded), key, placeholder, content);
+                else texture = std::shared_ptr<mygl::Texture>(new mygl::Texture(encoded.data(), encoded.size(), key, content));
             }
         }
-        return target;
     }
+    if (!texture) {
+        if (loader) texture = loader->load("", key, placeholder, content);
+        else texture = std::shared_ptr<mygl::Texture>(new mygl::Texture("", key, content));
+    }
+    if (!loader && !texture->isSuccessfullyLoaded()) return texture;
+
+    if (!content_key.empty()) {
+        this->texture_aliases[registry_key] = content_key;
+        return insertTexture(content_key, texture);
+    }
+    return insertTexture(registry_key, texture);
+}
+
+std::shared_ptr<mygl::Texture> TextureManager::acquireTexture(const unsigned char * encoded, size_t size, const std::string & name,
+    mygl::TextureLoader * loader, const glm::vec4 & placeholder, mygl::TextureContent content) {
+    const std::string content_key = getRegistryKey(hashContent(encoded, size), content);
+    std::shared_ptr<mygl::Texture> texture = findTexture(content_key);
+    if (texture) return texture;
+
+    if (loader) texture = loader->load(std::vector<unsigned char>(encoded, encoded + size), name, placeholder, content);
+    else texture = std::shared_ptr<mygl::Texture>(new mygl::Texture(encoded, size, name, content));
+    if (!loader && !texture->isSuccessfullyLoaded()) return texture;
+    return insertTexture(content_key, texture);
 }
 
-bool TextureManager::findPathLocally(fs::directory_entry dir, std::string filename, fs::path * target) {
-    fs::path path = dir.path();
-    if (dir.is_directory() && path.filename().generic_string() == filename) {
-        // registered path is target
-        this->cached_paths.insert(std::pair<std::string, fs::path>(filename, path));
-        *target = path;
-        return true;
+std::shared_ptr<mygl::Texture> TextureManager::findTexture(const std::string & key) {
+    auto alias = this->texture_aliases.find(key);
+    auto entry = this->textures.find(alias != this->texture_aliases.end() ? alias->second : key);
+    if (entry == this->textures.end()) return nullptr;
+    entry->second.last_use = ++this->use_counter;
+    return entry->second.texture;
+}
+
+std::shared_ptr<mygl::Texture> TextureManager::insertTexture(const std::string & key, std::shared_ptr<mygl::Texture> texture) {
+    TextureEntry & entry = this->textures[key];
+    entry.texture = texture;
+    entry.last_use = ++this->use_counter;
+    trimTextures();
+    return texture;
+}
+
+void TextureManager::eraseTexture(std::map<std::string, TextureEntry>::iterator entry) {
+    const std::string & key = entry->first;
+    for (auto alias = this->texture_aliases.begin(); alias != this->texture_aliases.end();) {
+        if (alias->second == key) alias = this->texture_aliases.erase(alias);
+        else alias++;
     }
-    return false;
-}
\ No newline at end of file
+    this->textures.erase(entry);
+}
+
+void TextureManager::setContentHashing(bool enabled) {
+    this->content_hashing = enabled;
+}
+
+void TextureManager::setTextureBudget(size_t bytes) {
+    this->texture_budget = bytes;
+    trimTextures();
+}
+
+size_t TextureManager::getTextureBudget() {
+    return this->texture_budget;
+}
+
+size_t TextureManager::trimTextures() {
+    size_t memory = getTextureMemory();
+    if (memory <= this->texture_budget) return 0;
+
+    // textures that are referenced by nobody but the registry, least recently acquired first
+    std::vector<std::map<std::string, TextureEntry>::iterator> unused;
+    for (auto entry = this->textures.begin(); entry != this->textures.end(); entry++) {
+        if (entry->second.texture.use_count() == 1) unused.push_back(entry);
+    }
+    std::sort(unused.begin(), unused.end(), [](const auto & a, const auto & b) { return a->second.last_use < b->second.last_use; });
+
+    size_t freed = 0;
+    for (auto entry : unused) {
+        if (memory - freed <= this->texture_budget) break;
+        freed += entry->second.texture->getMemorySize();
+        eraseTexture(entry);
+    }
+    return freed;
+}
+
+size_t TextureManager::releaseUnusedTextures() {
+    size_t freed = 0;
+    for (auto entry = this->textures.begin(); entry != this->textures.end();) {
+        auto current = entry++;
+        if (current->second.texture.use_count() > 1) continue;
+        freed += current->second.texture->getMemorySize();
+        eraseTexture(current);
+    }
+    return freed;
+}
+
+void TextureManager::releaseTextures() {
+    this->textures.clear();
+    this->texture_aliases.clear();
+}
+
+size_t TextureManager::getTextureMemory() {
+    size_t memory = 0;
+    for (auto & entry : this->textures) memory += entry.second.texture->getMemorySize();
+    return memory;
+}
+
+size_t TextureManager::getTextureCount() {
+    return this->textures.size();
+}
+
+std::string TextureManager::hashContent(const unsigned char * encoded, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= encoded[i];
+        hash *= 1099511628211ull;
+    }
+    char key[48];
+    std::snprintf(key, sizeof(key), "#%zx-%016llx", size, static_cast<unsigned long long>(hash));
+    return key;
+}
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <mygl/TextureStreamer.hpp>
+#include <mygl/Material.hpp>
+
+using namespace mygl;
+
+TextureStreamer::TextureStreamer(size_t budget, uint32_t tail_size)
+{
+	this->budget = budget;
+	this->tail_size = std::max(tail_size, 1u);
+	this->reader = std::thread(&TextureStreamer::run, this);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+		this->reads.clear();
+	}
+	this->condition.notify_all();
+	this->reader.join();
+}
+
+std::shared_ptr<Texture> TextureStreamer::load(const std::string & path)
+{
+	auto existing = this->textures.find(path);
+	if (existing != this->textures.end()) {
+		std::shared_ptr<Texture> texture = existing->second.texture.lock();
+		if (texture) return texture;
+		eraseTexture(existing);
+	}
+	if (!isTextureFile(path)) return std::shared_ptr<Texture>(new Texture("", path));
+
+	StreamedTexture entry;
+	entry.path = path;
+	std::vector<std::vector<unsigned char>> tail;
+	try {
+		TextureFileHeader header;
+		entry.levels = readTextureFileLayout(path, header);
+		if (entry.levels.empty()) throw std::runtime_error("texture file without levels " + path);
+		entry.internal_format = getCompressedInternalFormat(static_cast<TextureBlockFormat>(header.format), (header.flags & TextureFileHeader::FLAG_SRGB) != 0);
+
+		entry.tail_level = static_cast<uint32_t>(entry.levels.size()) - 1;
+		for (uint32_t l = 0; l < entry.levels.size(); l++) {
+			if (std::max(entry.levels[l].width, entry.levels[l].height) <= this->tail_size) {
+				entry.tail_level = l;
+				break;
+			}
+		}
+		for (uint32_t l = entry.tail_level; l < entry.levels.size(); l++) tail.push_back(readTextureFileLevel(path, entry.levels[l]));
+	} catch (const std::runtime_error &) {
+		std::cout << "Failed to load texture \"" << path << "\"" << std::endl;
+		return std::shared_ptr<Texture>(new Texture(path, glm::vec4(1.f)));
+	}
+
+	// the storage starts with the tail, its level 0 is the tail level of the file
+	std::shared_ptr<Texture> texture(new Texture(path, glm::vec4(1.f)));
+	const TextureFileLevel & top = entry.levels[entry.tail_level];
+	texture->allocate(entry.internal_format, top.width, top.height, static_cast<GLsizei>(entry.levels.size() - entry.tail_level));
+	texture->memorySize = 0;
+	for (uint32_t l = entry.tail_level; l < entry.levels.size(); l++) {
+		const std::vector<unsigned char> & blocks = tail[l - entry.tail_level];
+		glCompressedTextureSubImage2D(texture->getID(), static_cast<GLint>(l - entry.tail_level), 0, 0, entry.levels[l].width, entry.levels[l].height,
+			entry.internal_format, static_cast<GLsizei>(blocks.size()), blocks.data());
+		texture->memorySize += blocks.size();
+	}
+	texture->width = static_cast<int>(entry.levels[0].width);
+	texture->height = static_cast<int>(entry.levels[0].height);
+	texture->successfullyLoaded = true;
+
+	entry.texture = texture;
+	entry.address = texture.get();
+	entry.resident_level = entry.tail_level;
+	entry.target_level = entry.tail_level;
+	this->resident_memory += texture->memorySize;
+	this->textures[path] = std::move(entry);
+	this->texture_paths[texture.get()] = path;
+	return texture;
+}
+
+void TextureStreamer::requestLevel(const Texture & texture, float level)
+{
+	auto path = this->texture_paths.find(&texture);
+	if (path == this->texture_paths.end()) return;
+	StreamedTexture & entry = this->textures[path->second];
+	entry.demand = std::min(entry.demand, level);
+}
+
+void TextureStreamer::requestMaterial(const Material & material, float screen_size)
+{
+	const std::optional<std::shared_ptr<Texture>> * textures[] = {
+		&material.albedo.texture, &material.normal.texture, &material.roughness.texture, &material.metallic.texture,
+		&material.ao.texture, &material.height.texture, &material.opacity.texture
+	};
+	for (const std::optional<std::shared_ptr<Texture>> * texture : textures) {
+		if (!texture->has_value() || !texture->value()) continue;
+		auto path = this->texture_paths.find(texture->value().get());
+		if (path == this->texture_paths.end()) continue;
+
+		StreamedTexture & entry = this->textures[path->second];
+		const float extent = static_cast<float>(std::max(entry.levels[0].width, entry.levels[0].height));
+		entry.demand = std::min(entry.demand, std::log2(extent / std::max(screen_size, 1.f)));
+	}
+}
+
+size_t TextureStreamer::update(size_t upload_budget)
+{
+	for (auto entry = this->textures.begin(); entry != this->textures.end();) {
+		if (entry->second.texture.expired()) entry = eraseTexture(entry);
+		else entry++;
+	}
+
+	chooseTargetLevels();
+
+	for (auto & pair : this->textures) {
+		StreamedTexture & entry = pair.second;
+		std::shared_ptr<Texture> texture = entry.texture.lock();
+		if (entry.target_level > entry.resident_level) {
+			dropLevels(entry, *texture, entry.target_level);
+		}
+		else if (entry.target_level < entry.resident_level && !entry.reading) {
+			// one level at a time, so that the texture sharpens from coarse to fine
+			const uint32_t level = entry.resident_level - 1;
+			{
+				std::lock_guard<std::mutex> lock(this->mutex);
+				this->reads.push_back({ entry.path, level, entry.levels[level], {} });
+			}
+			entry.reading = true;
+			this->condition.notify_one();
+		}
+	}
+
+	size_t uploaded = 0;
+	size_t uploaded_bytes = 0;
+	while (uploaded == 0 || uploaded_bytes < upload_budget) {
+		Read read;
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (this->completed.empty()) break;
+			read = std::move(this->completed.front());
+			this->completed.pop_front();
+		}
+
+		auto found = this->textures.find(read.path);
+		if (found == this->textures.end()) continue;
+		StreamedTexture & entry = found->second;
+		entry.reading = false;
+		std::shared_ptr<Texture> texture = entry.texture.lock();
+		if (!texture) continue;
+
+		if (read.blocks.empty()) {
+			// the file became unreadable, keep the levels that are resident
+			entry.finest_level = read.level + 1;
+		}
+		else if (read.level + 1 == entry.resident_level && entry.target_level <= read.level) {
+			uploadLevel(entry, *texture, read.level, read.blocks);
+			uploaded_bytes += read.blocks.size();
+			uploaded++;
+		}
+	}
+	return uploaded;
+}
+
+void TextureStreamer::chooseTargetLevels()
+{
+	// the unrequested textures keep their levels, but are the first to give them up
+	typedef std::tuple<bool, uint64_t, StreamedTexture *> candidate_t;
+	std::priority_queue<candidate_t> candidates;
+	size_t total = 0;
+	for (auto & pair : this->textures) {
+		StreamedTexture & entry = pair.second;
+		const bool requested = std::isfinite(entry.demand);
+		uint32_t level = entry.resident_level;
+		if (requested) {
+			const float demand = std::floor(std::max(entry.demand + this->level_bias, 0.f));
+			level = static_cast<uint32_t>(std::min(demand, static_cast<float>(entry.tail_level)));
+		}
+		entry.target_level = std::clamp(level, std::min(entry.finest_level, entry.tail_level), entry.tail_level);
+		entry.demand = INFINITY;
+
+		total += getLevelBytes(entry, entry.target_level);
+		if (entry.target_level < entry.tail_level) candidates.push({ !requested, entry.levels[entry.target_level].size, &entry });
+	}
+
+	// drop the largest level over and over again until the targets fit into the budget
+	while (total > this->budget && !candidates.empty()) {
+		candidate_t candidate = candidates.top();
+		candidates.pop();
+		StreamedTexture & entry = *std::get<2>(candidate);
+		total -= entry.levels[entry.target_level].size;
+		entry.target_level++;
+		if (entry.target_level < entry.tail_level) candidates.push({ std::get<0>(candidate), entry.levels[entry.target_level].size, &entry });
+	}
+}
+
+void TextureStreamer::dropLevels(StreamedTexture & entry, Texture & texture, uint32_t level)
+{
+	const size_t freed = getLevelBytes(entry, entry.resident_level) - getLevelBytes(entry, level);
+	reallocate(entry, texture, level);
+	entry.resident_level = level;
+	texture.memorySize -= freed;
+	this->resident_memory -= freed;
+}
+
+void TextureStreamer::uploadLevel(StreamedTexture & entry, Texture & texture, uint32_t level, const std::vector<unsigned char> & blocks)
+{
+	const TextureFileLevel & layout = entry.levels[level];
+	reallocate(entry, texture, level);
+	glCompressedTextureSubImage2D(texture.getID(), 0, 0, 0, layout.width, layout.height, entry.internal_format,
+		static_cast<GLsizei>(blocks.size()), blocks.data());
+	entry.resident_level = level;
+	texture.memorySize += blocks.size();
+	this->resident_memory += blocks.size();
+}
+
+void TextureStreamer::reallocate(StreamedTexture & entry, Texture & texture, uint32_t level)
+{
+	// immutable storage cannot gain or lose levels, so the levels that stay resident are copied into a new texture object
+	GLuint previous = texture.ID;
+	glCreateTextures(GL_TEXTURE_2D, 1, &texture.ID);
+	glTextureStorage2D(texture.ID, static_cast<GLsizei>(entry.levels.size() - level), entry.internal_format, entry.levels[level].width, entry.levels[level].height);
+	for (uint32_t l = std::max(level, entry.resident_level); l < entry.levels.size(); l++) {
+		glCopyImageSubData(previous, GL_TEXTURE_2D, static_cast<GLint>(l - entry.resident_level), 0, 0, 0,
+			texture.ID, GL_TEXTURE_2D, static_cast<GLint>(l - level), 0, 0, 0, entry.levels[l].width, entry.levels[l].height, 1);
+	}
+	glDeleteTextures(1, &previous);
+}
+
+std::map<std::string, TextureStreamer::StreamedTexture>::iterator TextureStreamer::eraseTexture(std::map<std::string, StreamedTexture>::iterator entry)
+{
+	// the texture object was deleted together with all its levels, and a new texture may already reuse its address
+	this->resident_memory -= getLevelBytes(entry->second, entry->second.resident_level);
+	auto path = this->texture_paths.find(entry->second.address);
+	if (path != this->texture_paths.end() && path->second == entry->first) this->texture_paths.erase(path);
+	return this->textures.erase(entry);
+}
+
+size_t TextureStreamer::getLevelBytes(const StreamedTexture & entry, uint32_t first_level)
+{
+	size_t bytes = 0;
+	for (size_t l = first_level; l < entry.levels.size(); l++) bytes += entry.levels[l].size;
+	return bytes;
+}
+
+void TextureStreamer::setBudget(size_t bytes)
+{
+	this->budget = bytes;
+}
+
+size_t TextureStreamer::getBudget()
+{
+	return this->budget;
+}
+
+void TextureStreamer::setLevelBias(float bias)
+{
+	this->level_bias = bias;
+}
+
+size_t TextureStreamer::getResidentMemory()
+{
+	return this->resident_memory;
+}
+
+size_t TextureStreamer::getStreamedCount()
+{
+	return this->textures.size();
+}
+
+size_t TextureStreamer::getPendingCount()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->reads.size() + this->reading_count + this->completed.size();
+}
+
+void TextureStreamer::run()
+{
+	while (true) {
+		Read read;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->condition.wait(lock, [this]() { return this->stopping || !this->reads.empty(); });
+			if (this->stopping) return;
+			read = std::move(this->reads.front());
+			this->reads.pop_front();
+			this->reading_count++;
+		}
+
+		try {
+			read.blocks = readTextureFileLevel(read.path, read.layout);
+		} catch (const std::runtime_error &) {
+			read.blocks.clear();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->reading_count--;
+			this->completed.push_back(std::move(read));
+		}
+	}
+}
@@ -1,8 +1,9 @@
 #include <mygl/VectorMath.hpp>
+#include <mygl/Parallel.hpp>
 
 using namespace mygl;
 
-glm::vec3 mygl::calculateTangent(VertexFormat p1, VertexFormat p2, VertexFormat p3) {
+glm::vec3 mygl::calculateTangent(const VertexFormat & p1, const VertexFormat & p2, const VertexFormat & p3) {
 	glm::vec3 edge1 = p2.position - p1.position;
 	glm::vec3 edge2 = p3.position - p1.position;
 	glm::vec2 deltaUV1 = p2.uv - p1.uv;
@@ -24,15 +25,17 @@ void mygl::calculateAndSetTangents(std::vector<VertexFormat> * vertices, GLenum
 }
 
 void mygl::calculateAndSetTangents_GL_TRIANGLES(std::vector<VertexFormat> * vertices) {
-	for (unsigned int i = 0; i < vertices->size(); i += 3) {
-		glm::vec3 tangent = calculateTangent(vertices->at(i),
-			vertices->at(static_cast<unsigned long long>(i) + 1),
-			vertices->at(static_cast<unsigned long long>(i) + 2));
-
-		vertices->at(static_cast<unsigned long long>(i)).tangent = tangent;
-		vertices->at(static_cast<unsigned long long>(i) + 1).tangent = tangent;
-		vertices->at(static_cast<unsigned long long>(i) + 2).tangent = tangent;
-	}
+	const size_t triangle_count = vertices->size() / 3;
+	VertexFormat * data = vertices->data();
+	parallelFor(0, triangle_count, [data](size_t begin, size_t end) {
+		for (size_t t = begin; t < end; t++) {
+			VertexFormat * triangle = data + t * 3;
+			glm::vec3 tangent = calculateTangent(triangle[0], triangle[1], triangle[2]);
+			triangle[0].tangent = tangent;
+			triangle[1].tangent = tangent;
+			triangle[2].tangent = tangent;
+		}
+	});
 }
 
 glm::vec3 mygl::dehomogenizeVec4(glm::vec4 homogeneous_input) {
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <mygl/VertexFormat.hpp>
 
 using namespace mygl;
@@ -16,12 +17,45 @@ VertexFormat::~VertexFormat()
 
 void VertexFormat::registerFormat()
 {
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)(6 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)(8 * sizeof(GLfloat)));
-}
\ No newline at end of file
+	for (const VertexAttribute & attribute : getLayout()) {
+		glEnableVertexAttribArray(attribute.location);
+		glVertexAttribPointer(attribute.location, attribute.component_count, attribute.component_type, attribute.normalized,
+			sizeof(VertexFormat), (void*)(static_cast<size_t>(attribute.offset)));
+	}
+}
+
+std::vector<VertexAttribute> VertexFormat::getLayout()
+{
+	return {
+		{ 0, 3, GL_FLOAT, GL_FALSE, 0 },
+		{ 1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat) },
+		{ 2, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat) },
+		{ 3, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat) }
+	};
+}
+
+bool VertexFormat::isNearlyEqual(const VertexFormat &a, const VertexFormat &b, float position_tolerance, float attribute_tolerance)
+{
+	auto isClose = [](const auto &u, const auto &v, float tolerance) {
+		for (int i = 0; i < u.length(); i++) {
+			if (std::abs(u[i] - v[i]) > tolerance) return false;
+		}
+		return true;
+	};
+	return isClose(a.position, b.position, position_tolerance)
+		&& isClose(a.normal, b.normal, attribute_tolerance)
+		&& isClose(a.uv, b.uv, attribute_tolerance)
+		&& isClose(a.tangent, b.tangent, attribute_tolerance);
+}
+
+VertexFormat VertexFormat::transform(const VertexFormat &vertex, const glm::mat4 &model, const glm::mat3 &model_normal)
+{
+	auto normalizeOrZero = [](const glm::vec3 &v) {
+		float length = glm::length(v);
+		return length > 0.f ? v / length : v;
+	};
+	return VertexFormat(glm::vec3(model * glm::vec4(vertex.position, 1.f)),
+		normalizeOrZero(model_normal * vertex.normal),
+		vertex.uv,
+		normalizeOrZero(glm::mat3(model) * vertex.tangent));
+}